@@ -0,0 +1,55 @@
+/*
+ * Shared helpers of the notasimdlib.h benchmarks.
+ *
+ * Every benchmark prints one line per measurement, best of several runs,
+ * so the numbers can be compared across XLEN and compiler flags.
+ */
+#ifndef NOTASIMDLIB_BENCH_H
+#define NOTASIMDLIB_BENCH_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+
+/** @brief Monotonic wall clock in seconds. */
+static inline double bench_now(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (double)t.tv_sec + (double)t.tv_nsec * 1e-9;
+}
+
+/**
+ * @brief Best wall time in seconds of reps executions of the statement(s)
+ *        given as the remaining arguments.
+ *
+ * A compiler barrier after each run keeps calls to pure functions from
+ * being hoisted out of the repetition loop.
+ *
+ * Example:
+ *   double t = BENCH_BEST(5, simd_array_add(float, y, a, b, n));
+ */
+#define BENCH_BEST(reps, ...) \
+({ \
+    double _bb_best = 1e30; \
+    for (int _bb_r = 0; _bb_r < (reps); _bb_r++) { \
+        double _bb_t = bench_now(); \
+        __VA_ARGS__; \
+        __asm__ __volatile__("" ::: "memory"); \
+        _bb_t = bench_now() - _bb_t; \
+        _bb_best = _bb_t < _bb_best ? _bb_t : _bb_best; \
+    } \
+    _bb_best; \
+})
+
+/** @brief Sink for results, so measured work is not optimized away. */
+static volatile double bench_sink;
+
+/** @brief Deterministic 64-bit generator (splitmix64) for test data. */
+static inline uint64_t bench_rand(uint64_t *s) {
+    uint64_t z = (*s += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+#endif
@@ -0,0 +1,52 @@
+/*
+ * Calling forms of decl_simd_bin_op (user-065): an accumulation
+ * acc = acc + x[i] over an L1-resident array of vectors through the
+ * by-value function, the vector-scalar form, the in-place form and the
+ * pointer form, each kept out of line (SIMD_FUNC noinline) so the call
+ * goes through the ABI. At XLEN 256 and 512 the SysV ABI passes and
+ * returns simd_t(float) in memory: the by-value forms copy every operand
+ * and the result through the stack, while the in-place and pointer forms
+ * load and store the operands once. At XLEN 128 the struct travels in
+ * two SSE registers split into 8-byte halves, which costs shuffles
+ * instead. Run with XLEN=512 for the 512-bit case. ns per call and bytes
+ * of simd_t the ABI passes through the stack per call.
+ */
+#define SIMD_FUNC __attribute__((noinline))
+#include "notasimdlib.h"
+#include "bench.h"
+
+decl_simd_t(float)
+decl_simd_bin_op(add, float, +)
+
+#define N 512
+#define REPS 20000
+
+static simd_t(float) x[N];
+
+int main(void) {
+    uint64_t seed = 65;
+    for (size_t i = 0; i < N; i++)
+        for (size_t k = 0; k < VLEN(float); k++)
+            x[i].v[k] = (float)(bench_rand(&seed) >> 40) * 0x1p-24f;
+    const size_t bytes = sizeof(simd_t(float));
+    /* Two operands in and the result out go through memory past 16 bytes. */
+    const size_t by_value = bytes > 16 ? 3 * bytes : 0;
+    simd_t(float) acc = simd_splat(float, 0);
+
+    printf("XLEN %d, simd_t(float) of %zu bytes (ns per call, stack bytes per call)\n",
+           XLEN, bytes);
+    double t = BENCH_BEST(REPS, for (size_t i = 0; i < N; i++)
+        acc = simd_bin_op(add, float, acc, x[i]));
+    printf("  %-26s %6.2f %6zu\n", "by value, a op b", t / N * 1e9, by_value);
+    t = BENCH_BEST(REPS, for (size_t i = 0; i < N; i++)
+        acc = simd_bin_op_vs(add, float, acc, 0.5f));
+    printf("  %-26s %6.2f %6zu\n", "by value, a op s", t / N * 1e9, bytes > 16 ? 2 * bytes : 0);
+    t = BENCH_BEST(REPS, for (size_t i = 0; i < N; i++)
+        simd_bin_op_inplace(add, float, &acc, &x[i]));
+    printf("  %-26s %6.2f %6d\n", "in place, *a = *a op *b", t / N * 1e9, 0);
+    t = BENCH_BEST(REPS, for (size_t i = 0; i < N; i++)
+        simd_bin_op_p(add, float, &acc, &acc, &x[i]));
+    printf("  %-26s %6.2f %6d\n", "pointer, *o = *a op *b", t / N * 1e9, 0);
+    bench_sink += acc.v[0];
+    return 0;
+}
@@ -0,0 +1,88 @@
+/*
+ * Bitmap kernels (user-054) against scalar __builtin_popcountll / ctz
+ * loops: popcount_array at L1, L2 and DRAM sizes, bitmap_and, and
+ * bitmap_to_indices at several densities. Throughput in GB/s of input.
+ *
+ * Built with -march=native the Harley-Seal path gives way to vpopcntq on
+ * CPUs with AVX512-VPOPCNTDQ; compare with CFLAGS="-O2 -mavx2".
+ */
+#include "notasimdlib.h"
+#include "bench.h"
+#include <stdlib.h>
+
+decl_simd_t(uint64_t)
+decl_simd_bitmap_ops(uint64_t)
+
+#define MAX_WORDS (1u << 23)
+
+static uint64_t scalar_popcount(const uint64_t *a, size_t n) {
+    uint64_t total = 0;
+    for (size_t i = 0; i < n; i++)
+        total += (uint64_t)__builtin_popcountll(a[i]);
+    return total;
+}
+
+static size_t scalar_to_indices(const uint64_t *a, size_t n, uint32_t *out) {
+    size_t count = 0;
+    for (size_t w = 0; w < n; w++) {
+        uint64_t word = a[w];
+        while (word) {
+            out[count++] = (uint32_t)(w * 64 + (size_t)__builtin_ctzll(word));
+            word &= word - 1;
+        }
+    }
+    return count;
+}
+
+int main(void) {
+    uint64_t *a = malloc(MAX_WORDS * sizeof(uint64_t));
+    uint64_t *b = malloc(MAX_WORDS * sizeof(uint64_t));
+    uint64_t *c = malloc(MAX_WORDS * sizeof(uint64_t));
+    uint32_t *idx = malloc((size_t)MAX_WORDS * 64 / 4 * sizeof(uint32_t) + 64);
+    uint64_t seed = 54;
+    for (size_t i = 0; i < MAX_WORDS; i++) {
+        a[i] = bench_rand(&seed);
+        b[i] = bench_rand(&seed);
+    }
+
+    printf("popcount over n uint64_t words (GB/s)\n");
+    printf("     words     simd   scalar  check\n");
+    const size_t sizes[] = { 512, 32768, MAX_WORDS };
+    for (size_t s = 0; s < 3; s++) {
+        size_t n = sizes[s];
+        int reps = (int)(MAX_WORDS / n) < 2000 ? (int)(MAX_WORDS / n) + 3 : 2000;
+        uint64_t r1 = 0, r2 = 0;
+        double t1 = BENCH_BEST(reps, r1 = simd_popcount_array(uint64_t, a, n); bench_sink += r1);
+        double t2 = BENCH_BEST(reps, r2 = scalar_popcount(a, n); bench_sink += r2);
+        printf("%10zu %8.2f %8.2f  %s\n", n, n * 8 / t1 * 1e-9, n * 8 / t2 * 1e-9,
+               r1 == r2 ? "ok" : "MISMATCH");
+    }
+
+    size_t n = MAX_WORDS;
+    double ta = BENCH_BEST(5, simd_bitmap_and(uint64_t, c, a, b, n); bench_sink += c[n / 2]);
+    double tp = BENCH_BEST(5, simd_bitmap_and(uint64_t, c, a, b, n);
+                              bench_sink += simd_popcount_array(uint64_t, c, n));
+    printf("bitmap_and %u words: %.2f GB/s of inputs, and + popcount %.2f GB/s\n",
+           MAX_WORDS, 2.0 * n * 8 / ta * 1e-9, 2.0 * n * 8 / tp * 1e-9);
+
+    printf("bitmap_to_indices over %u words (GB/s of bitmap)\n", MAX_WORDS / 8);
+    printf("   density     simd   scalar  check\n");
+    n = MAX_WORDS / 8;
+    const unsigned shifts[] = { 8, 4, 2, 1, 0 };   /* a bit is set with probability 2^-shift */
+    for (size_t d = 0; d < 5; d++) {
+        for (size_t i = 0; i < n; i++) {
+            uint64_t w = ~(uint64_t)0;
+            for (unsigned k = 0; k < shifts[d]; k++)
+                w &= bench_rand(&seed);
+            a[i] = w;
+        }
+        size_t k1 = 0, k2 = 0;
+        double t1 = BENCH_BEST(5, k1 = simd_bitmap_to_indices(uint64_t, a, n, idx); bench_sink += k1);
+        double t2 = BENCH_BEST(5, k2 = scalar_to_indices(a, n, idx); bench_sink += k2);
+        printf("   1/%-5u %8.2f %8.2f  %s\n", 1u << shifts[d], n * 8 / t1 * 1e-9,
+               n * 8 / t2 * 1e-9, k1 == k2 ? "ok" : "MISMATCH");
+    }
+
+    free(a); free(b); free(c); free(idx);
+    return 0;
+}
@@ -0,0 +1,82 @@
+/*
+ * Chained calls of generated functions (user-066): y = ((a * b + c) * d) - e
+ * per int32_t vector (exact, so every build must agree) over L1-resident
+ * arrays, as four calls of decl_simd_bin_op functions in three builds of
+ * the same operations:
+ *
+ *   by value   out of line, simd_t(T) arguments and result by value
+ *   pointer    out of line, the _p forms (*out = *a op *b)
+ *   inline     SIMD_FUNC as SIMD_INLINE defines it (static inline,
+ *              always_inline), which keeps the chain in registers
+ *
+ * The out-of-line builds are noinline so the call survives -O2 as it would
+ * across translation units. SIMD_FUNC is read when a generator expands, so
+ * one file holds all three. G vectors per second.
+ */
+#define SIMD_FUNC __attribute__((noinline))
+#include "notasimdlib.h"
+#include "bench.h"
+
+decl_simd_t(int32_t)
+decl_simd_bin_op(mul, int32_t, *)
+decl_simd_bin_op(add, int32_t, +)
+decl_simd_bin_op(sub, int32_t, -)
+
+#undef SIMD_FUNC
+#define SIMD_FUNC static inline __attribute__((always_inline))
+decl_simd_bin_op(imul, int32_t, *)
+decl_simd_bin_op(iadd, int32_t, +)
+decl_simd_bin_op(isub, int32_t, -)
+
+#define N 256
+#define REPS 20000
+
+static simd_t(int32_t) a[N], b[N], c[N], d[N], e[N], y[N];
+
+static void by_value(void) {
+    for (size_t i = 0; i < N; i++) {
+        simd_t(int32_t) t = simd_bin_op(mul, int32_t, a[i], b[i]);
+        t = simd_bin_op(add, int32_t, t, c[i]);
+        t = simd_bin_op(mul, int32_t, t, d[i]);
+        y[i] = simd_bin_op(sub, int32_t, t, e[i]);
+    }
+}
+
+static void pointer(void) {
+    for (size_t i = 0; i < N; i++) {
+        simd_t(int32_t) t;
+        simd_bin_op_p(mul, int32_t, &t, &a[i], &b[i]);
+        simd_bin_op_p(add, int32_t, &t, &t, &c[i]);
+        simd_bin_op_p(mul, int32_t, &t, &t, &d[i]);
+        simd_bin_op_p(sub, int32_t, &y[i], &t, &e[i]);
+    }
+}
+
+static void inlined(void) {
+    for (size_t i = 0; i < N; i++) {
+        simd_t(int32_t) t = simd_bin_op(imul, int32_t, a[i], b[i]);
+        t = simd_bin_op(iadd, int32_t, t, c[i]);
+        t = simd_bin_op(imul, int32_t, t, d[i]);
+        y[i] = simd_bin_op(isub, int32_t, t, e[i]);
+    }
+}
+
+int main(void) {
+    uint64_t seed = 66;
+    simd_t(int32_t) *arrays[] = { a, b, c, d, e };
+    for (size_t j = 0; j < 5; j++)
+        for (size_t i = 0; i < N; i++)
+            for (size_t k = 0; k < VLEN(int32_t); k++)
+                arrays[j][i].v[k] = (int32_t)(bench_rand(&seed) >> 56);
+
+    printf("XLEN %d: y = (a*b + c)*d - e, four calls per vector (G vectors/s)\n", XLEN);
+    double t1 = BENCH_BEST(REPS, by_value());
+    int32_t want = y[N / 2].v[0];
+    double t2 = BENCH_BEST(REPS, pointer());
+    int ok = y[N / 2].v[0] == want;
+    double t3 = BENCH_BEST(REPS, inlined());
+    ok &= y[N / 2].v[0] == want;
+    printf("  by value %8.3f\n  pointer  %8.3f\n  inline   %8.3f\n  %s\n",
+           N / t1 * 1e-9, N / t2 * 1e-9, N / t3 * 1e-9, ok ? "ok" : "MISMATCH");
+    return 0;
+}
@@ -0,0 +1,98 @@
+/*
+ * Decode throughput of the integer codecs (user-052) on uint32_t columns,
+ * in billions of integers per second, against a scalar LEB128 varint
+ * decoder of the same data.
+ */
+#include "notasimdlib.h"
+#include "bench.h"
+#include <stdlib.h>
+
+decl_simd_t(uint32_t)
+decl_simd_codec_ops(uint32_t)
+
+#define N (1u << 20)
+#define REPS 20
+
+static size_t varint_encode(const uint32_t *in, size_t n, uint8_t *out) {
+    uint8_t *p = out;
+    for (size_t i = 0; i < n; i++) {
+        uint32_t v = in[i];
+        while (v >= 0x80) {
+            *p++ = (uint8_t)(v | 0x80);
+            v >>= 7;
+        }
+        *p++ = (uint8_t)v;
+    }
+    return (size_t)(p - out);
+}
+
+static void varint_decode(const uint8_t *in, size_t n, uint32_t *out) {
+    for (size_t i = 0; i < n; i++) {
+        uint32_t v = 0;
+        unsigned shift = 0;
+        uint8_t b;
+        do {
+            b = *in++;
+            v |= (uint32_t)(b & 0x7f) << shift;
+            shift += 7;
+        } while (b & 0x80);
+        out[i] = v;
+    }
+}
+
+int main(void) {
+    uint32_t *in = malloc(N * sizeof(uint32_t));
+    uint32_t *tmp = malloc(N * sizeof(uint32_t));
+    uint32_t *out = malloc(N * sizeof(uint32_t));
+    uint32_t *packed = malloc((N + simd_bitpack_block_len(uint32_t)) * sizeof(uint32_t));
+    uint8_t *bytes = malloc(N * 5);
+    uint64_t seed = 52;
+    const unsigned widths[] = { 1, 4, 8, 12, 16, 20, 24, 32 };
+
+    printf("decode of %u uint32_t values (G ints/s)\n", N);
+    printf(" bits  bitunpack     varint\n");
+    for (size_t w = 0; w < sizeof(widths) / sizeof(widths[0]); w++) {
+        unsigned bits = widths[w];
+        for (size_t i = 0; i < N; i++)
+            in[i] = (uint32_t)bench_rand(&seed) >> (32 - bits);
+        simd_bitpack(uint32_t, in, N, bits, packed);
+        varint_encode(in, N, bytes);
+        double tu = BENCH_BEST(REPS, simd_bitunpack(uint32_t, packed, N, bits, out));
+        bench_sink += out[N / 2];
+        double tv = BENCH_BEST(REPS, varint_decode(bytes, N, out));
+        bench_sink += out[N / 2];
+        printf(" %4u %10.2f %10.2f\n", bits, N / tu * 1e-9, N / tv * 1e-9);
+    }
+
+    /* Sorted timestamps: gaps below 2^10. */
+    in[0] = 1700000000u;
+    for (size_t i = 1; i < N; i++)
+        in[i] = in[i - 1] + (uint32_t)(bench_rand(&seed) & 1023);
+    uint32_t base = in[0];
+    simd_delta_encode(uint32_t, in, N, base, tmp);
+    unsigned bits = simd_max_bits(uint32_t, tmp, N);
+    simd_bitpack(uint32_t, tmp, N, bits, packed);
+    varint_encode(tmp, N, bytes);
+    double td = BENCH_BEST(REPS, simd_delta_decode(uint32_t, tmp, N, base, out));
+    double tp = BENCH_BEST(REPS, simd_bitunpack(uint32_t, packed, N, bits, tmp);
+                                 simd_delta_decode(uint32_t, tmp, N, base, out));
+    double tv = BENCH_BEST(REPS, varint_decode(bytes, N, tmp);
+                                 uint32_t acc = base;
+                                 for (size_t i = 0; i < N; i++) out[i] = acc += tmp[i]);
+    bench_sink += out[N - 1];
+    uint32_t ref = simd_for_encode(uint32_t, in, N, tmp);
+    double tf = BENCH_BEST(REPS, simd_for_decode(uint32_t, tmp, N, ref, out));
+    simd_delta2_encode(uint32_t, in, N, tmp);
+    double t2 = BENCH_BEST(REPS, simd_delta2_decode(uint32_t, tmp, N, out));
+    bench_sink += out[N - 1];
+
+    printf("sorted column (%u-bit deltas, G ints/s)\n", bits);
+    printf("  delta_decode          %6.2f\n", N / td * 1e-9);
+    printf("  bitunpack+delta       %6.2f\n", N / tp * 1e-9);
+    printf("  varint+prefix sum     %6.2f\n", N / tv * 1e-9);
+    printf("  for_decode            %6.2f\n", N / tf * 1e-9);
+    printf("  delta2_decode         %6.2f\n", N / t2 * 1e-9);
+
+    free(in); free(tmp); free(out); free(packed); free(bytes);
+    return 0;
+}
@@ -0,0 +1,162 @@
+/*
+ * Distance kernels (user-055): one query against a base of vectors with
+ * the batched kernels, against the same scan written as plain scalar
+ * loops, in million distances per second; then top-k selection over
+ * the resulting distances against a full heap scan.
+ */
+#include "notasimdlib.h"
+#include "bench.h"
+#include <stdlib.h>
+
+decl_simd_t(float)
+decl_simd_distance_ops(float, float)
+decl_simd_topk(float)
+decl_simd_t(int8_t)
+decl_simd_distance_ops(int8_t, int32_t)
+decl_simd_t(uint64_t)
+decl_simd_hamming_ops(uint64_t)
+
+#define BASE_BYTES (64u << 20)
+#define REPS 5
+
+static void scalar_l2sq_batch_f(const float *q, const float *base, size_t count, size_t dim,
+                                float *out) {
+    for (size_t r = 0; r < count; r++) {
+        const float *b = base + r * dim;
+        float acc = 0;
+        for (size_t i = 0; i < dim; i++)
+            acc += (q[i] - b[i]) * (q[i] - b[i]);
+        out[r] = acc;
+    }
+}
+
+static void scalar_ip_batch_f(const float *q, const float *base, size_t count, size_t dim,
+                              float *out) {
+    for (size_t r = 0; r < count; r++) {
+        const float *b = base + r * dim;
+        float acc = 0;
+        for (size_t i = 0; i < dim; i++)
+            acc += q[i] * b[i];
+        out[r] = acc;
+    }
+}
+
+static void scalar_l2sq_batch_i8(const int8_t *q, const int8_t *base, size_t count, size_t dim,
+                                 int32_t *out) {
+    for (size_t r = 0; r < count; r++) {
+        const int8_t *b = base + r * dim;
+        int32_t acc = 0;
+        for (size_t i = 0; i < dim; i++)
+            acc += (q[i] - b[i]) * (q[i] - b[i]);
+        out[r] = acc;
+    }
+}
+
+static void scalar_hamming_batch(const uint64_t *q, const uint64_t *base, size_t count,
+                                 size_t nwords, uint64_t *out) {
+    for (size_t r = 0; r < count; r++) {
+        uint64_t acc = 0;
+        for (size_t i = 0; i < nwords; i++)
+            acc += (uint64_t)__builtin_popcountll(q[i] ^ base[r * nwords + i]);
+        out[r] = acc;
+    }
+}
+
+/* Bounded max-heap over the distances, one element at a time. */
+static void scalar_topk(const float *dist, size_t n, size_t k, size_t *idx, float *out) {
+    size_t len = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (len == k && dist[i] >= out[0])
+            continue;
+        size_t pos;
+        if (len < k) {
+            pos = len++;
+            while (pos && out[(pos - 1) / 2] < dist[i]) {
+                out[pos] = out[(pos - 1) / 2];
+                idx[pos] = idx[(pos - 1) / 2];
+                pos = (pos - 1) / 2;
+            }
+        } else {
+            pos = 0;
+            for (;;) {
+                size_t l = 2 * pos + 1, m = l;
+                if (l >= len) break;
+                if (l + 1 < len && out[l + 1] > out[l]) m = l + 1;
+                if (out[m] <= dist[i]) break;
+                out[pos] = out[m];
+                idx[pos] = idx[m];
+                pos = m;
+            }
+        }
+        out[pos] = dist[i];
+        idx[pos] = i;
+    }
+}
+
+int main(void) {
+    void *base = malloc(BASE_BYTES);
+    float *q = malloc(4096 * sizeof(float));
+    float *out = malloc(BASE_BYTES / 4 * sizeof(float));
+    uint64_t *hout = malloc(BASE_BYTES / 8 * sizeof(uint64_t));
+    uint64_t seed = 55;
+    for (size_t i = 0; i < BASE_BYTES / 8; i++)
+        ((uint64_t *)base)[i] = bench_rand(&seed);
+
+    printf("one-to-many over a %u MiB base (M distances/s)\n", BASE_BYTES >> 20);
+    printf("  kernel          dim     simd   scalar\n");
+
+    float *fb = base;
+    for (size_t i = 0; i < BASE_BYTES / sizeof(float); i++)
+        fb[i] = (float)(bench_rand(&seed) % 2001) / 1000.0f - 1.0f;
+    for (size_t i = 0; i < 4096; i++)
+        q[i] = (float)(bench_rand(&seed) % 2001) / 1000.0f - 1.0f;
+    const size_t dims[] = { 128, 768, 1536 };
+    for (size_t d = 0; d < 3; d++) {
+        size_t dim = dims[d], count = BASE_BYTES / sizeof(float) / dim;
+        double t1 = BENCH_BEST(REPS, simd_l2sq_batch(float, q, fb, count, dim, out); bench_sink += out[1]);
+        double t2 = BENCH_BEST(REPS, scalar_l2sq_batch_f(q, fb, count, dim, out); bench_sink += out[1]);
+        printf("  l2sq float   %6zu %8.2f %8.2f\n", dim, count / t1 * 1e-6, count / t2 * 1e-6);
+        t1 = BENCH_BEST(REPS, simd_inner_product_batch(float, q, fb, count, dim, out); bench_sink += out[1]);
+        t2 = BENCH_BEST(REPS, scalar_ip_batch_f(q, fb, count, dim, out); bench_sink += out[1]);
+        printf("  ip float     %6zu %8.2f %8.2f\n", dim, count / t1 * 1e-6, count / t2 * 1e-6);
+    }
+
+    int8_t *ib = base, qi[1536];
+    for (size_t i = 0; i < 1536; i++)
+        qi[i] = (int8_t)bench_rand(&seed);
+    int32_t *iout = (int32_t *)out;
+    for (size_t d = 0; d < 3; d++) {
+        size_t dim = dims[d], count = BASE_BYTES / dim;
+        double t1 = BENCH_BEST(REPS, simd_l2sq_batch(int8_t, qi, ib, count, dim, iout); bench_sink += iout[1]);
+        double t2 = BENCH_BEST(REPS, scalar_l2sq_batch_i8(qi, ib, count, dim, iout); bench_sink += iout[1]);
+        printf("  l2sq int8    %6zu %8.2f %8.2f\n", dim, count / t1 * 1e-6, count / t2 * 1e-6);
+    }
+
+    uint64_t *hb = base, qh[16];
+    for (size_t i = 0; i < 16; i++)
+        qh[i] = bench_rand(&seed);
+    const size_t bits[] = { 256, 1024 };
+    for (size_t d = 0; d < 2; d++) {
+        size_t nwords = bits[d] / 64, count = BASE_BYTES / 8 / nwords;
+        double t1 = BENCH_BEST(REPS, simd_hamming_batch(uint64_t, qh, hb, count, nwords, hout); bench_sink += hout[1]);
+        double t2 = BENCH_BEST(REPS, scalar_hamming_batch(qh, hb, count, nwords, hout); bench_sink += hout[1]);
+        printf("  hamming bits %6zu %8.2f %8.2f\n", bits[d], count / t1 * 1e-6, count / t2 * 1e-6);
+    }
+
+    size_t n = BASE_BYTES / sizeof(float) / 128;
+    simd_l2sq_batch(float, q, fb, n, 128, out);
+    size_t idx[100], idx2[100];
+    float top[100], top2[100];
+    printf("top-k of %zu distances (M distances/s)\n", n);
+    printf("       k     simd   scalar\n");
+    const size_t ks[] = { 1, 10, 100 };
+    for (size_t j = 0; j < 3; j++) {
+        size_t k = ks[j];
+        double t1 = BENCH_BEST(REPS, simd_topk(float, out, n, k, idx, top); bench_sink += top[0]);
+        double t2 = BENCH_BEST(REPS, scalar_topk(out, n, k, idx2, top2); bench_sink += top2[0]);
+        printf("  %6zu %8.2f %8.2f\n", k, n / t1 * 1e-6, n / t2 * 1e-6);
+    }
+
+    free(base); free(q); free(out); free(hout);
+    return 0;
+}
@@ -0,0 +1,64 @@
+/*
+ * Division by a runtime-invariant divisor (user-062): simd_apply_div_const
+ * with a precomputed divider against simd_apply_div with the divisor
+ * broadcast, and a scalar loop dividing by the same variable, for every
+ * integer width. Throughput in G lanes/s over an L1-resident array.
+ */
+#include "notasimdlib.h"
+#include "bench.h"
+#include <stdlib.h>
+
+#define N 4096
+#define REPS 2000
+
+#define BENCH_TYPE(T) \
+decl_simd_t(T) \
+decl_simd_divider(T) \
+static void bench_##T(T d) { \
+    static T x[N], q[N]; \
+    uint64_t seed = 62; \
+    for (size_t i = 0; i < N; i++) \
+        x[i] = (T)bench_rand(&seed); \
+    simd_divider_t(T) dv = simd_divider(T, d); \
+    simd_t(T) vd = simd_splat(T, d); \
+    double t1 = BENCH_BEST(REPS, \
+        for (size_t i = 0; i < N; i += VLEN(T)) \
+            simd_store(T, q + i, simd_apply_div_const(T, simd_load(T, x + i), dv)); \
+        bench_sink += q[N / 2]); \
+    T chk = q[N / 3]; \
+    double t2 = BENCH_BEST(REPS, \
+        for (size_t i = 0; i < N; i += VLEN(T)) \
+            simd_store(T, q + i, simd_apply_div(T, simd_load(T, x + i), vd)); \
+        bench_sink += q[N / 2]); \
+    double t3 = BENCH_BEST(REPS, \
+        for (size_t i = 0; i < N; i++) \
+            q[i] = (T)(x[i] / d); \
+        bench_sink += q[N / 2]); \
+    printf("%-9s %8.2f %8.2f %8.2f  %s\n", #T, N / t1 * 1e-9, N / t2 * 1e-9, N / t3 * 1e-9, \
+           chk == q[N / 3] ? "ok" : "MISMATCH"); \
+}
+
+BENCH_TYPE(int8_t)
+BENCH_TYPE(uint8_t)
+BENCH_TYPE(int16_t)
+BENCH_TYPE(uint16_t)
+BENCH_TYPE(int32_t)
+BENCH_TYPE(uint32_t)
+BENCH_TYPE(int64_t)
+BENCH_TYPE(uint64_t)
+
+int main(int argc, char **argv) {
+    /* The divisor comes from the command line so nothing folds it. */
+    int d = argc > 1 ? atoi(argv[1]) : 7;
+    printf("x / %d over %d lanes (G lanes/s)\n", d, N);
+    printf("type      div_const      div   scalar  check\n");
+    bench_int8_t((int8_t)d);
+    bench_uint8_t((uint8_t)d);
+    bench_int16_t((int16_t)d);
+    bench_uint16_t((uint16_t)d);
+    bench_int32_t((int32_t)d);
+    bench_uint32_t((uint32_t)d);
+    bench_int64_t((int64_t)d);
+    bench_uint64_t((uint64_t)d);
+    return 0;
+}
@@ -0,0 +1,137 @@
+/*
+ * Huge-page backed arrays (user-074): array_sum, array_add and a strided
+ * view_sum that touches one element per 4 KiB page, over 256 MiB float
+ * arrays from simd_alloc_ex with no flags, SIMD_ALLOC_HUGEPAGE and
+ * SIMD_ALLOC_HUGETLB. Prints the backing simd_alloc_kind reports, the
+ * best time of each kernel, and the dTLB load and store misses of one
+ * pass counted with perf_event_open (user space only). Where the kernel
+ * or the sandbox gives no such counters the miss columns read n/a.
+ */
+#include "notasimdlib.h"
+#include "bench.h"
+#include <errno.h>
+#include <string.h>
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+
+decl_simd_t(float)
+decl_simd_array_ops(float)
+decl_simd_view_ops(float)
+
+#define N ((size_t)1 << 26)
+#define REPS 5
+
+/* Open a user-space dTLB miss counter for op (read or write); -1 if unavailable. */
+static int dtlb_open(int op) {
+#if defined(__linux__) && defined(SYS_perf_event_open)
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HW_CACHE;
+    attr.config = PERF_COUNT_HW_CACHE_DTLB | (uint64_t)op << 8 |
+                  (uint64_t)PERF_COUNT_HW_CACHE_RESULT_MISS << 16;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+#else
+    (void)op;
+    return -1;
+#endif
+}
+
+static void dtlb_start(int fd) {
+#if defined(__linux__)
+    if (fd >= 0) {
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+#else
+    (void)fd;
+#endif
+}
+
+/* Stop the counter and format its count in millions, or n/a. */
+static const char *dtlb_stop(int fd, char *buf, size_t len) {
+    uint64_t count;
+#if defined(__linux__)
+    if (fd >= 0) {
+        ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        if (read(fd, &count, sizeof(count)) == (ssize_t)sizeof(count)) {
+            snprintf(buf, len, "%.3f", (double)count * 1e-6);
+            return buf;
+        }
+    }
+#else
+    (void)fd;
+    (void)count;
+#endif
+    snprintf(buf, len, "n/a");
+    return buf;
+}
+
+static const char *kind_name(int kind) {
+    switch (kind) {
+    case SIMD_ALLOC_KIND_HEAP: return "heap";
+    case SIMD_ALLOC_KIND_PAGES: return "4k pages";
+    case SIMD_ALLOC_KIND_THP: return "thp";
+    case SIMD_ALLOC_KIND_HUGETLB: return "hugetlb";
+    }
+    return "?";
+}
+
+int main(void) {
+    const struct { const char *name; int flags; } modes[] = {
+        { "none", 0 },
+        { "HUGEPAGE", SIMD_ALLOC_HUGEPAGE },
+        { "HUGETLB", SIMD_ALLOC_HUGETLB },
+    };
+    const size_t page = 4096 / sizeof(float);
+    int ld = dtlb_open(PERF_COUNT_HW_CACHE_OP_READ);
+    if (ld < 0)
+        printf("no dTLB counters (perf_event_open: %s)\n", strerror(errno));
+    int st = dtlb_open(PERF_COUNT_HW_CACHE_OP_WRITE);
+
+    printf("%zu MiB float arrays; time in ms, dTLB misses (M) of one pass\n",
+           N * sizeof(float) >> 20);
+    printf("flags     backing    kernel       time   ld miss  st miss\n");
+    for (size_t m = 0; m < sizeof(modes) / sizeof(modes[0]); m++) {
+        float *a = simd_alloc_ex(float, N, modes[m].flags);
+        float *b = simd_alloc_ex(float, N, modes[m].flags);
+        float *c = simd_alloc_ex(float, N, modes[m].flags);
+        if (!a || !b || !c) {
+            perror("simd_alloc_ex");
+            return 1;
+        }
+        for (size_t i = 0; i < N; i++) {
+            a[i] = (float)(i & 1023);
+            b[i] = 1.0f;
+            c[i] = 0.0f;
+        }
+        simd_view_t(float) pages = simd_view(float, a, N / page, (ptrdiff_t)page);
+
+#define ROW(label, ...) do { \
+            double t = BENCH_BEST(REPS, __VA_ARGS__); \
+            char l[32], s[32]; \
+            dtlb_start(ld); \
+            dtlb_start(st); \
+            __VA_ARGS__; \
+            printf("%-9s %-10s %-10s %7.2f %9s %8s\n", modes[m].name, \
+                   kind_name(simd_alloc_kind(a)), label, t * 1e3, \
+                   dtlb_stop(ld, l, sizeof(l)), dtlb_stop(st, s, sizeof(s))); \
+        } while (0)
+
+        ROW("sum", bench_sink += simd_array_sum(float, a, N));
+        ROW("add", simd_array_add(float, c, a, b, N));
+        ROW("view_sum", bench_sink += simd_view_sum(float, pages));
+#undef ROW
+
+        simd_free(a);
+        simd_free(b);
+        simd_free(c);
+    }
+    return 0;
+}
@@ -0,0 +1,111 @@
+/*
+ * 64-bit integer lanes (user-064): simd_apply_mul64, simd_apply_min64
+ * (unsigned), simd_apply_max64 (signed) and simd_apply_cmplt64 (unsigned,
+ * counted) over L1-resident arrays, against a scalar loop the compiler may
+ * not vectorize. The library kernels are built twice: for the target of
+ * CFLAGS and, on x86-64, for AVX2 (target("arch=haswell")), which has no
+ * vpmullq, vpminuq or unsigned compare and so runs the emulated paths.
+ * The AVX2 build also runs the 32-bit partial-product multiply spelled
+ * out by hand, lo*lo + ((lo*hi + hi*lo) << 32), which simd_apply_mul64
+ * leaves to the compiler. G lanes per second.
+ */
+#include "notasimdlib.h"
+#include "bench.h"
+
+decl_simd_t(int64_t)
+decl_simd_t(uint64_t)
+
+#define N 4096
+#define REPS 2000
+
+static uint64_t a[N], b[N], d[N];
+
+#define KERNELS(sfx, attr) \
+attr static void mul_##sfx(void) { \
+    for (size_t i = 0; i < N; i += VLEN(uint64_t)) \
+        simd_store(uint64_t, d + i, simd_apply_mul64(uint64_t, simd_load(uint64_t, a + i), \
+                                                     simd_load(uint64_t, b + i))); \
+} \
+attr static void minu_##sfx(void) { \
+    for (size_t i = 0; i < N; i += VLEN(uint64_t)) \
+        simd_store(uint64_t, d + i, simd_apply_min64(uint64_t, simd_load(uint64_t, a + i), \
+                                                     simd_load(uint64_t, b + i))); \
+} \
+attr static void maxs_##sfx(void) { \
+    for (size_t i = 0; i < N; i += VLEN(int64_t)) \
+        simd_store(int64_t, (int64_t *)d + i, \
+                   simd_apply_max64(int64_t, simd_load(int64_t, (const int64_t *)a + i), \
+                                    simd_load(int64_t, (const int64_t *)b + i))); \
+} \
+attr static size_t cmpu_##sfx(void) { \
+    size_t c = 0; \
+    for (size_t i = 0; i < N; i += VLEN(uint64_t)) \
+        c += simd_mask_count(simd_apply_cmplt64(uint64_t, simd_load(uint64_t, a + i), \
+                                                simd_load(uint64_t, b + i))); \
+    return c; \
+}
+
+KERNELS(native, )
+#if defined(__x86_64__)
+#define HAVE_AVX2_BUILD 1
+KERNELS(avx2, __attribute__((target("arch=haswell"))))
+
+/* The partial products written out: three 32x32->64 multiplies per lane. */
+__attribute__((target("arch=haswell"))) static void mul_pp_avx2(void) {
+    for (size_t i = 0; i < N; i += VLEN(uint64_t)) {
+        simd_t(uint64_t) x = simd_load(uint64_t, a + i), y = simd_load(uint64_t, b + i), r;
+        simd_for_lanes(uint64_t, k) {
+            uint64_t xl = (uint32_t)x.v[k], xh = x.v[k] >> 32;
+            uint64_t yl = (uint32_t)y.v[k], yh = y.v[k] >> 32;
+            r.v[k] = xl * yl + ((xl * yh + xh * yl) << 32);
+        }
+        simd_store(uint64_t, d + i, r);
+    }
+}
+#endif
+
+#define SCALAR __attribute__((noinline, optimize("no-tree-vectorize", "no-tree-slp-vectorize")))
+SCALAR static void mul_scalar(void) {
+    for (size_t i = 0; i < N; i++) d[i] = a[i] * b[i];
+}
+SCALAR static void minu_scalar(void) {
+    for (size_t i = 0; i < N; i++) d[i] = a[i] < b[i] ? a[i] : b[i];
+}
+SCALAR static void maxs_scalar(void) {
+    for (size_t i = 0; i < N; i++)
+        d[i] = (uint64_t)((int64_t)a[i] < (int64_t)b[i] ? (int64_t)b[i] : (int64_t)a[i]);
+}
+SCALAR static size_t cmpu_scalar(void) {
+    size_t c = 0;
+    for (size_t i = 0; i < N; i++) c += a[i] < b[i];
+    return c;
+}
+
+#define RATE(...) (N / BENCH_BEST(REPS, __VA_ARGS__) * 1e-9)
+
+int main(void) {
+    uint64_t seed = 64;
+    for (size_t i = 0; i < N; i++) {
+        a[i] = bench_rand(&seed);
+        b[i] = bench_rand(&seed);
+    }
+    printf("64-bit lanes, %zu per vector (G lanes/s)\n", VLEN(uint64_t));
+    printf("op                native     avx2   scalar\n");
+#ifdef HAVE_AVX2_BUILD
+#define ROW(name, op, ...) \
+    printf("%-15s %8.2f %8.2f %8.2f\n", name, RATE(__VA_ARGS__ op##_native()), \
+           RATE(__VA_ARGS__ op##_avx2()), RATE(__VA_ARGS__ op##_scalar()))
+#else
+#define ROW(name, op, ...) \
+    printf("%-15s %8.2f %8s %8.2f\n", name, RATE(__VA_ARGS__ op##_native()), "-", \
+           RATE(__VA_ARGS__ op##_scalar()))
+#endif
+    ROW("mul64", mul);
+    ROW("min64 unsigned", minu);
+    ROW("max64 signed", maxs);
+    ROW("cmplt64 unsig.", cmpu, bench_sink +=);
+#ifdef HAVE_AVX2_BUILD
+    printf("%-15s %8s %8.2f\n", "mul64 by hand", "-", RATE(mul_pp_avx2()));
+#endif
+    return 0;
+}
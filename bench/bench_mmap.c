@@ -0,0 +1,127 @@
+/*
+ * Memory-mapped array files (user-071): the sum of a 64 MiB float file
+ * written by simd_mmap_write, read four ways with the page cache warm:
+ * read() of the whole payload into an aligned buffer then
+ * simd_array_sum, simd_mmap_open then simd_array_sum on the mapping,
+ * read() in 1 MiB chunks summed as they arrive, and the stream reader
+ * with 1 MiB windows. Each time includes opening and closing the file,
+ * and prints GB/s of payload.
+ */
+#include "notasimdlib.h"
+#include "bench.h"
+#include <fcntl.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+decl_simd_t(float)
+decl_simd_array_ops(float)
+decl_simd_mmap_ops()
+
+#define N ((size_t)1 << 24)
+#define WINDOW ((size_t)1 << 20)
+#define REPS 5
+
+static char path[] = "/tmp/bench_mmap.XXXXXX";
+
+/* Payload offset of the file, read from its header. */
+static off_t payload_offset(void) {
+    simd_file_header_t h;
+    int fd = open(path, O_RDONLY);
+    if (fd < 0 || pread(fd, &h, sizeof(h), 0) != (ssize_t)sizeof(h)) {
+        perror("bench_mmap");
+        exit(1);
+    }
+    close(fd);
+    return (off_t)h.offset;
+}
+
+/* Read len bytes at off into buf; 0 on success. */
+static int read_at(int fd, void *buf, size_t len, off_t off) {
+    char *p = buf;
+    while (len > 0) {
+        ssize_t r = pread(fd, p, len, off);
+        if (r <= 0) return -1;
+        p += r;
+        off += r;
+        len -= (size_t)r;
+    }
+    return 0;
+}
+
+static float sum_read(float *buf, off_t off) {
+    int fd = open(path, O_RDONLY);
+    float s = fd >= 0 && read_at(fd, buf, N * sizeof(float), off) == 0 ? simd_array_sum(float, buf, N) : 0;
+    if (fd >= 0) close(fd);
+    return s;
+}
+
+static float sum_read_chunks(float *buf, off_t off) {
+    int fd = open(path, O_RDONLY);
+    float s = 0;
+    for (size_t i = 0; fd >= 0 && i < N; i += WINDOW / sizeof(float)) {
+        size_t n = N - i < WINDOW / sizeof(float) ? N - i : WINDOW / sizeof(float);
+        if (read_at(fd, buf, n * sizeof(float), off + (off_t)(i * sizeof(float))) != 0) break;
+        s += simd_array_sum(float, buf, n);
+    }
+    if (fd >= 0) close(fd);
+    return s;
+}
+
+static float sum_mmap(int flags) {
+    simd_mmap_t m;
+    const simd_t(float) *v = simd_mmap_open(&m, path, float, flags);
+    float s = v ? simd_array_sum(float, (const float *)v, m.count) : 0;
+    simd_mmap_close(&m);
+    return s;
+}
+
+static float sum_stream(int flags) {
+    simd_mmap_stream_t st;
+    const float *p;
+    size_t n;
+    float s = 0;
+    if (simd_mmap_stream_open(&st, path, float, WINDOW, flags) != 0) return 0;
+    while ((p = simd_mmap_stream_next(float, &st, &n)) != NULL)
+        s += simd_array_sum(float, p, n);
+    simd_mmap_stream_close(&st);
+    return s;
+}
+
+int main(void) {
+    float *x = simd_alloc(float, N);
+    float *buf = simd_alloc(float, N);
+    int fd = mkstemp(path);
+    if (!x || !buf || fd < 0) {
+        perror("bench_mmap");
+        return 1;
+    }
+    close(fd);
+    uint64_t seed = 71;
+    for (size_t i = 0; i < N; i++)
+        x[i] = (float)(bench_rand(&seed) >> 40) * 0x1p-24f;
+    if (simd_mmap_write(path, float, x, N) != 0) {
+        perror("bench_mmap");
+        unlink(path);
+        return 1;
+    }
+    off_t off = payload_offset();
+    bench_sink = sum_read(buf, off);  /* warm the page cache */
+
+    double gb = (double)(N * sizeof(float)) * 1e-9;
+    printf("XLEN=%d N=%zu floats, window %zu KiB, GB/s\n", XLEN, N, WINDOW >> 10);
+    printf("%-28s %8.2f\n", "read() + sum",
+           gb / BENCH_BEST(REPS, bench_sink = sum_read(buf, off)));
+    printf("%-28s %8.2f\n", "mmap + sum",
+           gb / BENCH_BEST(REPS, bench_sink = sum_mmap(SIMD_MMAP_SEQUENTIAL)));
+    printf("%-28s %8.2f\n", "mmap POPULATE + sum",
+           gb / BENCH_BEST(REPS, bench_sink = sum_mmap(SIMD_MMAP_POPULATE)));
+    printf("%-28s %8.2f\n", "read() chunks + sum",
+           gb / BENCH_BEST(REPS, bench_sink = sum_read_chunks(buf, off)));
+    printf("%-28s %8.2f\n", "stream + sum",
+           gb / BENCH_BEST(REPS, bench_sink = sum_stream(SIMD_MMAP_SEQUENTIAL)));
+
+    unlink(path);
+    simd_free(buf);
+    simd_free(x);
+    return 0;
+}
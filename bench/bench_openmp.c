@@ -0,0 +1,149 @@
+/*
+ * OpenMP backend of the array kernels (user-069): add, mul_scalar and sum
+ * over L1-, L2- and DRAM-sized float arrays with the default block loop
+ * (plain), SIMD_OPENMP (omp simd) and SIMD_OPENMP + SIMD_OMP_PARALLEL
+ * (omp parallel for simd, threaded from SIMD_OMP_PARALLEL_MIN elements),
+ * against hand-written intrinsics for the widest of AVX-512, AVX and SSE
+ * the target has. The kernels come from omp_kernels.c, built once per
+ * backend. G elements per second; OMP_NUM_THREADS sets the team size.
+ */
+#include "notasimdlib.h"
+#include "bench.h"
+#include <math.h>
+#include <omp.h>
+#if defined(__AVX512F__) || defined(__AVX__) || defined(__SSE__)
+#include <immintrin.h>
+#endif
+
+#define BACKENDS(X) X(plain) X(omp) X(par)
+#define DECL(k) \
+    void k##_add(float *dst, const float *a, const float *b, size_t n); \
+    void k##_scale(float *dst, const float *a, float s, size_t n); \
+    float k##_sum(const float *a, size_t n);
+BACKENDS(DECL)
+
+/* The intrinsics path: one register width, unaligned loads, scalar tail. */
+#if defined(__AVX512F__)
+#define INTR_NAME "avx512"
+#define INTR_W 16
+#define intr_t __m512
+#define intr_load _mm512_loadu_ps
+#define intr_store _mm512_storeu_ps
+#define intr_add _mm512_add_ps
+#define intr_mul _mm512_mul_ps
+#define intr_set1 _mm512_set1_ps
+#define intr_zero _mm512_setzero_ps
+#define intr_hsum _mm512_reduce_add_ps
+#elif defined(__AVX__)
+#define INTR_NAME "avx"
+#define INTR_W 8
+#define intr_t __m256
+#define intr_load _mm256_loadu_ps
+#define intr_store _mm256_storeu_ps
+#define intr_add _mm256_add_ps
+#define intr_mul _mm256_mul_ps
+#define intr_set1 _mm256_set1_ps
+#define intr_zero _mm256_setzero_ps
+static inline float intr_hsum(__m256 v) {
+    __m128 s = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+    return _mm_cvtss_f32(_mm_add_ss(s, _mm_shuffle_ps(s, s, 1)));
+}
+#elif defined(__SSE__)
+#define INTR_NAME "sse"
+#define INTR_W 4
+#define intr_t __m128
+#define intr_load _mm_loadu_ps
+#define intr_store _mm_storeu_ps
+#define intr_add _mm_add_ps
+#define intr_mul _mm_mul_ps
+#define intr_set1 _mm_set1_ps
+#define intr_zero _mm_setzero_ps
+static inline float intr_hsum(__m128 s) {
+    s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+    return _mm_cvtss_f32(_mm_add_ss(s, _mm_shuffle_ps(s, s, 1)));
+}
+#endif
+
+#ifdef INTR_W
+static void intr_add_f(float *dst, const float *a, const float *b, size_t n) {
+    size_t i = 0;
+    for (; i + INTR_W <= n; i += INTR_W)
+        intr_store(dst + i, intr_add(intr_load(a + i), intr_load(b + i)));
+    for (; i < n; i++)
+        dst[i] = a[i] + b[i];
+}
+
+static void intr_scale_f(float *dst, const float *a, float s, size_t n) {
+    intr_t vs = intr_set1(s);
+    size_t i = 0;
+    for (; i + INTR_W <= n; i += INTR_W)
+        intr_store(dst + i, intr_mul(intr_load(a + i), vs));
+    for (; i < n; i++)
+        dst[i] = a[i] * s;
+}
+
+/* Four accumulators, as the sum of the other backends has independent lanes. */
+static float intr_sum_f(const float *a, size_t n) {
+    intr_t s0 = intr_zero(), s1 = intr_zero(), s2 = intr_zero(), s3 = intr_zero();
+    size_t i = 0;
+    for (; i + 4 * INTR_W <= n; i += 4 * INTR_W) {
+        s0 = intr_add(s0, intr_load(a + i));
+        s1 = intr_add(s1, intr_load(a + i + INTR_W));
+        s2 = intr_add(s2, intr_load(a + i + 2 * INTR_W));
+        s3 = intr_add(s3, intr_load(a + i + 3 * INTR_W));
+    }
+    float r = intr_hsum(intr_add(intr_add(s0, s1), intr_add(s2, s3)));
+    for (; i < n; i++)
+        r += a[i];
+    return r;
+}
+#endif
+
+/* One row of the table: G elements/s of each kernel for one backend. */
+static void run(const char *name, size_t n, int reps, float *dst, const float *a, const float *b,
+                void (*add)(float *, const float *, const float *, size_t),
+                void (*scale)(float *, const float *, float, size_t),
+                float (*sum)(const float *, size_t)) {
+    double t1 = BENCH_BEST(reps, add(dst, a, b, n));
+    double t2 = BENCH_BEST(reps, scale(dst, a, 0.5f, n));
+    float s = 0;
+    double t3 = BENCH_BEST(reps, s = sum(a, n); bench_sink += s);
+    float want = plain_sum(a, n);
+    printf("  %-8s %8.2f %8.2f %8.2f  %s\n", name, n / t1 * 1e-9, n / t2 * 1e-9, n / t3 * 1e-9,
+           fabsf(s - want) <= 1e-3f * fabsf(want) + 1e-3f ? "ok" : "MISMATCH");
+}
+
+int main(void) {
+    const size_t sizes[] = { 4096, 65536, (size_t)1 << 24 };
+    const size_t nmax = sizes[sizeof(sizes) / sizeof(sizes[0]) - 1];
+    float *a = simd_alloc(float, nmax), *b = simd_alloc(float, nmax), *dst = simd_alloc(float, nmax);
+    if (!a || !b || !dst) {
+        perror("simd_alloc");
+        return 1;
+    }
+    uint64_t seed = 69;
+    for (size_t i = 0; i < nmax; i++) {
+        a[i] = (float)(bench_rand(&seed) >> 40) * 0x1p-24f;
+        b[i] = (float)(bench_rand(&seed) >> 40) * 0x1p-24f;
+        dst[i] = 0;
+    }
+
+    printf("array kernels, float, %d OpenMP thread(s), parallel from %d elements (G elements/s)\n",
+           omp_get_max_threads(), SIMD_OMP_PARALLEL_MIN);
+    for (size_t j = 0; j < sizeof(sizes) / sizeof(sizes[0]); j++) {
+        size_t n = sizes[j];
+        int reps = n >= nmax ? 5 : (int)(nmax / n > 2000 ? 2000 : nmax / n);
+        printf("n = %zu\n  backend       add    scale      sum  check\n", n);
+        run("plain", n, reps, dst, a, b, plain_add, plain_scale, plain_sum);
+        run("omp", n, reps, dst, a, b, omp_add, omp_scale, omp_sum);
+        run("par", n, reps, dst, a, b, par_add, par_scale, par_sum);
+#ifdef INTR_W
+        run(INTR_NAME, n, reps, dst, a, b, intr_add_f, intr_scale_f, intr_sum_f);
+#endif
+    }
+    simd_free(a);
+    simd_free(b);
+    simd_free(dst);
+    return 0;
+}
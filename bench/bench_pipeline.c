@@ -0,0 +1,101 @@
+/*
+ * Streaming block pipeline (user-072): convert int16 -> float, scale,
+ * add a bias array, clamp at zero and sum, run as one simd_pipe_t(float)
+ * against the same chain of whole-array simd_array_* calls through a
+ * full-size temporary, for an L2-sized and a DRAM-sized stream, and for
+ * several pipeline block sizes. G elements per second.
+ */
+#include "notasimdlib.h"
+#include "bench.h"
+#include <math.h>
+#include <stdlib.h>
+
+decl_simd_t(float)
+decl_simd_array_ops(float)
+decl_simd_pipe_ops(float)
+decl_simd_bin_op(mul, float, *)
+decl_simd_bin_op(add, float, +)
+decl_simd_pipe_stage(mul, float)
+decl_simd_pipe_stage(add, float)
+
+/* Source: the int16 samples of the stream, converted to float. */
+static void from_i16(float *dst, size_t pos, size_t n, const void *arg) {
+    const int16_t *x = (const int16_t *)arg + pos;
+    for (size_t i = 0; i < n; i++)
+        dst[i] = (float)x[i];
+}
+
+/* User stage: v = max(v, 0). */
+static void relu(simd_t(float) *v, size_t n, size_t pos, const void *arg) {
+    (void)pos;
+    (void)arg;
+    for (size_t i = 0; i * VLEN(float) < n; i++)
+        v[i] = simd_apply_max_scalar(float, v[i], 0.0f);
+}
+
+/* The same chain, one whole-array pass per stage. */
+static float stagewise(const int16_t *x, const float *bias, float scale, float *tmp, size_t n) {
+    from_i16(tmp, 0, n, x);
+    simd_array_mul_scalar(float, tmp, tmp, scale, n);
+    simd_array_add(float, tmp, tmp, bias, n);
+    simd_array_max_scalar(float, tmp, tmp, 0.0f, n);
+    return simd_array_sum(float, tmp, n);
+}
+
+static float piped(simd_pipe_t(float) *p, const int16_t *x, size_t n) {
+    return simd_pipe_exec(float, p, from_i16, x, n, NULL, 1);
+}
+
+int main(void) {
+    const size_t sizes[] = { 32768, (size_t)1 << 24 };
+    const size_t blocks[] = { 4096, 16384, 65536, 262144 };   /* bytes */
+    const size_t nmax = sizes[sizeof(sizes) / sizeof(sizes[0]) - 1];
+    /*
+     * Large blocks all start at the same offset in a page; stagger the
+     * arrays by a few cache lines so loads of one are not falsely
+     * ordered behind stores to another (4 KiB aliasing).
+     */
+    int16_t *xa = simd_alloc(int16_t, nmax);
+    float *ba = simd_alloc(float, nmax + 64), *ta = simd_alloc(float, nmax + 64);
+    if (!xa || !ba || !ta) {
+        perror("simd_alloc");
+        return 1;
+    }
+    int16_t *x = xa;
+    float *bias = ba + 16, *tmp = ta + 48;
+    uint64_t seed = 72;
+    for (size_t i = 0; i < nmax; i++) {
+        x[i] = (int16_t)bench_rand(&seed);
+        bias[i] = (float)(bench_rand(&seed) >> 40) * 0x1p-20f - 8.0f;
+    }
+    const float scale = 1.0f / 4096;
+
+    printf("int16 -> float, *scale, +bias, max 0, sum (G elements/s)\n");
+    for (size_t j = 0; j < sizeof(sizes) / sizeof(sizes[0]); j++) {
+        size_t n = sizes[j];
+        int reps = n >= nmax ? 5 : 2000;
+        float want = 0;
+        double t = BENCH_BEST(reps, want = stagewise(x, bias, scale, tmp, n); bench_sink += want);
+        printf("n = %zu (%zu KiB in)\n  stage at a time          %8.2f\n", n,
+               n * (sizeof(int16_t) + sizeof(float)) / 1024, n / t * 1e-9);
+        for (size_t k = 0; k < sizeof(blocks) / sizeof(blocks[0]); k++) {
+            simd_pipe_t(float) p;
+            if (simd_pipe_init(float, &p, blocks[k] / sizeof(float)) != 0) {
+                perror("simd_pipe_init");
+                return 1;
+            }
+            simd_pipe_bin_op_vs(mul, float, &p, &scale);
+            simd_pipe_bin_op_vv(add, float, &p, bias);
+            simd_pipe_add(float, &p, relu, NULL);
+            float s = 0;
+            t = BENCH_BEST(reps, s = piped(&p, x, n); bench_sink += s);
+            printf("  pipeline, %3zu KiB block %8.2f  %s\n", blocks[k] / 1024, n / t * 1e-9,
+                   fabsf(s - want) <= 1e-4f * fabsf(want) ? "ok" : "MISMATCH");
+            simd_pipe_free(float, &p);
+        }
+    }
+    simd_free(xa);
+    simd_free(ba);
+    simd_free(ta);
+    return 0;
+}
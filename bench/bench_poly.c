@@ -0,0 +1,77 @@
+/*
+ * Horner against Estrin (user-058) for polynomial degrees 3..25 on
+ * simd_t(float):
+ *   throughput  independent vectors, so Horner's chains overlap;
+ *   latency     each evaluation feeds the next, exposing the dependency
+ *               chain Estrin shortens from degree to about degree/4 + 2 steps.
+ * Also lut_interp_array against a scalar interpolation loop.
+ * Numbers are ns per vector of VLEN(float) lanes.
+ */
+#include "notasimdlib.h"
+#include "bench.h"
+#include <stdlib.h>
+
+decl_simd_t(float)
+decl_simd_poly_ops(float)
+
+#define N (1u << 16)
+#define CHAIN 100000
+#define REPS 20
+
+static void scalar_lut(const float *table, size_t n, const float *x, size_t count, float *out) {
+    for (size_t i = 0; i < count; i++) {
+        float xc = x[i] > 0 ? x[i] : 0;
+        xc = xc < (float)(n - 1) ? xc : (float)(n - 1);
+        size_t k = (size_t)xc;
+        k = k < n - 2 ? k : n - 2;
+        float f = xc - (float)k;
+        out[i] = table[k] + f * (table[k + 1] - table[k]);
+    }
+}
+
+int main(void) {
+    float *x = malloc(N * sizeof(float)), *y = malloc(N * sizeof(float));
+    float c[32];
+    uint64_t seed = 58;
+    for (size_t i = 0; i < N; i++)
+        x[i] = (float)(bench_rand(&seed) % 2000) / 1000.0f - 1.0f;
+    for (int k = 0; k < 32; k++)
+        c[k] = 1.0f / (float)(k + 1) * ((k & 1) ? -0.5f : 0.5f);
+
+    printf("polynomial on simd_t(float), VLEN %zu (ns per vector)\n", (size_t)VLEN(float));
+    printf(" degree  thr:horner  thr:estrin  lat:horner  lat:estrin\n");
+    const int degrees[] = { 3, 5, 7, 9, 13, 17, 25 };
+    for (size_t d = 0; d < sizeof(degrees) / sizeof(degrees[0]); d++) {
+        int deg = degrees[d];
+        const size_t nv = N / VLEN(float);
+        double th = BENCH_BEST(REPS, for (size_t i = 0; i < N; i += VLEN(float))
+                                         simd_store(float, y + i, simd_polyval_horner(float, c, deg, simd_load(float, x + i)));
+                                     bench_sink += y[1]);
+        double te = BENCH_BEST(REPS, for (size_t i = 0; i < N; i += VLEN(float))
+                                         simd_store(float, y + i, simd_polyval_estrin(float, c, deg, simd_load(float, x + i)));
+                                     bench_sink += y[1]);
+        /* p(x) stays within (-1, 1) for these coefficients and |x| < 1. */
+        simd_t(float) v;
+        double lh = BENCH_BEST(5, v = simd_load(float, x);
+                                  for (int i = 0; i < CHAIN; i++) v = simd_polyval_horner(float, c, deg, v);
+                                  bench_sink += v.v[0]);
+        double le = BENCH_BEST(5, v = simd_load(float, x);
+                                  for (int i = 0; i < CHAIN; i++) v = simd_polyval_estrin(float, c, deg, v);
+                                  bench_sink += v.v[0]);
+        printf(" %6d %11.2f %11.2f %11.2f %11.2f\n", deg, th / nv * 1e9, te / nv * 1e9,
+               lh / CHAIN * 1e9, le / CHAIN * 1e9);
+    }
+
+    float table[257];
+    for (int k = 0; k < 257; k++)
+        table[k] = (float)(k * k) / 256.0f;
+    for (size_t i = 0; i < N; i++)
+        x[i] = (float)(bench_rand(&seed) % 256000) / 1000.0f;
+    double tl = BENCH_BEST(REPS, simd_lut_interp_array(float, table, 257, x, N, y); bench_sink += y[1]);
+    double ts = BENCH_BEST(REPS, scalar_lut(table, 257, x, N, y); bench_sink += y[1]);
+    printf("lut_interp_array, 257 entries: %.2f ns per vector, scalar loop %.2f\n",
+           tl / (N / VLEN(float)) * 1e9, ts / (N / VLEN(float)) * 1e9);
+
+    free(x); free(y);
+    return 0;
+}
@@ -0,0 +1,58 @@
+/*
+ * Nested reductions (user-067): simd_reduce_vec over an argument that
+ * computes a vector, here simd_apply_exp in a function the compiler cannot
+ * look into, against the same reduction over a precomputed vector and
+ * against simd_reduce_func, which passes the argument as written and so
+ * evaluates it once per lane. The first two should match; the last pays
+ * for VLEN(float) calls. ns per vector over an L1-resident array.
+ */
+#include "notasimdlib.h"
+#include "bench.h"
+
+#define N 256
+#define REPS 2000
+
+decl_simd_t(float)
+
+/* exp of every lane, kept opaque as if defined in another file. */
+__attribute__((noipa)) static simd_t(float) vexp(simd_t(float) x) {
+    return simd_apply_exp(float, x);
+}
+
+static inline float sum_func(float accum, size_t i, simd_t(float) a) {
+    return accum + a.v[i];
+}
+
+int main(void) {
+    static simd_t(float) x[N];
+    uint64_t seed = 67;
+    for (size_t j = 0; j < N; j++)
+        for (size_t k = 0; k < VLEN(float); k++)
+            x[j].v[k] = (float)(bench_rand(&seed) >> 40) * 0x1p-22f - 2.0f;
+
+    float s1 = 0, s2 = 0, s3 = 0;
+    double t1 = BENCH_BEST(REPS,
+        s1 = 0;
+        for (size_t j = 0; j < N; j++)
+            s1 += simd_reduce_vec(float, sum_func, vexp(x[j]));
+        bench_sink += s1);
+    double t2 = BENCH_BEST(REPS,
+        s2 = 0;
+        for (size_t j = 0; j < N; j++) {
+            simd_t(float) e = vexp(x[j]);
+            s2 += simd_reduce_vec(float, sum_func, e);
+        }
+        bench_sink += s2);
+    double t3 = BENCH_BEST(REPS,
+        s3 = 0;
+        for (size_t j = 0; j < N; j++)
+            s3 += simd_reduce_func(float, sum_func, vexp(x[j]));
+        bench_sink += s3);
+
+    printf("sum of exp over %d vectors of %d floats (ns/vector)\n", N, (int)VLEN(float));
+    printf("  reduce_vec(exp(x))       %8.2f\n", t1 / N * 1e9);
+    printf("  e = exp(x); reduce(e)    %8.2f\n", t2 / N * 1e9);
+    printf("  reduce_func(exp(x))      %8.2f\n", t3 / N * 1e9);
+    printf("  check: %s\n", s1 == s2 && s2 == s3 ? "ok" : "MISMATCH");
+    return 0;
+}
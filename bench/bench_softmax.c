@@ -0,0 +1,85 @@
+/*
+ * Softmax (user-056) at transformer hidden sizes 768..8192 and on long
+ * vectors: the blocked two-pass simd_softmax against the previous
+ * three-pass version (max, exp + sum, scale) and a scalar expf loop.
+ * Each size runs over a batch of rows totalling 16 MiB of float, in
+ * G elements per second.
+ */
+#include "notasimdlib.h"
+#include "bench.h"
+#include <math.h>
+#include <stdlib.h>
+
+decl_simd_t(float)
+decl_simd_nn_ops(float)
+
+#define TOTAL (1u << 22)
+#define REPS 10
+
+static void softmax_3pass(const float *x, size_t n, float *out) {
+    simd_t(float) vm = simd_splat(float, x[0]);
+    size_t i = 0;
+    for (; i + VLEN(float) <= n; i += VLEN(float)) {
+        simd_t(float) v = simd_load(float, x + i);
+        simd_for_lanes(float, k) {
+            vm.v[k] = v.v[k] > vm.v[k] ? v.v[k] : vm.v[k];
+        }
+    }
+    float m = vm.v[0];
+    for (size_t k = 1; k < VLEN(float); k++)
+        m = vm.v[k] > m ? vm.v[k] : m;
+    for (; i < n; i++)
+        m = x[i] > m ? x[i] : m;
+    simd_t(float) vs = simd_splat(float, 0), mm = simd_splat(float, m);
+    for (i = 0; i + VLEN(float) <= n; i += VLEN(float)) {
+        simd_t(float) v = simd_apply_exp(float, simd_apply_sub(float, simd_load(float, x + i), mm));
+        vs = simd_apply_add(float, vs, v);
+        simd_store(float, out + i, v);
+    }
+    float s = simd_apply_sum(float, vs);
+    for (; i < n; i++) {
+        out[i] = simd_apply_exp(float, simd_splat(float, x[i] - m)).v[0];
+        s += out[i];
+    }
+    float inv = 1.0f / s;
+    for (i = 0; i < n; i++)
+        out[i] *= inv;
+}
+
+static void softmax_scalar(const float *x, size_t n, float *out) {
+    float m = x[0], s = 0;
+    for (size_t i = 1; i < n; i++)
+        m = x[i] > m ? x[i] : m;
+    for (size_t i = 0; i < n; i++)
+        s += out[i] = expf(x[i] - m);
+    for (size_t i = 0; i < n; i++)
+        out[i] /= s;
+}
+
+int main(void) {
+    float *x = malloc(TOTAL * sizeof(float)), *y = malloc(TOTAL * sizeof(float));
+    uint64_t seed = 56;
+    for (size_t i = 0; i < TOTAL; i++)
+        x[i] = (float)(bench_rand(&seed) % 20000) / 1000.0f - 10.0f;
+
+    printf("softmax over %u floats in rows of n (G elements/s)\n", TOTAL);
+    printf("         n   2-pass   3-pass   scalar\n");
+    const size_t sizes[] = { 768, 1024, 2048, 4096, 8192, 1u << 18, TOTAL };
+    for (size_t j = 0; j < sizeof(sizes) / sizeof(sizes[0]); j++) {
+        size_t n = sizes[j], rows = TOTAL / n;
+        double t2 = BENCH_BEST(REPS, for (size_t r = 0; r < rows; r++)
+                                         simd_softmax(float, x + r * n, n, y + r * n);
+                                     bench_sink += y[n - 1]);
+        double t3 = BENCH_BEST(REPS, for (size_t r = 0; r < rows; r++)
+                                         softmax_3pass(x + r * n, n, y + r * n);
+                                     bench_sink += y[n - 1]);
+        double ts = BENCH_BEST(REPS, for (size_t r = 0; r < rows; r++)
+                                         softmax_scalar(x + r * n, n, y + r * n);
+                                     bench_sink += y[n - 1]);
+        double e = rows * n * 1e-9;
+        printf("%10zu %8.2f %8.2f %8.2f\n", n, e / t2, e / t3, e / ts);
+    }
+
+    free(x); free(y);
+    return 0;
+}
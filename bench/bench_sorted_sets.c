@@ -0,0 +1,138 @@
+/*
+ * Sorted uint32 set intersection, union and lower_bound across list-size
+ * ratios, against scalar merge and galloping loops.
+ */
+#include "notasimdlib.h"
+#include "bench.h"
+#include <stdlib.h>
+
+decl_simd_t(uint32_t)
+decl_simd_set_ops(uint32_t)
+
+/* Sorted, duplicate-free list of n values with mean gap `gap`. */
+static void make_list(uint32_t *x, size_t n, uint32_t gap, uint64_t seed) {
+    uint32_t v = 0;
+    for (size_t i = 0; i < n; i++) {
+        v += 1 + (uint32_t)(bench_rand(&seed) % (2 * gap - 1));
+        x[i] = v;
+    }
+}
+
+static size_t merge_intersect(const uint32_t *a, size_t na, const uint32_t *b, size_t nb,
+                              uint32_t *out) {
+    size_t i = 0, j = 0, k = 0;
+    while (i < na && j < nb) {
+        if (a[i] < b[j]) {
+            i++;
+        } else if (b[j] < a[i]) {
+            j++;
+        } else {
+            out[k++] = a[i];
+            i++;
+            j++;
+        }
+    }
+    return k;
+}
+
+static size_t gallop_intersect(const uint32_t *a, size_t na, const uint32_t *b, size_t nb,
+                               uint32_t *out) {
+    size_t j = 0, k = 0;
+    for (size_t i = 0; i < na && j < nb; i++) {
+        size_t step = 1;
+        while (j + step < nb && b[j + step] < a[i]) {
+            step *= 2;
+        }
+        size_t lo = j, hi = j + step < nb ? j + step + 1 : nb;
+        while (lo < hi) {
+            size_t mid = lo + (hi - lo) / 2;
+            if (b[mid] < a[i]) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        j = lo;
+        if (j < nb && b[j] == a[i]) {
+            out[k++] = a[i];
+        }
+    }
+    return k;
+}
+
+static size_t merge_union(const uint32_t *a, size_t na, const uint32_t *b, size_t nb,
+                          uint32_t *out) {
+    size_t i = 0, j = 0, k = 0;
+    while (i < na && j < nb) {
+        if (a[i] < b[j]) {
+            out[k++] = a[i++];
+        } else if (b[j] < a[i]) {
+            out[k++] = b[j++];
+        } else {
+            out[k++] = a[i++];
+            j++;
+        }
+    }
+    while (i < na) {
+        out[k++] = a[i++];
+    }
+    while (j < nb) {
+        out[k++] = b[j++];
+    }
+    return k;
+}
+
+int main(void) {
+    const size_t nb = (size_t)1 << 22;
+    const size_t ratios[] = { 1, 4, 16, 64, 256, 1024 };
+    uint32_t *a = malloc(nb * sizeof(uint32_t)), *b = malloc(nb * sizeof(uint32_t));
+    uint32_t *out = malloc(2 * nb * sizeof(uint32_t));
+    make_list(b, nb, 4, 1);
+
+    printf("intersect / union of |a| = |b| / ratio with |b| = %zu (M input elements/s)\n", nb);
+    printf("%6s %10s %10s %10s %10s %10s %10s\n",
+           "ratio", "simd_isect", "merge", "gallop", "simd_union", "merge_un", "matches");
+    for (size_t r = 0; r < sizeof(ratios) / sizeof(ratios[0]); r++) {
+        size_t na = nb / ratios[r];
+        make_list(a, na, (uint32_t)(4 * ratios[r]), 2 + r);
+        size_t k = 0;
+        double ts = BENCH_BEST(5, k = simd_intersect(uint32_t, a, na, b, nb, out));
+        double tm = BENCH_BEST(5, bench_sink += merge_intersect(a, na, b, nb, out));
+        double tg = BENCH_BEST(5, bench_sink += gallop_intersect(a, na, b, nb, out));
+        double tu = BENCH_BEST(5, bench_sink += simd_union(uint32_t, a, na, b, nb, out));
+        double tmu = BENCH_BEST(5, bench_sink += merge_union(a, na, b, nb, out));
+        double m = (double)(na + nb) * 1e-6;
+        printf("%6zu %10.0f %10.0f %10.0f %10.0f %10.0f %10zu\n",
+               ratios[r], m / ts, m / tm, m / tg, m / tu, m / tmu, k);
+    }
+
+    const size_t nq = (size_t)1 << 20;
+    uint64_t seed = 7;
+    uint32_t *keys = malloc(nq * sizeof(uint32_t));
+    for (size_t i = 0; i < nq; i++) {
+        keys[i] = (uint32_t)(bench_rand(&seed) % b[nb - 1]);
+    }
+    double tl = BENCH_BEST(5, for (size_t i = 0; i < nq; i++) {
+        bench_sink += (double)simd_lower_bound(uint32_t, b, nb, keys[i]);
+    });
+    double tb = BENCH_BEST(5, for (size_t i = 0; i < nq; i++) {
+        size_t lo = 0, hi = nb;
+        while (lo < hi) {
+            size_t mid = lo + (hi - lo) / 2;
+            if (b[mid] < keys[i]) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        bench_sink += (double)lo;
+    });
+    printf("lower_bound over %zu keys: simd %.1f ns/query, scalar binary search %.1f ns/query\n",
+           nb, tl / (double)nq * 1e9, tb / (double)nq * 1e9);
+
+    free(a);
+    free(b);
+    free(out);
+    free(keys);
+    return 0;
+}
@@ -0,0 +1,144 @@
+/*
+ * Strided and 2-D views (user-075) against copy-then-compute, where the
+ * strided data is packed into a contiguous scratch buffer, the
+ * simd_array_* kernel runs on it, and the result is unpacked. On a
+ * 4096 x 4096 float matrix: every column scaled one view at a time, the
+ * whole matrix scaled as one transposed view, per-column sums, a
+ * 2048 x 2048 sub-block a + b; and a stride-2 a + b over 8M elements.
+ * Best time of each in milliseconds.
+ */
+#include "notasimdlib.h"
+#include "bench.h"
+#include <stdlib.h>
+
+decl_simd_t(float)
+decl_simd_array_ops(float)
+decl_simd_view_ops(float)
+
+#define D 4096
+#define B 2048
+#define S ((size_t)1 << 23)
+#define REPS 5
+
+static float *m, *m2, *buf, *buf2, *out;
+
+/* Pack view v into buf (row-major, v.rows x v.len). */
+static void pack(float *dst, simd_view_t(float) v) {
+    for (size_t r = 0; r < v.rows; r++) {
+        const float *p = v.base + (ptrdiff_t)r * v.pitch;
+        for (size_t i = 0; i < v.len; i++) *dst++ = p[(ptrdiff_t)i * v.stride];
+    }
+}
+
+/* Unpack buf into view v. */
+static void unpack(simd_view_t(float) v, const float *src) {
+    for (size_t r = 0; r < v.rows; r++) {
+        float *p = v.base + (ptrdiff_t)r * v.pitch;
+        for (size_t i = 0; i < v.len; i++) p[(ptrdiff_t)i * v.stride] = *src++;
+    }
+}
+
+static void cols_view(void) {
+    for (size_t c = 0; c < D; c++) {
+        simd_view_t(float) col = simd_view_col(float, m, D, D, c);
+        simd_view_mul_scalar(float, col, col, 1.0001f);
+    }
+}
+
+static void cols_copy(void) {
+    for (size_t c = 0; c < D; c++) {
+        simd_view_t(float) col = simd_view_col(float, m, D, D, c);
+        pack(buf, col);
+        simd_array_mul_scalar(float, buf, buf, 1.0001f, D);
+        unpack(col, buf);
+    }
+}
+
+static void transposed_view(void) {
+    simd_view_t(float) t = simd_view_transpose(float, simd_view_2d(float, m, D, D, D));
+    simd_view_mul_scalar(float, t, t, 1.0001f);
+}
+
+static void transposed_copy(void) {
+    simd_view_t(float) t = simd_view_transpose(float, simd_view_2d(float, m, D, D, D));
+    pack(buf, t);
+    simd_array_mul_scalar(float, buf, buf, 1.0001f, (size_t)D * D);
+    unpack(t, buf);
+}
+
+static float col_sums_view(void) {
+    float s = 0;
+    for (size_t c = 0; c < D; c++) s += simd_view_sum(float, simd_view_col(float, m, D, D, c));
+    return s;
+}
+
+static float col_sums_copy(void) {
+    float s = 0;
+    for (size_t c = 0; c < D; c++) {
+        pack(buf, simd_view_col(float, m, D, D, c));
+        s += simd_array_sum(float, buf, D);
+    }
+    return s;
+}
+
+static void block_view(void) {
+    simd_view_t(float) a = simd_view_2d(float, m + 1000 * D + 1000, B, B, D);
+    simd_view_t(float) b = simd_view_2d(float, m2 + 1000 * D + 1000, B, B, D);
+    simd_view_add(float, a, a, b);
+}
+
+static void block_copy(void) {
+    simd_view_t(float) a = simd_view_2d(float, m + 1000 * D + 1000, B, B, D);
+    simd_view_t(float) b = simd_view_2d(float, m2 + 1000 * D + 1000, B, B, D);
+    pack(buf, a);
+    pack(buf2, b);
+    simd_array_add(float, buf, buf, buf2, (size_t)B * B);
+    unpack(a, buf);
+}
+
+static void stride2_view(void) {
+    simd_view_t(float) a = simd_view(float, m, S, 2);
+    simd_view_t(float) b = simd_view(float, m2 + 1, S, 2);
+    simd_view_add(float, simd_view(float, out, S, 1), a, b);
+}
+
+static void stride2_copy(void) {
+    pack(buf, simd_view(float, m, S, 2));
+    pack(buf2, simd_view(float, m2 + 1, S, 2));
+    simd_array_add(float, out, buf, buf2, S);
+}
+
+int main(void) {
+    m = simd_alloc(float, (size_t)D * D);
+    m2 = simd_alloc(float, (size_t)D * D);
+    buf = simd_alloc(float, (size_t)D * D);
+    buf2 = simd_alloc(float, (size_t)D * D);
+    out = simd_alloc(float, S);
+    if (!m || !m2 || !buf || !buf2 || !out) {
+        perror("simd_alloc");
+        return 1;
+    }
+    uint64_t seed = 75;
+    for (size_t i = 0; i < (size_t)D * D; i++) {
+        m[i] = (float)(bench_rand(&seed) & 1023) * 0x1p-10f;
+        m2[i] = (float)(bench_rand(&seed) & 1023) * 0x1p-10f;
+    }
+
+    printf("XLEN=%d %dx%d float matrix, ms\n", XLEN, D, D);
+    printf("%-24s %10s %10s\n", "kernel", "view", "copy");
+#define ROW(label, view, copy) \
+    printf("%-24s %10.2f %10.2f\n", label, BENCH_BEST(REPS, view) * 1e3, BENCH_BEST(REPS, copy) * 1e3)
+    ROW("columns * s", cols_view(), cols_copy());
+    ROW("transposed * s", transposed_view(), transposed_copy());
+    ROW("column sums", bench_sink = col_sums_view(), bench_sink = col_sums_copy());
+    ROW("2048x2048 block a + b", block_view(), block_copy());
+    ROW("stride 2 a + b (8M)", stride2_view(), stride2_copy());
+#undef ROW
+
+    simd_free(out);
+    simd_free(buf2);
+    simd_free(buf);
+    simd_free(m2);
+    simd_free(m);
+    return 0;
+}
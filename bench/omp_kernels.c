@@ -0,0 +1,31 @@
+/*
+ * Array kernels of bench_openmp, built once per backend. The Makefile
+ * compiles this file three times with a different KERN prefix:
+ *
+ *   plain  default block loop
+ *   omp    -DSIMD_OPENMP (omp simd)
+ *   par    -DSIMD_OPENMP -DSIMD_OMP_PARALLEL (omp parallel for simd)
+ *
+ * The generated kernels are static, so the three objects link together;
+ * inline as well, so the ones no wrapper calls draw no -Wunused-function.
+ */
+#define SIMD_FUNC static inline
+#define SIMD_OMP_ASSUME_ALIGNED
+#include "notasimdlib.h"
+
+decl_simd_t(float)
+decl_simd_array_ops(float)
+
+#define KFN(name) PPCAT(KERN, PPCAT(_, name))
+
+void KFN(add)(float *dst, const float *a, const float *b, size_t n) {
+    simd_array_noalias(float, add, dst, a, b, n);
+}
+
+void KFN(scale)(float *dst, const float *a, float s, size_t n) {
+    simd_array_noalias(float, mul_scalar, dst, a, s, n);
+}
+
+float KFN(sum)(const float *a, size_t n) {
+    return simd_array_sum(float, a, n);
+}
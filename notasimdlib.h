@@ -1,4 +1,18 @@
 #include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <errno.h>
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+#if defined(__linux__)
+#include <sys/syscall.h>
+#endif
 
 /* -------------------------------------------------------------------------
  * Macro concatenation utilities
@@ -29,6 +43,22 @@
  */
 #define PPCAT(A, B) PPCAT_NX(A, B)
 
+/**
+ * @brief Stringify a token sequence without expanding macros.
+ */
+#define PPSTR_NX(...) #__VA_ARGS__
+
+/**
+ * @brief Stringify a token sequence after macro expansion.
+ *
+ * Used to build _Pragma operands from macro arguments.
+ *
+ * Example:
+ *   #define N 4
+ *   PPSTR(GCC unroll N) → "GCC unroll 4"
+ */
+#define PPSTR(...) PPSTR_NX(__VA_ARGS__)
+
 /* -------------------------------------------------------------------------
  * SIMD vector configuration
  * ------------------------------------------------------------------------- */
@@ -53,6 +83,67 @@
  */
 #define VLEN(T) (XLEN / (8 * sizeof(T)))
 
+/**
+ * @brief Ask the compiler to fully unroll the following loop, up to n times.
+ *
+ * #pragma GCC unroll n on GCC 8 and later, #pragma clang loop unroll(full)
+ * on clang, nothing elsewhere. n may be any integer constant expression,
+ * VLEN(T) included.
+ */
+#if defined(__clang__)
+#define simd_unroll(n) _Pragma("clang loop unroll(full)")
+#elif defined(__GNUC__) && __GNUC__ >= 8
+#define simd_unroll(n) _Pragma(PPSTR(GCC unroll n))
+#else
+#define simd_unroll(n)
+#endif
+
+/**
+ * @brief Keep the following loop rolled: #pragma GCC unroll 1, or
+ *        clang loop unroll(disable).
+ *
+ * For loops the loop vectorizer handles but the basic-block vectorizer
+ * does not once they are peeled, which GCC does at -O3 before
+ * vectorizing.
+ */
+#if defined(__clang__)
+#define simd_no_unroll _Pragma("clang loop unroll(disable)")
+#elif defined(__GNUC__) && __GNUC__ >= 8
+#define simd_no_unroll _Pragma("GCC unroll 1")
+#else
+#define simd_no_unroll
+#endif
+
+/**
+ * @brief Loop header over the lanes of simd_t(T): i = 0 .. VLEN(T) - 1.
+ *
+ * @tparam T Scalar type
+ * @param i  Name of the size_t lane index declared by the loop
+ *
+ * The counter has the same unsigned type as VLEN(T), and the loop is
+ * marked with simd_unroll(VLEN(T)), so even at -O2 it becomes straight-line
+ * lane code that the SLP vectorizer turns into a few full-width
+ * instructions, with no peeling or versioning of a rolled loop. Every lane
+ * loop of the library is written with it.
+ *
+ * Example:
+ *   simd_for_lanes(float, i) { c.v[i] = a.v[i] + b.v[i]; }
+ */
+#define simd_for_lanes(T, i) \
+    simd_unroll(VLEN(T)) \
+    for (size_t i = 0; i < VLEN(T); i++)
+
+/**
+ * @brief simd_for_lanes without the unroll request.
+ *
+ * For lane loops whose body is a select on a floating-point compare or
+ * gathers a bit mask: GCC if-converts and vectorizes those as a loop, but
+ * once unrolled the compares stay scalar branches. The counter is a
+ * 32-bit unsigned, so shifts and compares on it vectorize at lane width.
+ */
+#define simd_for_lanes_rolled(T, i) \
+    for (unsigned i = 0; i < VLEN(T); i++)
+
 /* -------------------------------------------------------------------------
  * SIMD type declaration
  * ------------------------------------------------------------------------- */
@@ -76,6 +167,8 @@
  * Declares a struct with:
  *   - Name: simd_v{T}{XLEN}_t
  *   - Members: array v[VLEN(T)] of type T
+ * and the static inline functions behind simd_apply_add/sub/mul/div/sum/dot
+ * (see decl_simd_apply_ops).
  *
  * Example:
  *   decl_simd_t(float) →
@@ -84,7 +177,8 @@
 #define decl_simd_t(T) \
 typedef struct simd_t(T) { \
     T v[VLEN(T)]; \
-} simd_t(T);
+} simd_t(T); \
+decl_simd_apply_ops(T)
 
 /* -------------------------------------------------------------------------
  * SIMD operation naming
@@ -102,6 +196,96 @@ typedef struct simd_t(T) { \
  */
 #define simd_op_name(T,name) PPCAT(name,PPCAT(_,simd_t(T)))
 
+/* -------------------------------------------------------------------------
+ * SIMD function qualifiers
+ * ------------------------------------------------------------------------- */
+
+/**
+ * @brief Storage and inlining qualifier of every generated function.
+ *
+ * Empty by default: the decl_* generators define ordinary external
+ * functions, to be expanded in exactly one translation unit. Defining
+ * SIMD_INLINE before including the header makes them
+ * static inline __attribute__((always_inline)), so simd_t(T) arguments and
+ * results stay in registers across chained calls instead of going through
+ * memory, as the SysV ABI does for structs wider than 16 bytes (XLEN 256
+ * and 512). It also lets several translation units expand the same
+ * generators. SIMD_FUNC can be defined directly for other qualifiers.
+ *
+ * Example:
+ *   #define SIMD_INLINE
+ *   #include "notasimdlib.h"
+ */
+#ifndef SIMD_FUNC
+#ifdef SIMD_INLINE
+#define SIMD_FUNC static inline __attribute__((always_inline))
+#else
+#define SIMD_FUNC
+#endif
+#endif
+
+/**
+ * @brief Calling convention of every generated function.
+ *
+ * __vectorcall where the compiler supports it (MSVC-compatible compilers
+ * targeting 32/64-bit x86), empty elsewhere; GCC and SysV targets have no
+ * equivalent. Only homogeneous aggregates of up to four float or double
+ * lanes qualify for register passing under __vectorcall, so wider
+ * simd_t(T) still benefit more from SIMD_INLINE or the pointer variants.
+ */
+#ifndef SIMD_CALLCONV
+#if (defined(_MSC_VER) || (defined(__clang__) && defined(_WIN32))) && \
+    (defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__))
+#define SIMD_CALLCONV __vectorcall
+#else
+#define SIMD_CALLCONV
+#endif
+#endif
+
+/**
+ * @brief restrict qualifier of the no-alias kernel variants.
+ *
+ * C99 restrict in C, the __restrict__/__restrict extension in C++ (which
+ * has no standard spelling). A pointer parameter marked SIMD_RESTRICT
+ * must not share any element with another one of the same call, which
+ * lets the compiler vectorize without runtime overlap checks.
+ */
+#ifndef SIMD_RESTRICT
+#if defined(__cplusplus) && defined(_MSC_VER)
+#define SIMD_RESTRICT __restrict
+#elif defined(__cplusplus) || !defined(__STDC_VERSION__) || __STDC_VERSION__ < 199901L
+#define SIMD_RESTRICT __restrict__
+#else
+#define SIMD_RESTRICT restrict
+#endif
+#endif
+
+/**
+ * @brief 1 on big-endian targets, 0 otherwise.
+ *
+ * Taken from the compiler's __BYTE_ORDER__ (GCC and Clang); kernels that
+ * reinterpret bytes as wider words test it to keep lane r in bit r.
+ */
+#ifndef SIMD_BIG_ENDIAN
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define SIMD_BIG_ENDIAN 1
+#else
+#define SIMD_BIG_ENDIAN 0
+#endif
+#endif
+
+/**
+ * @brief Compile-time assertion usable inside statement expressions.
+ *
+ * C11 spells it _Static_assert, C++11 static_assert; g++ knows only the
+ * latter.
+ */
+#ifdef __cplusplus
+#define simd_static_assert(cond, msg) static_assert(cond, msg)
+#else
+#define simd_static_assert(cond, msg) _Static_assert(cond, msg)
+#endif
+
 /* -------------------------------------------------------------------------
  * SIMD binary operations
  * ------------------------------------------------------------------------- */
@@ -120,6 +304,57 @@ typedef struct simd_t(T) { \
  */
 #define simd_bin_op(name, T, a, b) simd_op_name(T,name) (a, b)
 
+/**
+ * @brief Invoke the vector-scalar variant of a binary SIMD operation.
+ *
+ * @param a SIMD operand (simd_t(T))
+ * @param s Scalar operand (T), applied to every lane
+ * @return SIMD vector where each element is (a.v[i] op s)
+ *
+ * Example:
+ *   simd_bin_op_vs(mul,float,x,2.0f) → mul_vs_simd_vfloat128_t(x,2.0f)
+ */
+#define simd_bin_op_vs(name, T, a, s) simd_op_name(T,PPCAT(name,_vs)) (a, s)
+
+/**
+ * @brief Invoke the scalar-vector variant of a binary SIMD operation.
+ *
+ * @param s Scalar operand (T), applied to every lane
+ * @param b SIMD operand (simd_t(T))
+ * @return SIMD vector where each element is (s op b.v[i])
+ *
+ * Example:
+ *   simd_bin_op_sv(sub,float,1.0f,x) → sub_sv_simd_vfloat128_t(1.0f,x)
+ */
+#define simd_bin_op_sv(name, T, s, b) simd_op_name(T,PPCAT(name,_sv)) (s, b)
+
+/**
+ * @brief Invoke the in-place variant of a binary SIMD operation.
+ *
+ * @param dst Pointer to the SIMD operand updated as *dst = *dst op *b
+ * @param b Pointer to the second SIMD operand
+ *
+ * Both operands are passed by pointer and nothing is returned, so wide
+ * types (e.g. 512-bit vectors on ABIs that return large structs through
+ * a hidden pointer) are not copied through the stack on each call.
+ *
+ * Example:
+ *   simd_bin_op_inplace(add,float,&acc,&x) → add_inplace_simd_vfloat128_t(&acc,&x)
+ */
+#define simd_bin_op_inplace(name, T, dst, b) simd_op_name(T,PPCAT(name,_inplace)) (dst, b)
+
+/**
+ * @brief Invoke the pointer variant of a binary SIMD operation.
+ *
+ * @param out Pointer receiving *a op *b (may equal a or b)
+ * @param a Pointer to the first SIMD operand
+ * @param b Pointer to the second SIMD operand
+ *
+ * Example:
+ *   simd_bin_op_p(add,float,&z,&x,&y) → add_p_simd_vfloat128_t(&z,&x,&y)
+ */
+#define simd_bin_op_p(name, T, out, a, b) simd_op_name(T,PPCAT(name,_p)) (out, a, b)
+
 /**
  * @brief Define a binary SIMD operation function with a given operator.
  *
@@ -127,18 +362,126 @@ typedef struct simd_t(T) { \
  * @param T Scalar type
  * @param op Binary operator symbol (+, -, *, /)
  *
- * Declares a function:
+ * Declares functions:
  *   simd_t(T) name_simd_v{T}{XLEN}_t(simd_t(T) a, simd_t(T) b)
- * that applies `a.v[i] op b.v[i]` elementwise.
+ *   simd_t(T) name_vs_simd_v{T}{XLEN}_t(simd_t(T) a, T s)
+ *   simd_t(T) name_sv_simd_v{T}{XLEN}_t(T s, simd_t(T) b)
+ *   void      name_inplace_simd_v{T}{XLEN}_t(simd_t(T) *dst, const simd_t(T) *b)
+ *   void      name_p_simd_v{T}{XLEN}_t(simd_t(T) *out, const simd_t(T) *a,
+ *                                      const simd_t(T) *b)
+ * that apply `a.v[i] op b.v[i]`, `a.v[i] op s`, `s op b.v[i]`,
+ * `dst->v[i] = dst->v[i] op b->v[i]` and `out->v[i] = a->v[i] op b->v[i]`
+ * elementwise. All are qualified with SIMD_FUNC and SIMD_CALLCONV.
  *
  * Example:
  *   decl_simd_bin_op(add,float,+)
- *   → defines add_simd_vfloat128_t(a,b) that adds elementwise.
+ *   → defines add_simd_vfloat128_t(a,b) that adds elementwise,
+ *     plus add_vs_, add_sv_ and add_inplace_ variants.
  */
 #define decl_simd_bin_op(name, T, op) \
-simd_t(T) simd_op_name(T,name) (simd_t(T) a, simd_t(T) b) { \
+SIMD_FUNC simd_t(T) SIMD_CALLCONV simd_op_name(T,name) (simd_t(T) a, simd_t(T) b) { \
+    simd_t(T) c; \
+    simd_for_lanes(T, i) { \
+        c.v[i] = a.v[i] op b.v[i]; \
+    } \
+    return c; \
+} \
+SIMD_FUNC simd_t(T) SIMD_CALLCONV simd_op_name(T,PPCAT(name,_vs)) (simd_t(T) a, T s) { \
     simd_t(T) c; \
-    for (int i = 0; i < VLEN(T); i++) { \
+    simd_for_lanes(T, i) { \
+        c.v[i] = a.v[i] op s; \
+    } \
+    return c; \
+} \
+SIMD_FUNC simd_t(T) SIMD_CALLCONV simd_op_name(T,PPCAT(name,_sv)) (T s, simd_t(T) b) { \
+    simd_t(T) c; \
+    simd_for_lanes(T, i) { \
+        c.v[i] = s op b.v[i]; \
+    } \
+    return c; \
+} \
+SIMD_FUNC void SIMD_CALLCONV \
+simd_op_name(T,PPCAT(name,_inplace)) (simd_t(T) *dst, const simd_t(T) *b) { \
+    simd_for_lanes(T, i) { \
+        dst->v[i] = dst->v[i] op b->v[i]; \
+    } \
+} \
+SIMD_FUNC void SIMD_CALLCONV \
+simd_op_name(T,PPCAT(name,_p)) (simd_t(T) *out, const simd_t(T) *a, \
+                                const simd_t(T) *b) { \
+    simd_t(T) c; \
+    simd_for_lanes(T, i) { \
+        c.v[i] = a->v[i] op b->v[i]; \
+    } \
+    *out = c; \
+}
+
+/* -------------------------------------------------------------------------
+ * SIMD per-type arithmetic functions
+ * ------------------------------------------------------------------------- */
+
+/**
+ * @brief Define the functions the arithmetic simd_apply_* macros forward to.
+ *
+ * @tparam T Scalar type; expanded by decl_simd_t(T)
+ *
+ * Declares static inline functions:
+ *   simd_t(T) apply_{add,sub,mul,div}_simd_v{T}{XLEN}_t(simd_t(T) a, simd_t(T) b)
+ *   T         apply_sum_simd_v{T}{XLEN}_t(simd_t(T) a)
+ *   T         apply_dot_simd_v{T}{XLEN}_t(simd_t(T) a, simd_t(T) b)
+ *   T         apply_reduce_simd_v{T}{XLEN}_t(T (*func)(T, size_t, simd_t(T)), simd_t(T) a)
+ *   T         apply_reduce2_simd_v{T}{XLEN}_t(T (*func)(T, size_t, simd_t(T), simd_t(T)),
+ *                                             simd_t(T) a, simd_t(T) b)
+ *
+ * Being functions, they evaluate each argument exactly once, so nested
+ * calls such as simd_apply_sum(T, simd_apply_mul(T, a, b)) compute the
+ * inner vector once instead of once per lane. They are static inline so
+ * decl_simd_t(T) can still appear in every translation unit.
+ */
+#define decl_simd_apply_ops(T) \
+decl_simd_apply_binop(T, apply_add, +) \
+decl_simd_apply_binop(T, apply_sub, -) \
+decl_simd_apply_binop(T, apply_mul, *) \
+decl_simd_apply_binop(T, apply_div, /) \
+static inline T SIMD_CALLCONV simd_op_name(T,apply_sum) (simd_t(T) a) { \
+    T accum = 0; \
+    simd_for_lanes(T, i) { \
+        accum += a.v[i]; \
+    } \
+    return accum; \
+} \
+static inline T SIMD_CALLCONV simd_op_name(T,apply_dot) (simd_t(T) a, simd_t(T) b) { \
+    T accum = 0; \
+    simd_for_lanes(T, i) { \
+        accum += a.v[i] * b.v[i]; \
+    } \
+    return accum; \
+} \
+static inline T SIMD_CALLCONV \
+simd_op_name(T,apply_reduce) (T (*func)(T, size_t, simd_t(T)), simd_t(T) a) { \
+    T accum = 0; \
+    simd_for_lanes(T, i) { \
+        accum = func(accum, i, a); \
+    } \
+    return accum; \
+} \
+static inline T SIMD_CALLCONV \
+simd_op_name(T,apply_reduce2) (T (*func)(T, size_t, simd_t(T), simd_t(T)), \
+                               simd_t(T) a, simd_t(T) b) { \
+    T accum = 0; \
+    simd_for_lanes(T, i) { \
+        accum = func(accum, i, a, b); \
+    } \
+    return accum; \
+}
+
+/**
+ * @brief Define one static inline elementwise function of decl_simd_apply_ops.
+ */
+#define decl_simd_apply_binop(T, name, op) \
+static inline simd_t(T) SIMD_CALLCONV simd_op_name(T,name) (simd_t(T) a, simd_t(T) b) { \
+    simd_t(T) c; \
+    simd_for_lanes(T, i) { \
         c.v[i] = a.v[i] op b.v[i]; \
     } \
     return c; \
@@ -152,10 +495,15 @@ simd_t(T) simd_op_name(T,name) (simd_t(T) a, simd_t(T) b) { \
  * @brief Reduce a SIMD vector using a custom function.
  *
  * @tparam T Scalar type
- * @param func Function of form func(T accum, int i, args...)
+ * @param func Function of form func(T accum, size_t i, args...)
  * @param ... Additional arguments passed to func
  * @return Reduced scalar value of type T
  *
+ * func is called once per lane with the extra arguments as written, so
+ * an argument that computes a vector, such as simd_apply_mul(T, a, b),
+ * is recomputed on every lane. Compute it first, or use simd_reduce_vec,
+ * whose operands are evaluated once.
+ *
  * Example:
  *   simd_reduce_func(float, my_func, vec)
  *   where my_func(accum, i, vec) → accum + vec.v[i]
@@ -163,7 +511,7 @@ simd_t(T) simd_op_name(T,name) (simd_t(T) a, simd_t(T) b) { \
 #define simd_reduce_func(T,func,...) \
 ({ \
     T accum = 0; \
-    for (int i = 0; i < VLEN(T); i++) { \
+    simd_for_lanes(T, i) { \
         accum = func(accum,i,__VA_ARGS__); \
     } \
     accum; \
@@ -174,21 +522,49 @@ simd_t(T) simd_op_name(T,name) (simd_t(T) a, simd_t(T) b) { \
  *
  * @tparam T Scalar type
  * @param expr Expression involving (accum, i, ...)
- * @param ... Extra arguments (e.g., vectors)
+ * @param ... Variables expr reads (e.g., vectors), for the reader only
  * @return Reduced scalar value
  *
+ * The extra arguments are not evaluated; expr is, on every lane. Compute
+ * a vector input before the call rather than inside expr.
+ *
  * Example:
  *   simd_reduce_expr(float, accum + vec.v[i], vec)
  */
 #define simd_reduce_expr(T,expr,...) \
 ({ \
     T accum = 0; \
-    for (int i = 0; i < VLEN(T); i++) { \
+    simd_for_lanes(T, i) { \
         accum = expr; \
     } \
     accum; \
 })
 
+/**
+ * @brief Reduce one SIMD vector with func(T accum, size_t i, simd_t(T) a).
+ *
+ * @tparam T Scalar type
+ * @param func Function pointer of that type
+ * @param a SIMD vector, evaluated once
+ * @return Reduced scalar value of type T
+ *
+ * Forwards to a static inline function of decl_simd_t(T), so a nested
+ * argument such as simd_apply_mul(T, a, b) is computed once rather than
+ * once per lane as with simd_reduce_func. A func known at the call site
+ * is inlined.
+ *
+ * Example:
+ *   simd_reduce_vec(float, sum_func, simd_apply_mul(float, a, b))
+ */
+#define simd_reduce_vec(T, func, a) simd_op_name(T,apply_reduce) (func, a)
+
+/**
+ * @brief Reduce two SIMD vectors with func(T accum, size_t i, simd_t(T) a, simd_t(T) b).
+ *
+ * As simd_reduce_vec, with both vectors evaluated once.
+ */
+#define simd_reduce_vec2(T, func, a, b) simd_op_name(T,apply_reduce2) (func, a, b)
+
 /**
  * @brief Sum all elements of a SIMD vector.
  *
@@ -199,13 +575,31 @@ simd_t(T) simd_op_name(T,name) (simd_t(T) a, simd_t(T) b) { \
  * Example:
  *   simd_apply_sum(float, vec) → sum of vec.v[]
  */
-#define simd_apply_sum(T, a) \
+#define simd_apply_sum(T, a) simd_op_name(T,apply_sum) (a)
+
+/**
+ * @brief Inclusive prefix sum across the lanes of a SIMD vector.
+ *
+ * @tparam T Scalar type
+ * @param a SIMD vector (simd_t(T))
+ * @return SIMD vector where element i is a.v[0] + ... + a.v[i]
+ *
+ * Uses log2(VLEN(T)) shift-and-add steps instead of a serial chain.
+ *
+ * Example:
+ *   simd_prefix_sum(int, {1,2,3,4}) → {1,3,6,10}
+ */
+#define simd_prefix_sum(T, a) \
 ({ \
-    T accum = 0; \
-    for (int i = 0; i < VLEN(T); i++) { \
-        accum += (a).v[i]; \
+    simd_t(T) _ps_c = (a); \
+    for (unsigned s = 1; s < VLEN(T); s *= 2) { \
+        simd_t(T) _ps_t; \
+        simd_for_lanes(T, i) { \
+            _ps_t.v[i] = i >= s ? _ps_c.v[i - s] : (T)0; \
+        } \
+        _ps_c = simd_apply_add(T, _ps_c, _ps_t); \
     } \
-    accum; \
+    _ps_c; \
 })
 
 /* -------------------------------------------------------------------------
@@ -218,16 +612,21 @@ simd_t(T) simd_op_name(T,name) (simd_t(T) a, simd_t(T) b) { \
  * @tparam T Scalar type
  * @param a First SIMD operand
  * @param b Second SIMD operand
- * @param op Binary operator (+, -, *, /)
+ * @param op Binary operator (+, -, *, /, &, |, ^, ...)
  * @return SIMD vector result
+ *
+ * Each operand is evaluated once. The arithmetic operators have function
+ * forms (simd_apply_add etc.); this macro serves any other operator, and
+ * stays a statement expression because an operator cannot be passed to a
+ * function.
  */
 #define simd_apply_binop(T, a, b, op) \
 ({ \
-    simd_t(T) c; \
-    for (int i = 0; i < VLEN(T); i++) { \
-        c.v[i] = (a).v[i] op (b).v[i]; \
+    simd_t(T) _bo_a = (a), _bo_b = (b); \
+    simd_for_lanes(T, i) { \
+        _bo_a.v[i] = _bo_a.v[i] op _bo_b.v[i]; \
     } \
-    c; \
+    _bo_a; \
 })
 
 /**
@@ -241,7 +640,7 @@ simd_t(T) simd_op_name(T,name) (simd_t(T) a, simd_t(T) b) { \
  * Example:
  *   simd_apply_add(float, a, b) → { a.v[0]+b.v[0], ..., a.v[n]+b.v[n] }
  */
-#define simd_apply_add(T, a, b) simd_apply_binop(T,a,b,+)
+#define simd_apply_add(T, a, b) simd_op_name(T,apply_add) (a, b)
 
 /**
  * @brief Elementwise subtraction of two SIMD vectors.
@@ -254,7 +653,7 @@ simd_t(T) simd_op_name(T,name) (simd_t(T) a, simd_t(T) b) { \
  * Example:
  *   simd_apply_sub(float, a, b) → { a.v[0]-b.v[0], ..., a.v[n]-b.v[n] }
  */
-#define simd_apply_sub(T, a, b) simd_apply_binop(T,a,b,-)
+#define simd_apply_sub(T, a, b) simd_op_name(T,apply_sub) (a, b)
 
 /**
  * @brief Elementwise multiplication of two SIMD vectors.
@@ -267,7 +666,7 @@ simd_t(T) simd_op_name(T,name) (simd_t(T) a, simd_t(T) b) { \
  * Example:
  *   simd_apply_mul(float, a, b) → { a.v[0]*b.v[0], ..., a.v[n]*b.v[n] }
  */
-#define simd_apply_mul(T, a, b) simd_apply_binop(T,a,b,*)
+#define simd_apply_mul(T, a, b) simd_op_name(T,apply_mul) (a, b)
 
 /**
  * @brief Elementwise division of two SIMD vectors.
@@ -280,7 +679,221 @@ simd_t(T) simd_op_name(T,name) (simd_t(T) a, simd_t(T) b) { \
  * Example:
  *   simd_apply_div(float, a, b) → { a.v[0]/b.v[0], ..., a.v[n]/b.v[n] }
  */
-#define simd_apply_div(T, a, b) simd_apply_binop(T,a,b,/)
+#define simd_apply_div(T, a, b) simd_op_name(T,apply_div) (a, b)
+
+/**
+ * @brief Elementwise bitwise AND of two SIMD vectors (integer types).
+ *
+ * @return SIMD vector where each element is (a.v[i] & b.v[i])
+ */
+#define simd_apply_and(T, a, b) simd_apply_binop(T,a,b,&)
+
+/**
+ * @brief Elementwise bitwise OR of two SIMD vectors (integer types).
+ *
+ * @return SIMD vector where each element is (a.v[i] | b.v[i])
+ */
+#define simd_apply_or(T, a, b) simd_apply_binop(T,a,b,|)
+
+/**
+ * @brief Elementwise bitwise XOR of two SIMD vectors (integer types).
+ *
+ * @return SIMD vector where each element is (a.v[i] ^ b.v[i])
+ */
+#define simd_apply_xor(T, a, b) simd_apply_binop(T,a,b,^)
+
+/**
+ * @brief Shift every lane left by the same amount.
+ *
+ * @tparam T Integer scalar type
+ * @param a SIMD vector
+ * @param s Shift count, 0 <= s < 8*sizeof(T)
+ * @return SIMD vector where each element is (T)(a.v[i] << s)
+ */
+#define simd_apply_shl(T, a, s) \
+({ \
+    simd_t(T) _sh_a = (a); \
+    int _sh_s = (s); \
+    simd_t(T) _sh_c; \
+    simd_for_lanes(T, i) { \
+        _sh_c.v[i] = (T)(_sh_a.v[i] << _sh_s); \
+    } \
+    _sh_c; \
+})
+
+/**
+ * @brief Shift every lane right by the same amount.
+ *
+ * @tparam T Integer scalar type (logical shift for unsigned T)
+ * @param a SIMD vector
+ * @param s Shift count, 0 <= s < 8*sizeof(T)
+ * @return SIMD vector where each element is (T)(a.v[i] >> s)
+ */
+#define simd_apply_shr(T, a, s) \
+({ \
+    simd_t(T) _sh_a = (a); \
+    int _sh_s = (s); \
+    simd_t(T) _sh_c; \
+    simd_for_lanes(T, i) { \
+        _sh_c.v[i] = (T)(_sh_a.v[i] >> _sh_s); \
+    } \
+    _sh_c; \
+})
+
+/**
+ * @brief Elementwise minimum of two SIMD vectors.
+ *
+ * @tparam T Scalar type
+ * @param a First SIMD operand
+ * @param b Second SIMD operand
+ * @return SIMD vector where each element is (b.v[i] < a.v[i] ? b.v[i] : a.v[i])
+ *
+ * Written as a select so it lowers to a vector min/blend, never a branch.
+ */
+#define simd_apply_min(T, a, b) \
+({ \
+    simd_t(T) _el_a = (a), _el_b = (b); \
+    simd_for_lanes_rolled(T, i) { \
+        _el_a.v[i] = _el_b.v[i] < _el_a.v[i] ? _el_b.v[i] : _el_a.v[i]; \
+    } \
+    _el_a; \
+})
+
+/**
+ * @brief Elementwise maximum of two SIMD vectors.
+ *
+ * @tparam T Scalar type
+ * @param a First SIMD operand
+ * @param b Second SIMD operand
+ * @return SIMD vector where each element is (b.v[i] > a.v[i] ? b.v[i] : a.v[i])
+ */
+#define simd_apply_max(T, a, b) \
+({ \
+    simd_t(T) _el_a = (a), _el_b = (b); \
+    simd_for_lanes_rolled(T, i) { \
+        _el_a.v[i] = _el_b.v[i] > _el_a.v[i] ? _el_b.v[i] : _el_a.v[i]; \
+    } \
+    _el_a; \
+})
+
+/**
+ * @brief Negate a scalar of type T with two's-complement wrap for integers.
+ *
+ * Integers are negated in the unsigned type of the same width
+ * (simd_uint_of), so the most negative value maps to itself instead of
+ * overflowing, which would be undefined. Floating-point T uses plain -x.
+ * The choice is a constant condition and folds away.
+ */
+#define simd_scalar_neg(T, x) \
+    ((T)0.5 != (T)0 ? (T)-(x) : (T)((simd_uint_of(T))0 - (simd_uint_of(T))(x)))
+
+/**
+ * @brief Absolute value of a scalar of type T without a branch.
+ *
+ * Floating-point T uses fabs (which also maps -0.0 to +0.0); a compare
+ * and select there becomes a branch in scalar code without SSE4 blends.
+ * Integers select against simd_scalar_neg, which compiles to abs or cmov.
+ */
+#define simd_scalar_abs(T, x) \
+    ((T)0.5 != (T)0 \
+         ? (T)(sizeof(T) == sizeof(float) ? __builtin_fabsf(x) : __builtin_fabs(x)) \
+         : (T)((x) < 0 ? simd_scalar_neg(T, x) : (x)))
+
+/**
+ * @brief Elementwise absolute value.
+ *
+ * @tparam T Signed integer or floating-point scalar type
+ * @param a SIMD vector
+ * @return SIMD vector where each element is |a.v[i]|
+ *
+ * -0.0 maps to +0.0. Integers negate through simd_scalar_neg, so the most
+ * negative value wraps to itself, as with abs() on two's-complement targets.
+ */
+#define simd_apply_abs(T, a) \
+({ \
+    simd_t(T) _el_a = (a); \
+    simd_for_lanes_rolled(T, i) { \
+        _el_a.v[i] = simd_scalar_abs(T, _el_a.v[i]); \
+    } \
+    _el_a; \
+})
+
+/**
+ * @brief Elementwise negation.
+ *
+ * @tparam T Scalar type
+ * @param a SIMD vector
+ * @return SIMD vector where each element is -a.v[i]; integers wrap
+ *         (see simd_scalar_neg)
+ */
+#define simd_apply_neg(T, a) \
+({ \
+    simd_t(T) _el_a = (a); \
+    simd_for_lanes(T, i) { \
+        _el_a.v[i] = simd_scalar_neg(T, _el_a.v[i]); \
+    } \
+    _el_a; \
+})
+
+/**
+ * @brief Clamp every lane into [lo, hi].
+ *
+ * @tparam T Scalar type
+ * @param a SIMD vector
+ * @param lo Scalar lower bound
+ * @param hi Scalar upper bound (lo <= hi)
+ * @return SIMD vector where each element is min(max(a.v[i], lo), hi)
+ *
+ * Example:
+ *   simd_apply_clamp(int, {-5, 3, 9, 0}, 0, 5) → {0, 3, 5, 0}
+ */
+#define simd_apply_clamp(T, a, lo, hi) \
+({ \
+    simd_t(T) _el_a = (a); \
+    T _el_lo = (lo), _el_hi = (hi); \
+    simd_for_lanes_rolled(T, i) { \
+        T _el_x = _el_a.v[i] < _el_lo ? _el_lo : _el_a.v[i]; \
+        _el_a.v[i] = _el_x > _el_hi ? _el_hi : _el_x; \
+    } \
+    _el_a; \
+})
+
+/**
+ * @brief Apply a binary operator between every lane and a broadcast scalar.
+ *
+ * @tparam T Scalar type
+ * @param a SIMD vector
+ * @param s Scalar operand
+ * @param op Binary operator (+, -, *, /, &, |, ^)
+ * @return SIMD vector where each element is (a.v[i] op s)
+ */
+#define simd_apply_binop_scalar(T, a, s, op) \
+({ \
+    simd_t(T) _bs_a = (a); \
+    T _bs_s = (s); \
+    simd_for_lanes(T, i) { \
+        _bs_a.v[i] = _bs_a.v[i] op _bs_s; \
+    } \
+    _bs_a; \
+})
+
+/** @brief a.v[i] + s for every lane. */
+#define simd_apply_add_scalar(T, a, s) simd_apply_binop_scalar(T,a,s,+)
+
+/** @brief a.v[i] - s for every lane. */
+#define simd_apply_sub_scalar(T, a, s) simd_apply_binop_scalar(T,a,s,-)
+
+/** @brief a.v[i] * s for every lane. */
+#define simd_apply_mul_scalar(T, a, s) simd_apply_binop_scalar(T,a,s,*)
+
+/** @brief a.v[i] / s for every lane. */
+#define simd_apply_div_scalar(T, a, s) simd_apply_binop_scalar(T,a,s,/)
+
+/** @brief min(a.v[i], s) for every lane. */
+#define simd_apply_min_scalar(T, a, s) simd_apply_min(T,a,simd_splat(T,s))
+
+/** @brief max(a.v[i], s) for every lane. */
+#define simd_apply_max_scalar(T, a, s) simd_apply_max(T,a,simd_splat(T,s))
 
 /**
  * @brief Compute dot product of two SIMD vectors.
@@ -293,5 +906,4686 @@ simd_t(T) simd_op_name(T,name) (simd_t(T) a, simd_t(T) b) { \
  * Example:
  *   simd_apply_dot(float, a, b) → Σ (a.v[i] * b.v[i])
  */
-#define simd_apply_dot(T, a, b) \
-    simd_apply_sum(T, simd_apply_mul(T, a, b))
\ No newline at end of file
+#define simd_apply_dot(T, a, b) simd_op_name(T,apply_dot) (a, b)
+
+/* -------------------------------------------------------------------------
+ * SIMD memory, broadcast and mask primitives
+ * ------------------------------------------------------------------------- */
+
+/**
+ * @brief Lane mask produced by SIMD comparisons.
+ *
+ * Bit i is set when lane i satisfied the comparison. A mask holds up to
+ * 64 lanes, so VLEN(T) must not exceed 64 (XLEN <= 512 for 8-bit types).
+ */
+typedef uint64_t simd_mask_t;
+
+/**
+ * @brief Load a SIMD vector from (possibly unaligned) memory.
+ *
+ * @tparam T Scalar type
+ * @param p Pointer to VLEN(T) elements of type T
+ * @return SIMD vector (simd_t(T))
+ *
+ * Example:
+ *   simd_load(float, &arr[i]) → { arr[i], ..., arr[i+VLEN-1] }
+ */
+#define simd_load(T, p) \
+({ \
+    const T *_ld_p = (p); \
+    simd_t(T) _ld_c; \
+    simd_for_lanes(T, i) { \
+        _ld_c.v[i] = _ld_p[i]; \
+    } \
+    _ld_c; \
+})
+
+/**
+ * @brief Store a SIMD vector to (possibly unaligned) memory.
+ *
+ * @tparam T Scalar type
+ * @param p Destination pointer (room for VLEN(T) elements)
+ * @param a SIMD vector to store
+ */
+#define simd_store(T, p, a) \
+({ \
+    T *_st_p = (p); \
+    simd_t(T) _st_c = (a); \
+    simd_for_lanes(T, i) { \
+        _st_p[i] = _st_c.v[i]; \
+    } \
+    (void)0; \
+})
+
+/**
+ * @brief Broadcast a scalar to every lane of a SIMD vector.
+ *
+ * @tparam T Scalar type
+ * @param x Scalar value
+ * @return SIMD vector { x, x, ..., x }
+ */
+#define simd_splat(T, x) \
+({ \
+    T _sp_x = (x); \
+    simd_t(T) _sp_c; \
+    simd_for_lanes(T, i) { \
+        _sp_c.v[i] = _sp_x; \
+    } \
+    _sp_c; \
+})
+
+/**
+ * @brief Compare two SIMD vectors lane by lane and build a lane mask.
+ *
+ * @tparam T Scalar type
+ * @param a First SIMD operand
+ * @param b Second SIMD operand
+ * @param op Comparison operator (==, !=, <, <=, >, >=)
+ * @return simd_mask_t with bit i set when (a.v[i] op b.v[i])
+ *
+ * The bits are gathered in a T-wide integer, 8 * sizeof(T) lanes at a
+ * time, as (cond) << i in a loop kept rolled. Where the target shifts
+ * each lane by its own count (AVX2 for 32- and 64-bit lanes, AVX-512BW
+ * for 16-bit ones), GCC's loop vectorizer turns that into one packed
+ * compare per register plus a shift and an OR reduction
+ * (tests/test_codegen.sh). A simd_mask_t accumulator, a ternary or a
+ * peeled loop stay one scalar compare per lane on every target, which
+ * is what the other targets still get.
+ *
+ * Example:
+ *   simd_apply_cmp(int, a, b, <) → 0b0101 when lanes 0 and 2 are smaller
+ */
+#define simd_apply_cmp(T, a, b, op) \
+({ \
+    typedef simd_uint_of(T) _cmp_u; \
+    const unsigned _cmp_w = 8 * sizeof(T) < VLEN(T) ? 8 * sizeof(T) : VLEN(T); \
+    simd_t(T) _cmp_a = (a), _cmp_b = (b); \
+    simd_mask_t _cmp_m = 0; \
+    for (unsigned _cmp_j = 0; _cmp_j < VLEN(T); _cmp_j += _cmp_w) { \
+        _cmp_u _cmp_c = 0; \
+        simd_no_unroll \
+        for (_cmp_u i = 0; i < _cmp_w; i++) { \
+            _cmp_c |= (_cmp_u)((_cmp_u)(_cmp_a.v[_cmp_j + i] op _cmp_b.v[_cmp_j + i]) << i); \
+        } \
+        _cmp_m |= (simd_mask_t)_cmp_c << _cmp_j; \
+    } \
+    _cmp_m; \
+})
+
+/** @brief Lane mask of (a.v[i] == b.v[i]). */
+#define simd_apply_cmpeq(T, a, b) simd_apply_cmp(T,a,b,==)
+
+/** @brief Lane mask of (a.v[i] < b.v[i]). */
+#define simd_apply_cmplt(T, a, b) simd_apply_cmp(T,a,b,<)
+
+/** @brief Lane mask of (a.v[i] <= b.v[i]). */
+#define simd_apply_cmple(T, a, b) simd_apply_cmp(T,a,b,<=)
+
+/** @brief Lane mask of (a.v[i] > b.v[i]). */
+#define simd_apply_cmpgt(T, a, b) simd_apply_cmp(T,a,b,>)
+
+/** @brief Lane mask of (a.v[i] >= b.v[i]). */
+#define simd_apply_cmpge(T, a, b) simd_apply_cmp(T,a,b,>=)
+
+/**
+ * @brief Number of lanes set in a mask.
+ *
+ * @param m simd_mask_t
+ * @return Population count of m
+ */
+#define simd_mask_count(m) ((size_t)__builtin_popcountll(m))
+
+/**
+ * @brief Store the lanes selected by a mask contiguously.
+ *
+ * @tparam T Scalar type
+ * @param a SIMD vector
+ * @param m simd_mask_t selecting lanes of a
+ * @param dst Destination pointer (room for simd_mask_count(m) elements)
+ * @return Number of elements written
+ *
+ * Example:
+ *   simd_compress(int, {1,2,3,4}, 0b1010, out) → out = {2,4}, returns 2
+ */
+#define simd_compress(T, a, m, dst) \
+({ \
+    simd_t(T) _cp_a = (a); \
+    simd_mask_t _cp_m = (m); \
+    T *_cp_d = (dst); \
+    size_t _cp_n = 0; \
+    simd_for_lanes(T, i) { \
+        if ((_cp_m >> i) & 1) { \
+            _cp_d[_cp_n++] = _cp_a.v[i]; \
+        } \
+    } \
+    _cp_n; \
+})
+
+/* -------------------------------------------------------------------------
+ * SIMD 64-bit integer lanes
+ * ------------------------------------------------------------------------- */
+
+/**
+ * @brief Whether the target compares unsigned 64-bit lanes natively.
+ *
+ * AVX-512F has vpcmpuq and vpminuq/vpmaxuq; before it only the signed
+ * pcmpgtq (SSE4.2) exists, so unsigned lanes are compared after flipping
+ * their sign bits. Define to 0 or 1 to override.
+ */
+#ifndef SIMD_NATIVE_CMP64
+#if defined(__AVX512F__)
+#define SIMD_NATIVE_CMP64 1
+#else
+#define SIMD_NATIVE_CMP64 0
+#endif
+#endif
+
+/**
+ * @brief Elementwise 64x64->64 multiply of int64_t or uint64_t lanes.
+ *
+ * @tparam T int64_t or uint64_t
+ * @return SIMD vector where each element is the low 64 bits of a.v[i] * b.v[i]
+ *
+ * Multiplies in uint64_t so signed lanes wrap instead of overflowing. With
+ * AVX-512DQ this is vpmullq; before it, GCC and Clang already lower the
+ * lane loop to lo*lo + ((lo*hi + hi*lo) << 32) with three pmuludq. Spelling
+ * those 32-bit partial products out by hand makes GCC 12 emit twice the
+ * instructions and run about three times slower on AVX2 (bench/bench_int64.c),
+ * so the plain product is kept.
+ */
+#define simd_apply_mul64(T, a, b) \
+({ \
+    simd_t(T) _m64_a = (a), _m64_b = (b); \
+    simd_for_lanes(T, i) { \
+        _m64_a.v[i] = (T)((uint64_t)_m64_a.v[i] * (uint64_t)_m64_b.v[i]); \
+    } \
+    _m64_a; \
+})
+
+/**
+ * @brief Per-lane all-ones/all-zeros result of a.v[i] < b.v[i] for 64-bit lanes.
+ *
+ * @tparam T int64_t or uint64_t
+ * @return simd_t(T) with lanes of -1 where a.v[i] < b.v[i], else 0
+ *
+ * Unsigned lanes are compared as signed after XOR with 2^63 unless
+ * SIMD_NATIVE_CMP64 is set. Lane masks feed the branch-free selects of
+ * simd_apply_min64 / simd_apply_max64.
+ */
+#define simd_apply_ltmask64(T, a, b) \
+({ \
+    simd_t(T) _lt_a = (a), _lt_b = (b); \
+    const uint64_t _lt_flip = simd_is_signed(T) || SIMD_NATIVE_CMP64 ? 0 : (uint64_t)1 << 63; \
+    simd_for_lanes_rolled(T, i) { \
+        int _lt_r = SIMD_NATIVE_CMP64 \
+            ? _lt_a.v[i] < _lt_b.v[i] \
+            : (int64_t)((uint64_t)_lt_a.v[i] ^ _lt_flip) < (int64_t)((uint64_t)_lt_b.v[i] ^ _lt_flip); \
+        _lt_a.v[i] = (T)-(int64_t)_lt_r; \
+    } \
+    _lt_a; \
+})
+
+/**
+ * @brief simd_mask_t of a.v[i] < b.v[i] for int64_t / uint64_t lanes.
+ *
+ * Packs the compare results straight into the mask, unrolled: going
+ * through the lane masks of simd_apply_ltmask64 left the bit gathering
+ * slower than a scalar loop at XLEN 256 and 512 (bench/bench_int64.c).
+ */
+#define simd_apply_cmplt64(T, a, b) \
+({ \
+    simd_t(T) _c64_a = (a), _c64_b = (b); \
+    const uint64_t _c64_flip = simd_is_signed(T) || SIMD_NATIVE_CMP64 ? 0 : (uint64_t)1 << 63; \
+    simd_mask_t _c64_r = 0; \
+    simd_for_lanes(T, i) { \
+        int _c64_lt = SIMD_NATIVE_CMP64 \
+            ? _c64_a.v[i] < _c64_b.v[i] \
+            : (int64_t)((uint64_t)_c64_a.v[i] ^ _c64_flip) < (int64_t)((uint64_t)_c64_b.v[i] ^ _c64_flip); \
+        _c64_r |= (simd_mask_t)_c64_lt << i; \
+    } \
+    _c64_r; \
+})
+
+/** @brief simd_mask_t of a.v[i] > b.v[i] for int64_t / uint64_t lanes. */
+#define simd_apply_cmpgt64(T, a, b) simd_apply_cmplt64(T, b, a)
+
+/**
+ * @brief Elementwise minimum of int64_t or uint64_t lanes.
+ *
+ * Selects with the lane mask, (a & m) | (b & ~m), rather than a ternary so
+ * the fallback compare stays a vector pcmpgtq plus logic ops.
+ */
+#define simd_apply_min64(T, a, b) \
+({ \
+    simd_t(T) _mn64_a = (a), _mn64_b = (b); \
+    simd_t(T) _mn64_m = simd_apply_ltmask64(T, _mn64_a, _mn64_b); \
+    simd_for_lanes_rolled(T, i) { \
+        _mn64_a.v[i] = (_mn64_a.v[i] & _mn64_m.v[i]) | (_mn64_b.v[i] & ~_mn64_m.v[i]); \
+    } \
+    _mn64_a; \
+})
+
+/** @brief Elementwise maximum of int64_t or uint64_t lanes. */
+#define simd_apply_max64(T, a, b) \
+({ \
+    simd_t(T) _mx64_a = (a), _mx64_b = (b); \
+    simd_t(T) _mx64_m = simd_apply_ltmask64(T, _mx64_a, _mx64_b); \
+    simd_for_lanes_rolled(T, i) { \
+        _mx64_a.v[i] = (_mx64_b.v[i] & _mx64_m.v[i]) | (_mx64_a.v[i] & ~_mx64_m.v[i]); \
+    } \
+    _mx64_a; \
+})
+
+/* -------------------------------------------------------------------------
+ * SIMD sorted-set operations
+ * ------------------------------------------------------------------------- */
+
+/**
+ * @brief Size ratio above which intersection switches to galloping search.
+ *
+ * When the longer list is more than this many times the shorter one,
+ * each element of the short list is searched in the long list instead of
+ * merging both block by block.
+ */
+#ifndef SIMD_INTERSECT_GALLOP_RATIO
+#define SIMD_INTERSECT_GALLOP_RATIO 32
+#endif
+
+/**
+ * @brief Define sorted-set search, intersection and union for type T.
+ *
+ * @tparam T Scalar type (typically uint32_t); requires decl_simd_t(T)
+ *
+ * Declares functions (inputs sorted ascending, without duplicates):
+ *   size_t lower_bound_simd_v{T}{XLEN}_t(const T *a, size_t n, T key)
+ *   size_t intersect_simd_v{T}{XLEN}_t(const T *a, size_t na,
+ *                                      const T *b, size_t nb, T *out)
+ *   size_t union_simd_v{T}{XLEN}_t(const T *a, size_t na,
+ *                                  const T *b, size_t nb, T *out)
+ *
+ * lower_bound narrows the range with a branch-free binary search and
+ * resolves the last VLEN(T) candidates with one block compare.
+ * intersect compares a VLEN(T) block of a against every key of a block
+ * of b and appends the matches without branching on them; it gallops
+ * through the longer list when the sizes differ by more than
+ * SIMD_INTERSECT_GALLOP_RATIO. The block step keeps its hits as a lane
+ * vector rather than going through simd_apply_cmpeq and simd_compress:
+ * packing a simd_mask_t per key and compressing it lane by lane, with a
+ * branch per selected lane, ran 3-10x slower (bench/bench_sorted_sets.c).
+ * union copies whole blocks that do not interleave with the other list.
+ *
+ * out must have room for min(na,nb) (intersect) or na+nb (union) elements.
+ * Functions return the number of elements in the result.
+ *
+ * Example:
+ *   decl_simd_set_ops(uint32_t)
+ *   size_t n = simd_intersect(uint32_t, a, na, b, nb, out);
+ */
+#define decl_simd_set_ops(T) \
+SIMD_FUNC size_t SIMD_CALLCONV simd_op_name(T,lower_bound) (const T *a, size_t n, T key) { \
+    const T *base = a; \
+    size_t len = n; \
+    while (len > VLEN(T)) { \
+        size_t half = len / 2; \
+        base = (base[half - 1] < key) ? base + half : base; \
+        len -= half; \
+    } \
+    const T *start = base; \
+    simd_t(T) blk; \
+    if ((size_t)(base - a) + VLEN(T) <= n) { \
+        blk = simd_load(T, base); \
+    } else if (n >= VLEN(T)) { \
+        start = a + n - VLEN(T); \
+        blk = simd_load(T, start); \
+    } else { \
+        start = a; \
+        blk = simd_splat(T, key); \
+        memcpy(&blk, a, n * sizeof(T)); \
+    } \
+    return (size_t)(start - a) + \
+        simd_mask_count(simd_apply_cmplt(T, blk, simd_splat(T, key))); \
+} \
+SIMD_FUNC size_t SIMD_CALLCONV \
+simd_op_name(T,intersect) (const T *a, size_t na, \
+                           const T *b, size_t nb, T *out) { \
+    if (na > nb) { \
+        const T *t = a; a = b; b = t; \
+        size_t tn = na; na = nb; nb = tn; \
+    } \
+    size_t count = 0, i = 0, j = 0; \
+    if (na * SIMD_INTERSECT_GALLOP_RATIO < nb) { \
+        for (; i < na && j < nb; i++) { \
+            T x = a[i]; \
+            size_t step = 1; \
+            while (j + step < nb && b[j + step] < x) { \
+                step *= 2; \
+            } \
+            size_t len = (step + 1 < nb - j) ? step + 1 : nb - j; \
+            j += simd_op_name(T,lower_bound)(b + j, len, x); \
+            if (j < nb) { \
+                out[count] = x; \
+                count += (b[j] == x); \
+            } \
+        } \
+        return count; \
+    } \
+    while (i + VLEN(T) <= na && j + VLEN(T) <= nb) { \
+        simd_t(T) va = simd_load(T, a + i), vb = simd_load(T, b + j), hit = simd_splat(T, 0); \
+        for (size_t l = 0; l < VLEN(T); l++) { \
+            simd_for_lanes(T, k) { \
+                hit.v[k] |= (T)(va.v[k] == vb.v[l]); \
+            } \
+        } \
+        simd_for_lanes(T, k) { \
+            out[count] = va.v[k]; \
+            count += (size_t)hit.v[k]; \
+        } \
+        T amax = a[i + VLEN(T) - 1], bmax = b[j + VLEN(T) - 1]; \
+        i += (amax <= bmax) ? VLEN(T) : 0; \
+        j += (bmax <= amax) ? VLEN(T) : 0; \
+    } \
+    while (i < na && j < nb) { \
+        T x = a[i], y = b[j]; \
+        out[count] = x; \
+        count += (x == y); \
+        i += (x <= y); \
+        j += (y <= x); \
+    } \
+    return count; \
+} \
+SIMD_FUNC size_t SIMD_CALLCONV \
+simd_op_name(T,union) (const T *a, size_t na, \
+                       const T *b, size_t nb, T *out) { \
+    size_t count = 0, i = 0, j = 0; \
+    while (i < na && j < nb) { \
+        if (i + VLEN(T) <= na && a[i + VLEN(T) - 1] < b[j]) { \
+            simd_store(T, out + count, simd_load(T, a + i)); \
+            i += VLEN(T); \
+            count += VLEN(T); \
+            continue; \
+        } \
+        if (j + VLEN(T) <= nb && b[j + VLEN(T) - 1] < a[i]) { \
+            simd_store(T, out + count, simd_load(T, b + j)); \
+            j += VLEN(T); \
+            count += VLEN(T); \
+            continue; \
+        } \
+        T x = a[i], y = b[j]; \
+        out[count++] = (x <= y) ? x : y; \
+        i += (x <= y); \
+        j += (y <= x); \
+    } \
+    memcpy(out + count, a + i, (na - i) * sizeof(T)); \
+    count += na - i; \
+    memcpy(out + count, b + j, (nb - j) * sizeof(T)); \
+    count += nb - j; \
+    return count; \
+}
+
+/**
+ * @brief Index of the first element of sorted array a not less than key.
+ *
+ * @tparam T Scalar type (requires decl_simd_set_ops(T))
+ * @param a Sorted array
+ * @param n Number of elements in a
+ * @param key Value to search
+ * @return Index in [0, n]
+ */
+#define simd_lower_bound(T, a, n, key) simd_op_name(T,lower_bound) (a, n, key)
+
+/**
+ * @brief Intersection of two sorted sets (requires decl_simd_set_ops(T)).
+ *
+ * @return Number of elements written to out
+ */
+#define simd_intersect(T, a, na, b, nb, out) \
+    simd_op_name(T,intersect) (a, na, b, nb, out)
+
+/**
+ * @brief Union of two sorted sets (requires decl_simd_set_ops(T)).
+ *
+ * @return Number of elements written to out
+ */
+#define simd_union(T, a, na, b, nb, out) \
+    simd_op_name(T,union) (a, na, b, nb, out)
+
+/* -------------------------------------------------------------------------
+ * SIMD integer compression codecs
+ * ------------------------------------------------------------------------- */
+
+/**
+ * @brief Number of values in one bit-packed block of type T.
+ *
+ * A block holds 8*sizeof(T) vectors; lane j of the packed words stores
+ * the values j, j+VLEN(T), j+2*VLEN(T), ... of the block.
+ */
+#define simd_bitpack_block_len(T) (8 * sizeof(T) * VLEN(T))
+
+/**
+ * @brief Number of T words produced by packing n values at a bit width.
+ *
+ * @tparam T Unsigned scalar type
+ * @param n Number of values
+ * @param bits Bit width (0..8*sizeof(T))
+ * @return Output size in elements of type T
+ */
+#define simd_bitpack_words(T, n, bits) \
+    (((n) + simd_bitpack_block_len(T) - 1) / simd_bitpack_block_len(T) * \
+     (size_t)(bits) * VLEN(T))
+
+/**
+ * @brief Define bit-packing, delta and frame-of-reference codecs for T.
+ *
+ * @tparam T Unsigned scalar type (typically uint32_t); requires decl_simd_t(T)
+ *
+ * Declares functions:
+ *   void   bitpack_block_simd_v{T}{XLEN}_t(const T *in, unsigned bits, T *out)
+ *   void   bitunpack_block_simd_v{T}{XLEN}_t(const T *in, unsigned bits, T *out)
+ *   size_t bitpack_simd_v{T}{XLEN}_t(const T *in, size_t n, unsigned bits, T *out)
+ *   void   bitunpack_simd_v{T}{XLEN}_t(const T *in, size_t n, unsigned bits, T *out)
+ *   unsigned max_bits_simd_v{T}{XLEN}_t(const T *in, size_t n)
+ *   void   delta_encode_simd_v{T}{XLEN}_t(const T *in, size_t n, T prev, T *out)
+ *   void   delta_decode_simd_v{T}{XLEN}_t(const T *in, size_t n, T prev, T *out)
+ *   void   delta2_encode_simd_v{T}{XLEN}_t(const T *in, size_t n, T *out)
+ *   void   delta2_decode_simd_v{T}{XLEN}_t(const T *in, size_t n, T *out)
+ *   T      for_encode_simd_v{T}{XLEN}_t(const T *in, size_t n, T *out)
+ *   void   for_decode_simd_v{T}{XLEN}_t(const T *in, size_t n, T ref, T *out)
+ *
+ * Bit-packing works on blocks of simd_bitpack_block_len(T) values with the
+ * same shift and mask applied to every lane; a partial last block is
+ * zero-padded. Delta decoding carries the running sum through each loaded
+ * block with one add per lane: on lane arrays that chain beats the
+ * log-step simd_prefix_sum, whose lane shifts the compiler keeps in
+ * memory (see bench/bench_codec.c). Delta and frame-of-reference
+ * functions may run in place (in == out). The bit-packing functions
+ * change the layout, so in and out must not overlap; their pointers are
+ * SIMD_RESTRICT.
+ *
+ * Example:
+ *   decl_simd_codec_ops(uint32_t)
+ *   T ref = simd_for_encode(uint32_t, ts, n, tmp);
+ *   unsigned b = simd_max_bits(uint32_t, tmp, n);
+ *   size_t words = simd_bitpack(uint32_t, tmp, n, b, packed);
+ */
+#define decl_simd_codec_ops(T) \
+SIMD_FUNC void SIMD_CALLCONV \
+simd_op_name(T,bitpack_block) (const T *SIMD_RESTRICT in, unsigned bits, T *SIMD_RESTRICT out) { \
+    const unsigned W = 8 * sizeof(T); \
+    const simd_t(T) mask = simd_splat(T, bits < W ? (T)(((T)1 << bits) - 1) : (T)~(T)0); \
+    simd_t(T) acc = simd_splat(T, 0); \
+    unsigned shift = 0; \
+    for (unsigned k = 0; k < W; k++) { \
+        simd_t(T) v = simd_apply_and(T, simd_load(T, in + k * VLEN(T)), mask); \
+        acc = simd_apply_or(T, acc, simd_apply_shl(T, v, shift)); \
+        shift += bits; \
+        if (shift >= W) { \
+            simd_store(T, out, acc); \
+            out += VLEN(T); \
+            shift -= W; \
+            acc = shift ? simd_apply_shr(T, v, bits - shift) : simd_splat(T, 0); \
+        } \
+    } \
+} \
+SIMD_FUNC void SIMD_CALLCONV \
+simd_op_name(T,bitunpack_block) (const T *SIMD_RESTRICT in, unsigned bits, T *SIMD_RESTRICT out) { \
+    const unsigned W = 8 * sizeof(T); \
+    const simd_t(T) mask = simd_splat(T, bits < W ? (T)(((T)1 << bits) - 1) : (T)~(T)0); \
+    simd_t(T) w = simd_load(T, in); \
+    unsigned shift = 0; \
+    for (unsigned k = 0; k < W; k++) { \
+        simd_t(T) v = simd_apply_shr(T, w, shift); \
+        shift += bits; \
+        if (shift >= W) { \
+            shift -= W; \
+            if (k + 1 < W) { \
+                in += VLEN(T); \
+                w = simd_load(T, in); \
+            } \
+            if (shift) { \
+                v = simd_apply_or(T, v, simd_apply_shl(T, w, bits - shift)); \
+            } \
+        } \
+        simd_store(T, out + k * VLEN(T), simd_apply_and(T, v, mask)); \
+    } \
+} \
+SIMD_FUNC size_t SIMD_CALLCONV \
+simd_op_name(T,bitpack) (const T *SIMD_RESTRICT in, size_t n, unsigned bits, \
+                         T *SIMD_RESTRICT out) { \
+    const size_t blk = simd_bitpack_block_len(T); \
+    size_t words = 0; \
+    if (bits == 0) { \
+        return 0; \
+    } \
+    for (size_t base = 0; base < n; base += blk) { \
+        T tmp[simd_bitpack_block_len(T)]; \
+        const T *src = in + base; \
+        if (n - base < blk) { \
+            memset(tmp, 0, sizeof(tmp)); \
+            memcpy(tmp, src, (n - base) * sizeof(T)); \
+            src = tmp; \
+        } \
+        simd_op_name(T,bitpack_block)(src, bits, out + words); \
+        words += bits * VLEN(T); \
+    } \
+    return words; \
+} \
+SIMD_FUNC void SIMD_CALLCONV \
+simd_op_name(T,bitunpack) (const T *SIMD_RESTRICT in, size_t n, unsigned bits, \
+                           T *SIMD_RESTRICT out) { \
+    const size_t blk = simd_bitpack_block_len(T); \
+    if (bits == 0) { \
+        memset(out, 0, n * sizeof(T)); \
+        return; \
+    } \
+    for (size_t base = 0; base < n; base += blk) { \
+        if (n - base < blk) { \
+            T tmp[simd_bitpack_block_len(T)]; \
+            simd_op_name(T,bitunpack_block)(in, bits, tmp); \
+            memcpy(out + base, tmp, (n - base) * sizeof(T)); \
+        } else { \
+            simd_op_name(T,bitunpack_block)(in, bits, out + base); \
+        } \
+        in += bits * VLEN(T); \
+    } \
+} \
+SIMD_FUNC unsigned SIMD_CALLCONV simd_op_name(T,max_bits) (const T *in, size_t n) { \
+    simd_t(T) acc = simd_splat(T, 0); \
+    size_t i = 0; \
+    for (; i + VLEN(T) <= n; i += VLEN(T)) { \
+        simd_t(T) v = simd_load(T, in + i); \
+        acc = simd_apply_or(T, acc, v); \
+    } \
+    T x = 0; \
+    simd_for_lanes(T, k) { \
+        x |= acc.v[k]; \
+    } \
+    for (; i < n; i++) { \
+        x |= in[i]; \
+    } \
+    return x ? 64 - (unsigned)__builtin_clzll((unsigned long long)x) : 0; \
+} \
+SIMD_FUNC void SIMD_CALLCONV \
+simd_op_name(T,delta_encode) (const T *in, size_t n, T prev, T *out) { \
+    size_t i = 0; \
+    for (; i + VLEN(T) <= n; i += VLEN(T)) { \
+        simd_t(T) v = simd_load(T, in + i); \
+        simd_t(T) p; \
+        p.v[0] = prev; \
+        for (size_t k = 1; k < VLEN(T); k++) { \
+            p.v[k] = v.v[k - 1]; \
+        } \
+        prev = v.v[VLEN(T) - 1]; \
+        simd_store(T, out + i, simd_apply_sub(T, v, p)); \
+    } \
+    for (; i < n; i++) { \
+        T x = in[i]; \
+        out[i] = (T)(x - prev); \
+        prev = x; \
+    } \
+} \
+SIMD_FUNC void SIMD_CALLCONV \
+simd_op_name(T,delta_decode) (const T *in, size_t n, T prev, T *out) { \
+    size_t i = 0; \
+    for (; i + VLEN(T) <= n; i += VLEN(T)) { \
+        simd_t(T) v = simd_load(T, in + i); \
+        simd_for_lanes(T, k) { \
+            prev = (T)(prev + v.v[k]); \
+            v.v[k] = prev; \
+        } \
+        simd_store(T, out + i, v); \
+    } \
+    for (; i < n; i++) { \
+        prev = (T)(prev + in[i]); \
+        out[i] = prev; \
+    } \
+} \
+SIMD_FUNC void SIMD_CALLCONV simd_op_name(T,delta2_encode) (const T *in, size_t n, T *out) { \
+    simd_op_name(T,delta_encode)(in, n, 0, out); \
+    simd_op_name(T,delta_encode)(out, n, 0, out); \
+} \
+SIMD_FUNC void SIMD_CALLCONV simd_op_name(T,delta2_decode) (const T *in, size_t n, T *out) { \
+    simd_op_name(T,delta_decode)(in, n, 0, out); \
+    simd_op_name(T,delta_decode)(out, n, 0, out); \
+} \
+SIMD_FUNC T SIMD_CALLCONV simd_op_name(T,for_encode) (const T *in, size_t n, T *out) { \
+    T ref = n ? in[0] : 0; \
+    size_t i = 0; \
+    if (n >= VLEN(T)) { \
+        simd_t(T) m = simd_load(T, in); \
+        for (i = VLEN(T); i + VLEN(T) <= n; i += VLEN(T)) { \
+            simd_t(T) v = simd_load(T, in + i); \
+            simd_for_lanes(T, k) { \
+                m.v[k] = v.v[k] < m.v[k] ? v.v[k] : m.v[k]; \
+            } \
+        } \
+        simd_for_lanes(T, k) { \
+            ref = m.v[k] < ref ? m.v[k] : ref; \
+        } \
+    } \
+    for (; i < n; i++) { \
+        ref = in[i] < ref ? in[i] : ref; \
+    } \
+    simd_t(T) r = simd_splat(T, ref); \
+    for (i = 0; i + VLEN(T) <= n; i += VLEN(T)) { \
+        simd_t(T) v = simd_load(T, in + i); \
+        simd_store(T, out + i, simd_apply_sub(T, v, r)); \
+    } \
+    for (; i < n; i++) { \
+        out[i] = (T)(in[i] - ref); \
+    } \
+    return ref; \
+} \
+SIMD_FUNC void SIMD_CALLCONV simd_op_name(T,for_decode) (const T *in, size_t n, T ref, T *out) { \
+    simd_t(T) r = simd_splat(T, ref); \
+    size_t i = 0; \
+    for (; i + VLEN(T) <= n; i += VLEN(T)) { \
+        simd_t(T) v = simd_load(T, in + i); \
+        simd_store(T, out + i, simd_apply_add(T, v, r)); \
+    } \
+    for (; i < n; i++) { \
+        out[i] = (T)(in[i] + ref); \
+    } \
+}
+
+/**
+ * @brief Bit-pack n values at a fixed bit width (requires decl_simd_codec_ops(T)).
+ *
+ * @return Number of T words written (simd_bitpack_words(T, n, bits))
+ */
+#define simd_bitpack(T, in, n, bits, out) simd_op_name(T,bitpack) (in, n, bits, out)
+
+/** @brief Unpack n values written by simd_bitpack. */
+#define simd_bitunpack(T, in, n, bits, out) simd_op_name(T,bitunpack) (in, n, bits, out)
+
+/** @brief Smallest bit width able to hold every value of in[0..n). */
+#define simd_max_bits(T, in, n) simd_op_name(T,max_bits) (in, n)
+
+/** @brief out[i] = in[i] - in[i-1], with in[-1] = prev. */
+#define simd_delta_encode(T, in, n, prev, out) simd_op_name(T,delta_encode) (in, n, prev, out)
+
+/** @brief Inverse of simd_delta_encode (prefix sum starting at prev). */
+#define simd_delta_decode(T, in, n, prev, out) simd_op_name(T,delta_decode) (in, n, prev, out)
+
+/** @brief Delta-of-delta encoding (delta applied twice, starting at 0). */
+#define simd_delta2_encode(T, in, n, out) simd_op_name(T,delta2_encode) (in, n, out)
+
+/** @brief Inverse of simd_delta2_encode. */
+#define simd_delta2_decode(T, in, n, out) simd_op_name(T,delta2_decode) (in, n, out)
+
+/** @brief Frame-of-reference: out[i] = in[i] - min(in); returns min(in). */
+#define simd_for_encode(T, in, n, out) simd_op_name(T,for_encode) (in, n, out)
+
+/** @brief Inverse of simd_for_encode: out[i] = in[i] + ref. */
+#define simd_for_decode(T, in, n, ref, out) simd_op_name(T,for_decode) (in, n, ref, out)
+
+/* -------------------------------------------------------------------------
+ * SIMD columnar filter and aggregate
+ * ------------------------------------------------------------------------- */
+
+/**
+ * @brief Comparison applied by a column predicate.
+ */
+typedef enum simd_cmp_op {
+    SIMD_CMP_EQ, /**< col == value */
+    SIMD_CMP_NE, /**< col != value */
+    SIMD_CMP_LT, /**< col <  value */
+    SIMD_CMP_LE, /**< col <= value */
+    SIMD_CMP_GT, /**< col >  value */
+    SIMD_CMP_GE  /**< col >= value */
+} simd_cmp_op;
+
+/**
+ * @brief Rows processed per cache block by the query kernels.
+ *
+ * Must be a multiple of 64. The default keeps one block of a few
+ * 32-bit columns resident in L1/L2 between the filter and aggregate steps.
+ */
+#ifndef SIMD_QUERY_BLOCK
+#define SIMD_QUERY_BLOCK 4096
+#endif
+
+/**
+ * @brief Name of the column predicate type for element type T.
+ *
+ * Example:
+ *   simd_pred_t(float) → simd_pred_float_t
+ */
+#define simd_pred_t(T) PPCAT(simd_pred_,PPCAT(T,_t))
+
+/**
+ * @brief Name of the aggregate result type for element type T.
+ *
+ * Example:
+ *   simd_agg_t(float) → simd_agg_float_t
+ */
+#define simd_agg_t(T) PPCAT(simd_agg_,PPCAT(T,_t))
+
+/**
+ * @brief Accumulator type of sums over elements of type T.
+ *
+ * float sums accumulate in double; integer sums in a 64-bit type
+ * (int64_t, or uint64_t for uint64_t elements) so they cannot wrap
+ * where the column type would; double stays double.
+ *
+ * Example:
+ *   simd_acc_of(int16_t) → int64_t, simd_acc_of(float) → double
+ */
+#ifdef __cplusplus
+template <typename T> struct simd_acc_of_type { typedef __typeof__((T)0 + (int64_t)0) type; };
+template <> struct simd_acc_of_type<float> { typedef double type; };
+#define simd_acc_of(T) simd_acc_of_type<T>::type
+#else
+#define simd_acc_of(T) \
+    __typeof__(_Generic((T)0, float: (double)0, default: (T)0 + (int64_t)0))
+#endif
+
+/**
+ * @brief Compare up to 64 consecutive column values against a key.
+ *
+ * @tparam T Scalar type
+ * @param p Pointer to the first value
+ * @param rows Number of values (1..64)
+ * @param key Scalar compared against every value
+ * @param op Comparison operator (==, !=, <, <=, >, >=)
+ * @return 64-bit word with bit r set when (p[r] op key)
+ *
+ * A full word compares into one byte per row, then packs eight bytes per
+ * multiply by 0x0102040810204080, which vectorizes where building the
+ * mask a lane at a time does not. The eight bytes are read as one
+ * little-endian word (byte-swapped on SIMD_BIG_ENDIAN targets), so row r
+ * lands in bit r whatever the byte order.
+ */
+#define simd_cmp_word(T, p, rows, key, op) \
+({ \
+    const T *_cw_p = (p); \
+    size_t _cw_r = (rows); \
+    simd_t(T) _cw_k = simd_splat(T, key); \
+    uint64_t _cw_w = 0; \
+    if (_cw_r == 64) { \
+        uint8_t _cw_b[64]; \
+        for (size_t _cw_c = 0; _cw_c < 64; _cw_c++) { \
+            _cw_b[_cw_c] = (uint8_t)(_cw_p[_cw_c] op _cw_k.v[0]); \
+        } \
+        for (size_t _cw_c = 0; _cw_c < 64; _cw_c += 8) { \
+            uint64_t _cw_u; \
+            memcpy(&_cw_u, _cw_b + _cw_c, 8); \
+            if (SIMD_BIG_ENDIAN) { \
+                _cw_u = __builtin_bswap64(_cw_u); \
+            } \
+            _cw_w |= (_cw_u * 0x0102040810204080ULL) >> 56 << _cw_c; \
+        } \
+    } else { \
+        for (size_t _cw_c = 0; _cw_c < _cw_r; _cw_c++) { \
+            _cw_w |= (uint64_t)(_cw_p[_cw_c] op _cw_k.v[0]) << _cw_c; \
+        } \
+    } \
+    _cw_w; \
+})
+
+/**
+ * @brief AND a predicate over rows [0, rows) into a selection bitmap.
+ *
+ * Words that are already zero are skipped, so later predicates of a
+ * conjunction only touch rows still selected.
+ */
+#define simd_filter_words(T, col, rows, key, op, words) \
+({ \
+    for (size_t _fw_wi = 0; _fw_wi * 64 < (rows); _fw_wi++) { \
+        if ((words)[_fw_wi]) { \
+            size_t _fw_n = (rows) - _fw_wi * 64; \
+            (words)[_fw_wi] &= simd_cmp_word(T, (col) + _fw_wi * 64, _fw_n < 64 ? _fw_n : 64, key, op); \
+        } \
+    } \
+    (void)0; \
+})
+
+/**
+ * @brief Define the predicate/aggregate types and query kernels for T.
+ *
+ * @tparam T Scalar type of the columns; requires decl_simd_t(T)
+ *
+ * Declares types:
+ *   simd_pred_t(T) { const T *col; simd_cmp_op op; T value; }
+ *   simd_agg_t(T)  { simd_acc_of(T) sum; T min; T max; size_t count; }
+ *
+ * Declares functions:
+ *   size_t filter_simd_v{T}{XLEN}_t(const simd_pred_t(T) *preds, size_t npred,
+ *                                   size_t n, uint64_t *bitmap)
+ *   simd_agg_t(T) aggregate_simd_v{T}{XLEN}_t(const T *x, const uint64_t *bitmap,
+ *                                             size_t n)
+ *   simd_agg_t(T) filter_aggregate_simd_v{T}{XLEN}_t(const simd_pred_t(T) *preds,
+ *                                                    size_t npred, const T *x,
+ *                                                    size_t n, uint64_t *bitmap)
+ *
+ * Predicates are combined with AND into a selection bitmap of
+ * (n + 63) / 64 words (bit r of word w selects row 64*w + r). filter
+ * returns the number of selected rows. filter_aggregate evaluates the
+ * predicates and the sum/min/max/count of x in one pass, one
+ * SIMD_QUERY_BLOCK of rows at a time; its bitmap argument may be NULL.
+ * Sums accumulate per lane in simd_acc_of(T), so 8-, 16- and 32-bit
+ * columns do not overflow. min/max are 0 when no row is selected.
+ *
+ * Example:
+ *   decl_simd_query_ops(int32_t)
+ *   simd_pred_t(int32_t) p[2] = {{y, SIMD_CMP_GT, c}, {z, SIMD_CMP_EQ, k}};
+ *   simd_agg_t(int32_t) r = simd_filter_aggregate(int32_t, p, 2, x, n, NULL);
+ */
+#define decl_simd_query_ops(T) \
+typedef struct simd_pred_t(T) { \
+    const T *col; \
+    simd_cmp_op op; \
+    T value; \
+} simd_pred_t(T); \
+typedef struct simd_agg_t(T) { \
+    simd_acc_of(T) sum; \
+    T min; \
+    T max; \
+    size_t count; \
+} simd_agg_t(T); \
+SIMD_FUNC void SIMD_CALLCONV \
+simd_op_name(T,filter_block) (const simd_pred_t(T) *preds, size_t npred, \
+                              size_t row0, size_t rows, uint64_t *words) { \
+    for (size_t w = 0; w * 64 < rows; w++) { \
+        size_t r = rows - w * 64; \
+        words[w] = r >= 64 ? ~(uint64_t)0 : (((uint64_t)1 << r) - 1); \
+    } \
+    for (size_t p = 0; p < npred; p++) { \
+        const T *col = preds[p].col + row0; \
+        T key = preds[p].value; \
+        switch (preds[p].op) { \
+        case SIMD_CMP_EQ: simd_filter_words(T, col, rows, key, ==, words); break; \
+        case SIMD_CMP_NE: simd_filter_words(T, col, rows, key, !=, words); break; \
+        case SIMD_CMP_LT: simd_filter_words(T, col, rows, key, <, words); break; \
+        case SIMD_CMP_LE: simd_filter_words(T, col, rows, key, <=, words); break; \
+        case SIMD_CMP_GT: simd_filter_words(T, col, rows, key, >, words); break; \
+        case SIMD_CMP_GE: simd_filter_words(T, col, rows, key, >=, words); break; \
+        } \
+    } \
+} \
+SIMD_FUNC void SIMD_CALLCONV \
+simd_op_name(T,aggregate_block) (const T *x, const uint64_t *words, size_t rows, \
+                                 simd_acc_of(T) *sum, simd_t(T) *min, simd_t(T) *max, \
+                                 size_t *count) { \
+    for (size_t w = 0; w * 64 < rows; w++) { \
+        uint64_t word = words[w]; \
+        if (!word) { \
+            continue; \
+        } \
+        if (*count == 0) { \
+            T first = x[w * 64 + (size_t)__builtin_ctzll(word)]; \
+            *min = simd_splat(T, first); \
+            *max = *min; \
+        } \
+        *count += (size_t)__builtin_popcountll(word); \
+        size_t r = rows - w * 64; \
+        if (r >= 64) { \
+            for (size_t c = 0; c < 64; c += VLEN(T)) { \
+                simd_mask_t m = word >> c; \
+                if (!(m & ((simd_mask_t)~(uint64_t)0 >> (64 - VLEN(T))))) { \
+                    continue; \
+                } \
+                simd_t(T) v = simd_load(T, x + w * 64 + c); \
+                simd_for_lanes(T, k) { \
+                    int sel = (m >> k) & 1; \
+                    sum[k] += sel ? v.v[k] : (T)0; \
+                    min->v[k] = (sel && v.v[k] < min->v[k]) ? v.v[k] : min->v[k]; \
+                    max->v[k] = (sel && v.v[k] > max->v[k]) ? v.v[k] : max->v[k]; \
+                } \
+            } \
+        } else { \
+            for (size_t k = 0; k < r; k++) { \
+                if ((word >> k) & 1) { \
+                    T v = x[w * 64 + k]; \
+                    sum[0] += v; \
+                    min->v[0] = v < min->v[0] ? v : min->v[0]; \
+                    max->v[0] = v > max->v[0] ? v : max->v[0]; \
+                } \
+            } \
+        } \
+    } \
+} \
+SIMD_FUNC simd_agg_t(T) SIMD_CALLCONV \
+simd_op_name(T,aggregate_finish) (const simd_acc_of(T) *sum, simd_t(T) min, \
+                                  simd_t(T) max, size_t count) { \
+    simd_agg_t(T) r = { 0, 0, 0, count }; \
+    simd_for_lanes(T, k) { \
+        r.sum += sum[k]; \
+    } \
+    if (count) { \
+        r.min = min.v[0]; \
+        r.max = max.v[0]; \
+        for (size_t k = 1; k < VLEN(T); k++) { \
+            r.min = min.v[k] < r.min ? min.v[k] : r.min; \
+            r.max = max.v[k] > r.max ? max.v[k] : r.max; \
+        } \
+    } \
+    return r; \
+} \
+SIMD_FUNC size_t SIMD_CALLCONV \
+simd_op_name(T,filter) (const simd_pred_t(T) *preds, size_t npred, \
+                        size_t n, uint64_t *bitmap) { \
+    size_t count = 0; \
+    for (size_t row0 = 0; row0 < n; row0 += SIMD_QUERY_BLOCK) { \
+        size_t rows = n - row0 < SIMD_QUERY_BLOCK ? n - row0 : SIMD_QUERY_BLOCK; \
+        uint64_t *words = bitmap + row0 / 64; \
+        simd_op_name(T,filter_block)(preds, npred, row0, rows, words); \
+        for (size_t w = 0; w * 64 < rows; w++) { \
+            count += (size_t)__builtin_popcountll(words[w]); \
+        } \
+    } \
+    return count; \
+} \
+SIMD_FUNC simd_agg_t(T) SIMD_CALLCONV \
+simd_op_name(T,aggregate) (const T *x, const uint64_t *bitmap, size_t n) { \
+    simd_acc_of(T) sum[VLEN(T)] = { 0 }; \
+    simd_t(T) min = simd_splat(T, 0), max = min; \
+    size_t count = 0; \
+    simd_op_name(T,aggregate_block)(x, bitmap, n, sum, &min, &max, &count); \
+    return simd_op_name(T,aggregate_finish)(sum, min, max, count); \
+} \
+SIMD_FUNC simd_agg_t(T) SIMD_CALLCONV \
+simd_op_name(T,filter_aggregate) (const simd_pred_t(T) *preds, size_t npred, \
+                                  const T *x, size_t n, uint64_t *bitmap) { \
+    simd_acc_of(T) sum[VLEN(T)] = { 0 }; \
+    simd_t(T) min = simd_splat(T, 0), max = min; \
+    size_t count = 0; \
+    uint64_t local[SIMD_QUERY_BLOCK / 64]; \
+    for (size_t row0 = 0; row0 < n; row0 += SIMD_QUERY_BLOCK) { \
+        size_t rows = n - row0 < SIMD_QUERY_BLOCK ? n - row0 : SIMD_QUERY_BLOCK; \
+        uint64_t *words = bitmap ? bitmap + row0 / 64 : local; \
+        simd_op_name(T,filter_block)(preds, npred, row0, rows, words); \
+        simd_op_name(T,aggregate_block)(x + row0, words, rows, sum, &min, &max, &count); \
+    } \
+    return simd_op_name(T,aggregate_finish)(sum, min, max, count); \
+}
+
+/**
+ * @brief Build a selection bitmap from ANDed predicates (requires decl_simd_query_ops(T)).
+ *
+ * @return Number of selected rows
+ */
+#define simd_filter(T, preds, npred, n, bitmap) \
+    simd_op_name(T,filter) (preds, npred, n, bitmap)
+
+/** @brief sum/min/max/count of x over the rows selected by bitmap. */
+#define simd_aggregate(T, x, bitmap, n) \
+    simd_op_name(T,aggregate) (x, bitmap, n)
+
+/** @brief Fused, cache-blocked filter and aggregate; bitmap may be NULL. */
+#define simd_filter_aggregate(T, preds, npred, x, n, bitmap) \
+    simd_op_name(T,filter_aggregate) (preds, npred, x, n, bitmap)
+
+/* -------------------------------------------------------------------------
+ * SIMD bitmap operations
+ * ------------------------------------------------------------------------- */
+
+/**
+ * @brief Population count of every lane of a SIMD vector.
+ *
+ * @tparam T Unsigned integer type (8 to 64 bits)
+ * @param a SIMD vector
+ * @return SIMD vector where each element is the number of bits set in a.v[i]
+ *
+ * Uses the shift/mask/multiply (SWAR) formulation so the loop vectorizes
+ * on targets without a vector popcount instruction.
+ */
+#define simd_apply_popcnt(T, a) \
+({ \
+    simd_t(T) _pc_a = (a); \
+    simd_t(T) _pc_c; \
+    simd_for_lanes_rolled(T, i) { \
+        T _pc_x = _pc_a.v[i]; \
+        _pc_x = (T)(_pc_x - ((_pc_x >> 1) & (T)0x5555555555555555ULL)); \
+        _pc_x = (T)((_pc_x & (T)0x3333333333333333ULL) + \
+                    ((_pc_x >> 2) & (T)0x3333333333333333ULL)); \
+        _pc_x = (T)((_pc_x + (_pc_x >> 4)) & (T)0x0f0f0f0f0f0f0f0fULL); \
+        _pc_c.v[i] = (T)((T)(_pc_x * (T)0x0101010101010101ULL) >> (8 * sizeof(T) - 8)); \
+    } \
+    _pc_c; \
+})
+
+/**
+ * @brief Carry-save adder over three SIMD vectors (bitwise full adder).
+ *
+ * @tparam T Unsigned integer type
+ * @param h Output vector receiving the carry bits (lvalue)
+ * @param l Output vector receiving the sum bits (lvalue)
+ * @param a, b, c Input vectors (may alias h or l)
+ */
+#define simd_csa(T, h, l, a, b, c) \
+({ \
+    simd_t(T) _cs_a = (a), _cs_b = (b), _cs_c = (c); \
+    simd_for_lanes(T, i) { \
+        T _cs_u = _cs_a.v[i] ^ _cs_b.v[i]; \
+        (h).v[i] = (_cs_a.v[i] & _cs_b.v[i]) | (_cs_u & _cs_c.v[i]); \
+        (l).v[i] = _cs_u ^ _cs_c.v[i]; \
+    } \
+    (void)0; \
+})
+
+/**
+ * @brief Define array-level bitmap kernels for unsigned word type T.
+ *
+ * @tparam T Unsigned integer word type (typically uint64_t); requires decl_simd_t(T)
+ *
+ * Declares functions over bitmaps of n words:
+ *   int      bitmap_and_simd_v{T}{XLEN}_t(T *dst, const T *a, const T *b, size_t n)
+ *   int      bitmap_or_simd_v{T}{XLEN}_t(T *dst, const T *a, const T *b, size_t n)
+ *   int      bitmap_xor_simd_v{T}{XLEN}_t(T *dst, const T *a, const T *b, size_t n)
+ *   int      bitmap_andnot_simd_v{T}{XLEN}_t(T *dst, const T *a, const T *b, size_t n)
+ *   uint64_t popcount_array_simd_v{T}{XLEN}_t(const T *a, size_t n)
+ *   size_t   bitmap_to_indices_simd_v{T}{XLEN}_t(const T *a, size_t n, uint32_t *out)
+ *
+ * andnot computes a & ~b. popcount_array uses a Harley-Seal carry-save
+ * adder tree over 16 vectors at a time when the target has no popcount
+ * instruction, and one popcount per lane when it has POPCNT or AVX-512
+ * VPOPCNTDQ (the adder tree is slower than popcnt once GCC scalarizes it
+ * for AVX2; see bench/bench_bitmap.c). bitmap_to_indices writes the
+ * position of every set bit (bit r of word w is index w*8*sizeof(T) + r)
+ * and returns how many were written; out needs room for the cardinality.
+ * Bit-wise kernels accept any overlap of dst with a or b and return 0,
+ * or -1 with errno set to ENOMEM in the one overlap that needs scratch
+ * memory; each also has a name##_noalias form with SIMD_RESTRICT
+ * pointers (see decl_simd_array_binop).
+ *
+ * Example:
+ *   decl_simd_bitmap_ops(uint64_t)
+ *   simd_bitmap_and(uint64_t, sel, sel_y, sel_z, words);
+ *   uint64_t rows = simd_popcount_array(uint64_t, sel, words);
+ */
+#define decl_simd_bitmap_ops(T) \
+decl_simd_bitmap_binop(T, bitmap_and, x & y) \
+decl_simd_bitmap_binop(T, bitmap_or, x | y) \
+decl_simd_bitmap_binop(T, bitmap_xor, x ^ y) \
+decl_simd_bitmap_binop(T, bitmap_andnot, x & (T)~y) \
+SIMD_FUNC uint64_t SIMD_CALLCONV simd_op_name(T,popcount_array) (const T *a, size_t n) { \
+    uint64_t total = 0; \
+    size_t i = 0; \
+    simd_popcount_array_body(T, a, n, i, total); \
+    for (; i < n; i++) { \
+        total += (uint64_t)__builtin_popcountll((unsigned long long)a[i]); \
+    } \
+    return total; \
+} \
+SIMD_FUNC size_t SIMD_CALLCONV \
+simd_op_name(T,bitmap_to_indices) (const T *a, size_t n, uint32_t *out) { \
+    const uint32_t W = 8 * sizeof(T); \
+    size_t count = 0, w = 0; \
+    for (; w + VLEN(T) <= n; w += VLEN(T)) { \
+        simd_t(T) v = simd_load(T, a + w); \
+        T any = 0; \
+        simd_for_lanes(T, k) { \
+            any |= v.v[k]; \
+        } \
+        if (!any) { \
+            continue; \
+        } \
+        simd_for_lanes(T, k) { \
+            unsigned long long word = v.v[k]; \
+            uint32_t base = (uint32_t)(w + k) * W; \
+            while (word) { \
+                out[count++] = base + (uint32_t)__builtin_ctzll(word); \
+                word &= word - 1; \
+            } \
+        } \
+    } \
+    for (; w < n; w++) { \
+        unsigned long long word = a[w]; \
+        uint32_t base = (uint32_t)w * W; \
+        while (word) { \
+            out[count++] = base + (uint32_t)__builtin_ctzll(word); \
+            word &= word - 1; \
+        } \
+    } \
+    return count; \
+}
+
+/**
+ * @brief Define one bitmap kernel dst[i] = expr(x = a[i], y = b[i]).
+ *
+ * Helper of decl_simd_bitmap_ops; the expression uses the scalar names x and y.
+ * Shares decl_simd_array_binop, so every kernel also gets a _noalias form.
+ */
+#define decl_simd_bitmap_binop(T, name, expr) decl_simd_array_binop(T, name, expr)
+
+/**
+ * @brief Main loop of popcount_array: counts whole vectors of a, advancing i.
+ *
+ * Helper of decl_simd_bitmap_ops. Leaves the final n - i words to the caller.
+ */
+#if defined(__AVX512VPOPCNTDQ__) || defined(__POPCNT__)
+#define simd_popcount_array_body(T, a, n, i, total) \
+({ \
+    uint64_t _hs_acc[VLEN(T)] = {0}; \
+    for (; (i) + VLEN(T) <= (n); (i) += VLEN(T)) { \
+        simd_t(T) _hs_v = simd_load(T, (a) + (i)); \
+        simd_for_lanes(T, _hs_k) { \
+            _hs_acc[_hs_k] += (uint64_t)__builtin_popcountll((unsigned long long)_hs_v.v[_hs_k]); \
+        } \
+    } \
+    simd_for_lanes(T, _hs_k) { \
+        (total) += _hs_acc[_hs_k]; \
+    } \
+    (void)0; \
+})
+#else
+#define simd_popcount_array_body(T, a, n, i, total) \
+({ \
+    simd_t(T) _hs_z = simd_splat(T, 0); \
+    simd_t(T) _hs_ones = _hs_z, _hs_twos = _hs_z, _hs_fours = _hs_z, _hs_eights = _hs_z, _hs_sixteens; \
+    simd_t(T) _hs_twosA, _hs_twosB, _hs_foursA, _hs_foursB, _hs_eightsA, _hs_eightsB; \
+    uint64_t _hs_sum = 0; \
+    for (; (i) + 16 * VLEN(T) <= (n); (i) += 16 * VLEN(T)) { \
+        const T *_hs_p = (a) + (i); \
+        simd_csa(T, _hs_twosA, _hs_ones, _hs_ones, simd_load(T, _hs_p + 0 * VLEN(T)), simd_load(T, _hs_p + 1 * VLEN(T))); \
+        simd_csa(T, _hs_twosB, _hs_ones, _hs_ones, simd_load(T, _hs_p + 2 * VLEN(T)), simd_load(T, _hs_p + 3 * VLEN(T))); \
+        simd_csa(T, _hs_foursA, _hs_twos, _hs_twos, _hs_twosA, _hs_twosB); \
+        simd_csa(T, _hs_twosA, _hs_ones, _hs_ones, simd_load(T, _hs_p + 4 * VLEN(T)), simd_load(T, _hs_p + 5 * VLEN(T))); \
+        simd_csa(T, _hs_twosB, _hs_ones, _hs_ones, simd_load(T, _hs_p + 6 * VLEN(T)), simd_load(T, _hs_p + 7 * VLEN(T))); \
+        simd_csa(T, _hs_foursB, _hs_twos, _hs_twos, _hs_twosA, _hs_twosB); \
+        simd_csa(T, _hs_eightsA, _hs_fours, _hs_fours, _hs_foursA, _hs_foursB); \
+        simd_csa(T, _hs_twosA, _hs_ones, _hs_ones, simd_load(T, _hs_p + 8 * VLEN(T)), simd_load(T, _hs_p + 9 * VLEN(T))); \
+        simd_csa(T, _hs_twosB, _hs_ones, _hs_ones, simd_load(T, _hs_p + 10 * VLEN(T)), simd_load(T, _hs_p + 11 * VLEN(T))); \
+        simd_csa(T, _hs_foursA, _hs_twos, _hs_twos, _hs_twosA, _hs_twosB); \
+        simd_csa(T, _hs_twosA, _hs_ones, _hs_ones, simd_load(T, _hs_p + 12 * VLEN(T)), simd_load(T, _hs_p + 13 * VLEN(T))); \
+        simd_csa(T, _hs_twosB, _hs_ones, _hs_ones, simd_load(T, _hs_p + 14 * VLEN(T)), simd_load(T, _hs_p + 15 * VLEN(T))); \
+        simd_csa(T, _hs_foursB, _hs_twos, _hs_twos, _hs_twosA, _hs_twosB); \
+        simd_csa(T, _hs_eightsB, _hs_fours, _hs_fours, _hs_foursA, _hs_foursB); \
+        simd_csa(T, _hs_sixteens, _hs_eights, _hs_eights, _hs_eightsA, _hs_eightsB); \
+        simd_t(T) _hs_c = simd_apply_popcnt(T, _hs_sixteens); \
+        simd_for_lanes(T, _hs_k) { \
+            _hs_sum += _hs_c.v[_hs_k]; \
+        } \
+    } \
+    _hs_sum *= 16; \
+    simd_t(T) _hs_c8 = simd_apply_popcnt(T, _hs_eights), _hs_c4 = simd_apply_popcnt(T, _hs_fours); \
+    simd_t(T) _hs_c2 = simd_apply_popcnt(T, _hs_twos), _hs_c1 = simd_apply_popcnt(T, _hs_ones); \
+    simd_for_lanes(T, _hs_k) { \
+        _hs_sum += 8 * (uint64_t)_hs_c8.v[_hs_k] + 4 * (uint64_t)_hs_c4.v[_hs_k] + \
+                   2 * (uint64_t)_hs_c2.v[_hs_k] + (uint64_t)_hs_c1.v[_hs_k]; \
+    } \
+    (total) += _hs_sum; \
+    (void)0; \
+})
+#endif
+
+/** @brief dst = a & b over n words (requires decl_simd_bitmap_ops(T)). */
+#define simd_bitmap_and(T, dst, a, b, n) simd_op_name(T,bitmap_and) (dst, a, b, n)
+
+/** @brief dst = a | b over n words. */
+#define simd_bitmap_or(T, dst, a, b, n) simd_op_name(T,bitmap_or) (dst, a, b, n)
+
+/** @brief dst = a ^ b over n words. */
+#define simd_bitmap_xor(T, dst, a, b, n) simd_op_name(T,bitmap_xor) (dst, a, b, n)
+
+/** @brief dst = a & ~b over n words. */
+#define simd_bitmap_andnot(T, dst, a, b, n) simd_op_name(T,bitmap_andnot) (dst, a, b, n)
+
+/** @brief No-alias form of a bitmap kernel: simd_bitmap_noalias(T, and, dst, a, b, n). */
+#define simd_bitmap_noalias(T, op, ...) simd_op_name(T,bitmap_##op##_noalias) (__VA_ARGS__)
+
+/** @brief Total number of bits set in a[0..n). */
+#define simd_popcount_array(T, a, n) simd_op_name(T,popcount_array) (a, n)
+
+/** @brief Positions of the set bits of a[0..n); returns how many were written. */
+#define simd_bitmap_to_indices(T, a, n, out) simd_op_name(T,bitmap_to_indices) (a, n, out)
+
+/* -------------------------------------------------------------------------
+ * SIMD distance and similarity kernels
+ * ------------------------------------------------------------------------- */
+
+/**
+ * @brief Define array-level distance kernels for element type T.
+ *
+ * @tparam T Element type (float, double, _Float16, int8_t, ...); requires decl_simd_t(T)
+ * @tparam A Accumulator type (e.g. float for float/_Float16, int32_t for int8_t)
+ *
+ * Declares functions over vectors of dim elements:
+ *   A      l2sq_simd_v{T}{XLEN}_t(const T *a, const T *b, size_t dim)
+ *   A      inner_product_simd_v{T}{XLEN}_t(const T *a, const T *b, size_t dim)
+ *   double cosine_simd_v{T}{XLEN}_t(const T *a, const T *b, size_t dim)
+ * and one-to-many variants comparing q against count vectors stored
+ * back to back in base (row i at base + i*dim):
+ *   void l2sq_batch_simd_v{T}{XLEN}_t(const T *q, const T *base, size_t count,
+ *                                     size_t dim, A *out)
+ *   void inner_product_batch_simd_v{T}{XLEN}_t(..., A *out)
+ *   void cosine_batch_simd_v{T}{XLEN}_t(..., double *out)
+ *
+ * Each lane keeps its own A accumulator, so narrow inputs are widened
+ * before multiplying. cosine returns the cosine similarity, or 0 when
+ * either vector is all zeros. _Float16 needs a compiler that defines
+ * __FLT16_MANT_DIG__ (GCC 12+ and Clang on x86-64 and AArch64).
+ *
+ * Example:
+ *   decl_simd_distance_ops(int8_t, int32_t)
+ *   int32_t d = simd_l2sq(int8_t, a, b, 128);
+ *
+ *   #ifdef __FLT16_MANT_DIG__
+ *   decl_simd_t(_Float16)
+ *   decl_simd_distance_ops(_Float16, float)
+ *   #endif
+ */
+#define decl_simd_distance_ops(T, A) \
+SIMD_FUNC A SIMD_CALLCONV simd_op_name(T,l2sq) (const T *a, const T *b, size_t dim) { \
+    A acc[VLEN(T)] = {0}; \
+    size_t i = 0; \
+    for (; i + VLEN(T) <= dim; i += VLEN(T)) { \
+        simd_t(T) va = simd_load(T, a + i), vb = simd_load(T, b + i); \
+        simd_for_lanes(T, k) { \
+            A d = (A)va.v[k] - (A)vb.v[k]; \
+            acc[k] += d * d; \
+        } \
+    } \
+    A r = 0; \
+    simd_for_lanes(T, k) { \
+        r += acc[k]; \
+    } \
+    for (; i < dim; i++) { \
+        A d = (A)a[i] - (A)b[i]; \
+        r += d * d; \
+    } \
+    return r; \
+} \
+SIMD_FUNC A SIMD_CALLCONV simd_op_name(T,inner_product) (const T *a, const T *b, size_t dim) { \
+    A acc[VLEN(T)] = {0}; \
+    size_t i = 0; \
+    for (; i + VLEN(T) <= dim; i += VLEN(T)) { \
+        simd_t(T) va = simd_load(T, a + i), vb = simd_load(T, b + i); \
+        simd_for_lanes(T, k) { \
+            acc[k] += (A)va.v[k] * (A)vb.v[k]; \
+        } \
+    } \
+    A r = 0; \
+    simd_for_lanes(T, k) { \
+        r += acc[k]; \
+    } \
+    for (; i < dim; i++) { \
+        r += (A)a[i] * (A)b[i]; \
+    } \
+    return r; \
+} \
+SIMD_FUNC double SIMD_CALLCONV simd_op_name(T,cosine) (const T *a, const T *b, size_t dim) { \
+    A ab[VLEN(T)] = {0}, aa[VLEN(T)] = {0}, bb[VLEN(T)] = {0}; \
+    size_t i = 0; \
+    for (; i + VLEN(T) <= dim; i += VLEN(T)) { \
+        simd_t(T) va = simd_load(T, a + i), vb = simd_load(T, b + i); \
+        simd_for_lanes(T, k) { \
+            A x = (A)va.v[k], y = (A)vb.v[k]; \
+            ab[k] += x * y; \
+            aa[k] += x * x; \
+            bb[k] += y * y; \
+        } \
+    } \
+    double sab = 0, saa = 0, sbb = 0; \
+    simd_for_lanes(T, k) { \
+        sab += (double)ab[k]; \
+        saa += (double)aa[k]; \
+        sbb += (double)bb[k]; \
+    } \
+    for (; i < dim; i++) { \
+        double x = (double)a[i], y = (double)b[i]; \
+        sab += x * y; \
+        saa += x * x; \
+        sbb += y * y; \
+    } \
+    return (saa > 0 && sbb > 0) ? sab / __builtin_sqrt(saa * sbb) : 0.0; \
+} \
+SIMD_FUNC void SIMD_CALLCONV \
+simd_op_name(T,l2sq_batch) (const T *q, const T *base, size_t count, \
+                            size_t dim, A *out) { \
+    for (size_t r = 0; r < count; r++) { \
+        out[r] = simd_op_name(T,l2sq)(q, base + r * dim, dim); \
+    } \
+} \
+SIMD_FUNC void SIMD_CALLCONV \
+simd_op_name(T,inner_product_batch) (const T *q, const T *base, size_t count, \
+                                     size_t dim, A *out) { \
+    for (size_t r = 0; r < count; r++) { \
+        out[r] = simd_op_name(T,inner_product)(q, base + r * dim, dim); \
+    } \
+} \
+SIMD_FUNC void SIMD_CALLCONV \
+simd_op_name(T,cosine_batch) (const T *q, const T *base, size_t count, \
+                              size_t dim, double *out) { \
+    for (size_t r = 0; r < count; r++) { \
+        out[r] = simd_op_name(T,cosine)(q, base + r * dim, dim); \
+    } \
+}
+
+/**
+ * @brief Define Hamming distance kernels over packed binary codes of type T.
+ *
+ * @tparam T Unsigned word type (typically uint64_t); requires decl_simd_t(T)
+ *
+ * Declares functions over codes of nwords words:
+ *   uint64_t hamming_simd_v{T}{XLEN}_t(const T *a, const T *b, size_t nwords)
+ *   void     hamming_batch_simd_v{T}{XLEN}_t(const T *q, const T *base, size_t count,
+ *                                           size_t nwords, uint64_t *out)
+ */
+#define decl_simd_hamming_ops(T) \
+SIMD_FUNC uint64_t SIMD_CALLCONV simd_op_name(T,hamming) (const T *a, const T *b, size_t nwords) { \
+    uint64_t acc[VLEN(T)] = {0}; \
+    size_t i = 0; \
+    for (; i + VLEN(T) <= nwords; i += VLEN(T)) { \
+        simd_t(T) va = simd_load(T, a + i), vb = simd_load(T, b + i); \
+        simd_t(T) x = simd_apply_xor(T, va, vb); \
+        simd_t(T) c = simd_apply_popcnt(T, x); \
+        simd_for_lanes(T, k) { \
+            acc[k] += c.v[k]; \
+        } \
+    } \
+    uint64_t r = 0; \
+    simd_for_lanes(T, k) { \
+        r += acc[k]; \
+    } \
+    for (; i < nwords; i++) { \
+        r += (uint64_t)__builtin_popcountll((unsigned long long)(T)(a[i] ^ b[i])); \
+    } \
+    return r; \
+} \
+SIMD_FUNC void SIMD_CALLCONV \
+simd_op_name(T,hamming_batch) (const T *q, const T *base, size_t count, \
+                               size_t nwords, uint64_t *out) { \
+    for (size_t r = 0; r < count; r++) { \
+        out[r] = simd_op_name(T,hamming)(q, base + r * nwords, nwords); \
+    } \
+}
+
+/**
+ * @brief Define top-k (k smallest) selection over an array of distances.
+ *
+ * @tparam T Distance type; requires decl_simd_t(T)
+ *
+ * Declares:
+ *   size_t topk_simd_v{T}{XLEN}_t(const T *dist, size_t n, size_t k,
+ *                                 size_t *idx, T *out)
+ *
+ * Writes the indices (idx) and values (out) of the min(k, n) smallest
+ * distances in ascending order and returns how many were written. A
+ * bounded max-heap holds the current candidates; each VLEN(T) block is
+ * first compared against the heap top, so blocks with no closer
+ * candidate are skipped after one OR-reduced compare, before any lane
+ * mask is built.
+ */
+#define decl_simd_topk(T) \
+SIMD_FUNC void SIMD_CALLCONV \
+simd_op_name(T,topk_sift) (size_t *idx, T *out, size_t len, size_t pos) { \
+    for (;;) { \
+        size_t l = 2 * pos + 1, r = l + 1, m = pos; \
+        if (l < len && out[l] > out[m]) m = l; \
+        if (r < len && out[r] > out[m]) m = r; \
+        if (m == pos) { \
+            return; \
+        } \
+        T td = out[pos]; out[pos] = out[m]; out[m] = td; \
+        size_t ti = idx[pos]; idx[pos] = idx[m]; idx[m] = ti; \
+        pos = m; \
+    } \
+} \
+SIMD_FUNC size_t SIMD_CALLCONV \
+simd_op_name(T,topk) (const T *dist, size_t n, size_t k, size_t *idx, T *out) { \
+    size_t len = k < n ? k : n; \
+    if (len == 0) { \
+        return 0; \
+    } \
+    for (size_t j = 0; j < len; j++) { \
+        idx[j] = j; \
+        out[j] = dist[j]; \
+    } \
+    for (size_t j = len / 2; j-- > 0;) { \
+        simd_op_name(T,topk_sift)(idx, out, len, j); \
+    } \
+    size_t i = len; \
+    for (; i + VLEN(T) <= n; i += VLEN(T)) { \
+        simd_t(T) v = simd_load(T, dist + i); \
+        T top = out[0]; \
+        int any = 0; \
+        simd_for_lanes(T, k) { \
+            any |= v.v[k] < top; \
+        } \
+        if (!any) { \
+            continue; \
+        } \
+        simd_mask_t m = simd_apply_cmplt(T, v, simd_splat(T, top)); \
+        while (m) { \
+            int lane = __builtin_ctzll(m); \
+            m &= m - 1; \
+            if (v.v[lane] < out[0]) { \
+                out[0] = v.v[lane]; \
+                idx[0] = i + (size_t)lane; \
+                simd_op_name(T,topk_sift)(idx, out, len, 0); \
+            } \
+        } \
+    } \
+    for (; i < n; i++) { \
+        if (dist[i] < out[0]) { \
+            out[0] = dist[i]; \
+            idx[0] = i; \
+            simd_op_name(T,topk_sift)(idx, out, len, 0); \
+        } \
+    } \
+    for (size_t end = len; end-- > 1;) { \
+        T td = out[0]; out[0] = out[end]; out[end] = td; \
+        size_t ti = idx[0]; idx[0] = idx[end]; idx[end] = ti; \
+        simd_op_name(T,topk_sift)(idx, out, end, 0); \
+    } \
+    return len; \
+}
+
+/** @brief Squared Euclidean distance (requires decl_simd_distance_ops(T, A)). */
+#define simd_l2sq(T, a, b, dim) simd_op_name(T,l2sq) (a, b, dim)
+
+/** @brief Inner product Σ a[i]*b[i] accumulated in A. */
+#define simd_inner_product(T, a, b, dim) simd_op_name(T,inner_product) (a, b, dim)
+
+/** @brief Cosine similarity as double. */
+#define simd_cosine(T, a, b, dim) simd_op_name(T,cosine) (a, b, dim)
+
+/** @brief out[r] = simd_l2sq(T, q, base + r*dim, dim) for r < count. */
+#define simd_l2sq_batch(T, q, base, count, dim, out) \
+    simd_op_name(T,l2sq_batch) (q, base, count, dim, out)
+
+/** @brief out[r] = simd_inner_product(T, q, base + r*dim, dim) for r < count. */
+#define simd_inner_product_batch(T, q, base, count, dim, out) \
+    simd_op_name(T,inner_product_batch) (q, base, count, dim, out)
+
+/** @brief out[r] = simd_cosine(T, q, base + r*dim, dim) for r < count. */
+#define simd_cosine_batch(T, q, base, count, dim, out) \
+    simd_op_name(T,cosine_batch) (q, base, count, dim, out)
+
+/** @brief Number of differing bits (requires decl_simd_hamming_ops(T)). */
+#define simd_hamming(T, a, b, nwords) simd_op_name(T,hamming) (a, b, nwords)
+
+/** @brief out[r] = simd_hamming(T, q, base + r*nwords, nwords) for r < count. */
+#define simd_hamming_batch(T, q, base, count, nwords, out) \
+    simd_op_name(T,hamming_batch) (q, base, count, nwords, out)
+
+/** @brief k nearest (smallest) distances in ascending order (requires decl_simd_topk(T)). */
+#define simd_topk(T, dist, n, k, idx, out) simd_op_name(T,topk) (dist, n, k, idx, out)
+
+/* -------------------------------------------------------------------------
+ * SIMD math functions
+ * ------------------------------------------------------------------------- */
+
+/**
+ * @brief Unsigned integer type with the same width as scalar type T.
+ *
+ * Example:
+ *   simd_uint_of(float) → uint32_t, simd_uint_of(double) → uint64_t
+ */
+#ifdef __cplusplus
+template <size_t N> struct simd_int_of_size;
+template <> struct simd_int_of_size<1> { typedef uint8_t u; typedef int8_t s; typedef uint16_t w; };
+template <> struct simd_int_of_size<2> { typedef uint16_t u; typedef int16_t s; typedef uint32_t w; };
+template <> struct simd_int_of_size<4> { typedef uint32_t u; typedef int32_t s; typedef uint64_t w; };
+template <> struct simd_int_of_size<8> { typedef uint64_t u; typedef int64_t s; typedef unsigned __int128 w; };
+#define simd_uint_of(T) simd_int_of_size<sizeof(T)>::u
+#else
+#define simd_uint_of(T) \
+    __typeof__(__builtin_choose_expr(sizeof(T) == 1, (uint8_t)0, \
+               __builtin_choose_expr(sizeof(T) == 2, (uint16_t)0, \
+               __builtin_choose_expr(sizeof(T) == 4, (uint32_t)0, (uint64_t)0))))
+#endif
+
+/**
+ * @brief Signed integer type with the same width as scalar type T.
+ *
+ * Example:
+ *   simd_int_of(float) → int32_t, simd_int_of(double) → int64_t
+ */
+#ifdef __cplusplus
+#define simd_int_of(T) simd_int_of_size<sizeof(T)>::s
+#else
+#define simd_int_of(T) \
+    __typeof__(__builtin_choose_expr(sizeof(T) == 1, (int8_t)0, \
+               __builtin_choose_expr(sizeof(T) == 2, (int16_t)0, \
+               __builtin_choose_expr(sizeof(T) == 4, (int32_t)0, (int64_t)0))))
+#endif
+
+/**
+ * @brief 1 if the integer type T is signed, else 0 (a constant expression).
+ *
+ * Compares against 1 rather than 0 so unsigned instantiations do not
+ * trip -Wtype-limits. To test a value's sign in generic code, shift its
+ * top bit down in simd_uint_of(T) instead of comparing it with zero.
+ */
+#define simd_is_signed(T) ((T)-1 < (T)1)
+
+/**
+ * @brief Elementwise exponential of a float or double SIMD vector.
+ *
+ * @tparam T float or double
+ * @param a SIMD vector
+ * @return SIMD vector where each element is e^a.v[i]
+ *
+ * Range reduction x = n*ln2 + r with |r| <= ln2/2, a Taylor polynomial
+ * in r (degree 7 for float, 12 for double) and 2^n built directly in the
+ * exponent bits, as two factors 2^(n/2) * 2^(n - n/2) so that n = 128
+ * (1024 for double) near the overflow limit and the subnormal range
+ * stay representable. Out-of-range inputs are handled with integer bit
+ * masks instead of branches, so the loop vectorizes without -ffast-math.
+ * Inputs above ln(max) (88.72 float, 709.78 double) return +inf, results
+ * underflow gradually through the subnormals to 0, and NaN propagates.
+ * Relative error is within a few ulp for normal results.
+ */
+#define simd_apply_exp(T, a) \
+({ \
+    typedef simd_uint_of(T) _ex_u; \
+    typedef simd_int_of(T) _ex_s; \
+    simd_t(T) _ex_a = (a), _ex_c; \
+    const int _ex_f = sizeof(T) == sizeof(float); \
+    const int _ex_mant = _ex_f ? 23 : 52, _ex_bias = _ex_f ? 127 : 1023; \
+    const int _ex_deg = _ex_f ? 7 : 12; \
+    static const double _ex_inv_fact[13] = { \
+        1.0, 1.0, 1.0 / 2, 1.0 / 6, 1.0 / 24, 1.0 / 120, 1.0 / 720, 1.0 / 5040, \
+        1.0 / 40320, 1.0 / 362880, 1.0 / 3628800, 1.0 / 39916800, 1.0 / 479001600 \
+    }; \
+    const union { T f; _ex_u u; } _ex_hi = { _ex_f ? (T)88.72283935546875 : (T)709.782712893384 }, \
+                                  _ex_lo = { _ex_f ? (T)-103.97208404541015625 : (T)-745.13321910194122 }, \
+                                  _ex_inf = { (T)__builtin_inf() }; \
+    const _ex_u _ex_sign = (_ex_u)1 << (8 * sizeof(T) - 1); \
+    simd_for_lanes(T, i) { \
+        union { T f; _ex_u u; } _ex_x = { _ex_a.v[i] }, _ex_y, _ex_e, _ex_e2; \
+        _ex_u _ex_mnan = -(_ex_u)((_ex_x.u & (_ex_u)~_ex_sign) > _ex_inf.u); \
+        _ex_u _ex_mhi = -(_ex_u)((_ex_s)_ex_x.u > (_ex_s)_ex_hi.u) & ~_ex_mnan; \
+        _ex_u _ex_mlo = -(_ex_u)(_ex_x.u > _ex_lo.u) & ~_ex_mnan; \
+        _ex_y.u = (_ex_x.u & ~(_ex_mhi | _ex_mlo)) | (_ex_hi.u & _ex_mhi) | (_ex_lo.u & _ex_mlo); \
+        T _ex_t = _ex_y.f * (T)1.44269504088896340736; \
+        int32_t _ex_n = (int32_t)(_ex_t + (T)2048.5) - 2048; \
+        T _ex_r = _ex_y.f - (T)_ex_n * (T)0.693145751953125 \
+                          - (T)_ex_n * (T)1.42860682030941723212e-6; \
+        T _ex_p = (T)_ex_inv_fact[_ex_deg]; \
+        simd_unroll(12) \
+        for (int _ex_k = _ex_deg - 1; _ex_k >= 0; _ex_k--) { \
+            _ex_p = _ex_p * _ex_r + (T)_ex_inv_fact[_ex_k]; \
+        } \
+        int32_t _ex_n1 = _ex_n / 2; \
+        _ex_e.u = (_ex_u)(_ex_n1 + _ex_bias) << _ex_mant; \
+        _ex_e2.u = (_ex_u)(_ex_n - _ex_n1 + _ex_bias) << _ex_mant; \
+        _ex_e.f = _ex_p * _ex_e.f * _ex_e2.f; \
+        _ex_e.u = (_ex_e.u & ~(_ex_mhi | _ex_mlo | _ex_mnan)) | (_ex_inf.u & _ex_mhi) | \
+                  (_ex_x.u & _ex_mnan); \
+        _ex_c.v[i] = _ex_e.f; \
+    } \
+    _ex_c; \
+})
+
+/* -------------------------------------------------------------------------
+ * SIMD rounding and floating-point bit manipulation
+ * ------------------------------------------------------------------------- */
+
+/**
+ * @brief Use the target's vector rounding instructions for simd_apply_round etc.
+ *
+ * When 1, the rounding macros call the libm rounding builtins and rely on
+ * the compiler to turn the lane loop into roundps/roundpd (SSE4.1) or
+ * frint* (AArch64). Clang's SLP vectorizer does this; GCC (as of 12) only
+ * vectorizes those builtins in counted loops and emits one scalar round
+ * per lane here, so with GCC the default is the bit-trick fallback, which
+ * it vectorizes fully. Define to 0 or 1 before including the header to
+ * override.
+ */
+#ifndef SIMD_ROUND_INSN
+#if defined(__clang__) && (defined(__SSE4_1__) || defined(__aarch64__))
+#define SIMD_ROUND_INSN 1
+#else
+#define SIMD_ROUND_INSN 0
+#endif
+#endif
+
+/**
+ * @brief Call the float or double flavour of a libm builtin for scalar type T.
+ *
+ * Example:
+ *   simd_libm(float, __builtin_floor, x) → __builtin_floorf(x)
+ */
+#ifdef __cplusplus
+#define simd_libm(T, fn, x) \
+    (sizeof(T) == sizeof(float) ? (T)PPCAT(fn,f)((float)(x)) : (T)fn((double)(x)))
+#else
+#define simd_libm(T, fn, x) \
+    __builtin_choose_expr(sizeof(T) == sizeof(float), PPCAT(fn,f)((float)(x)), fn((double)(x)))
+#endif
+
+/**
+ * @brief Reinterpret the bits of a SIMD vector as another SIMD type.
+ *
+ * @param From Source scalar type
+ * @param To Destination scalar type; requires decl_simd_t(To)
+ * @param v SIMD vector (simd_t(From))
+ * @return simd_t(To) with the same XLEN bits
+ *
+ * Example:
+ *   simd_bitcast(float, uint32_t, x) → IEEE-754 bit patterns of x
+ */
+#define simd_bitcast(From, To, v) \
+({ \
+    simd_static_assert(sizeof(simd_t(From)) == sizeof(simd_t(To)), "simd_bitcast: size mismatch"); \
+    simd_t(From) _bc_a = (v); \
+    simd_t(To) _bc_c; \
+    memcpy(&_bc_c, &_bc_a, sizeof(_bc_c)); \
+    _bc_c; \
+})
+
+/**
+ * @brief Shared body of the rounding macros.
+ *
+ * @param mode 0 rint, 1 trunc, 2 floor, 3 ceil, 4 round (half away from zero)
+ *
+ * The fallback rounds |x| to an integer with (|x| + 2^mant) - 2^mant,
+ * derives trunc/ceil of |x| with one compare each and restores the sign
+ * bit. Non-negative floats order like their bit patterns, so all compares
+ * and selects are done on integer masks, which keeps the loop branch-free
+ * (float compares feeding selects are not if-converted under the default
+ * -ftrapping-math). The sign bit is preserved, so -0.0 and negative
+ * results that round to zero stay -0.0. Lanes with |x| >= 2^mant (already
+ * integral), infinities and NaNs pass through. The trick relies on IEEE
+ * addition and does not survive -ffast-math, which should be paired with
+ * SIMD_ROUND_INSN. With the instructions, round() is computed as
+ * trunc(x + copysign(0.5 - ulp/2, x)), since roundps has no ties-away mode.
+ */
+#define simd_round_impl(T, a, mode) \
+({ \
+    typedef simd_uint_of(T) _rd_u; \
+    simd_t(T) _rd_a = (a); \
+    const _rd_u _rd_sign = (_rd_u)1 << (8 * sizeof(T) - 1); \
+    const union { T f; _rd_u u; } _rd_big = { sizeof(T) == sizeof(float) ? (T)8388608.0 \
+                                                                         : (T)4503599627370496.0 }, \
+                                  _rd_half = { (T)0.5 }; \
+    const T _rd_pred_half = (T)0.5 - (sizeof(T) == sizeof(float) ? (T)0x1p-25 : (T)0x1p-54); \
+    simd_for_lanes(T, i) { \
+        T _rd_y; \
+        if (SIMD_ROUND_INSN) { \
+            T _rd_in = _rd_a.v[i]; \
+            _rd_y = (mode) == 0 ? simd_libm(T, __builtin_rint, _rd_in) \
+                  : (mode) == 1 ? simd_libm(T, __builtin_trunc, _rd_in) \
+                  : (mode) == 2 ? simd_libm(T, __builtin_floor, _rd_in) \
+                  : (mode) == 3 ? simd_libm(T, __builtin_ceil, _rd_in) \
+                  : simd_libm(T, __builtin_trunc, _rd_in); \
+            if ((mode) == 4) { \
+                union { T f; _rd_u u; } _rd_h = { _rd_pred_half }, _rd_s = { _rd_in }; \
+                _rd_h.u |= _rd_s.u & _rd_sign; \
+                _rd_y = simd_libm(T, __builtin_trunc, _rd_in + _rd_h.f); \
+            } \
+        } else { \
+            union { T f; _rd_u u; } _rd_x = { _rd_a.v[i] }, _rd_m, _rd_t, _rd_tr, _rd_cl, \
+                                    _rd_dn, _rd_up, _rd_d, _rd_r; \
+            _rd_m.u = _rd_x.u & ~_rd_sign; \
+            _rd_u _rd_mneg = -(_rd_x.u >> (8 * sizeof(T) - 1)); \
+            _rd_u _rd_msmall = -(_rd_u)(_rd_m.u < _rd_big.u); \
+            _rd_t.f = (_rd_m.f + _rd_big.f) - _rd_big.f; \
+            _rd_dn.f = _rd_t.f - (T)1; \
+            _rd_u _rd_mgt = -(_rd_u)(_rd_t.u > _rd_m.u); \
+            _rd_tr.u = (_rd_dn.u & _rd_mgt) | (_rd_t.u & ~_rd_mgt); \
+            _rd_up.f = _rd_tr.f + (T)1; \
+            _rd_u _rd_mlt = -(_rd_u)(_rd_tr.u < _rd_m.u); \
+            _rd_cl.u = (_rd_up.u & _rd_mlt) | (_rd_tr.u & ~_rd_mlt); \
+            _rd_d.f = _rd_m.f - _rd_tr.f; \
+            _rd_u _rd_mhalf = -(_rd_u)(_rd_d.u >= _rd_half.u); \
+            _rd_r.u = (mode) == 0 ? _rd_t.u \
+                    : (mode) == 1 ? _rd_tr.u \
+                    : (mode) == 2 ? (_rd_cl.u & _rd_mneg) | (_rd_tr.u & ~_rd_mneg) \
+                    : (mode) == 3 ? (_rd_tr.u & _rd_mneg) | (_rd_cl.u & ~_rd_mneg) \
+                    : (_rd_up.u & _rd_mhalf) | (_rd_tr.u & ~_rd_mhalf); \
+            _rd_r.u = (_rd_r.u & _rd_msmall) | (_rd_m.u & ~_rd_msmall); \
+            _rd_r.u |= _rd_x.u & _rd_sign; \
+            _rd_y = _rd_r.f; \
+        } \
+        _rd_a.v[i] = _rd_y; \
+    } \
+    _rd_a; \
+})
+
+/**
+ * @brief Round every lane to the nearest integer, ties away from zero.
+ *
+ * @tparam T float or double
+ * @param a SIMD vector
+ * @return SIMD vector where each element is round(a.v[i])
+ *
+ * Example:
+ *   simd_apply_round(float, {-2.5, -0.4, 0.5, 1.5}) → {-3, -0, 1, 2}
+ */
+#define simd_apply_round(T, a) simd_round_impl(T, a, 4)
+
+/**
+ * @brief Round every lane to the nearest integer, ties to even.
+ *
+ * Matches rint() in the default rounding mode; the cheapest rounding on
+ * every target and the usual choice for quantization.
+ *
+ * Example:
+ *   simd_apply_rint(float, {-2.5, -0.4, 0.5, 1.5}) → {-2, -0, 0, 2}
+ */
+#define simd_apply_rint(T, a) simd_round_impl(T, a, 0)
+
+/** @brief Round every lane towards zero (trunc). */
+#define simd_apply_trunc(T, a) simd_round_impl(T, a, 1)
+
+/** @brief Round every lane towards negative infinity (floor). */
+#define simd_apply_floor(T, a) simd_round_impl(T, a, 2)
+
+/** @brief Round every lane towards positive infinity (ceil). */
+#define simd_apply_ceil(T, a) simd_round_impl(T, a, 3)
+
+/**
+ * @brief Fractional part of every lane, a.v[i] - floor(a.v[i]).
+ *
+ * @return SIMD vector with elements in [0, 1) for finite inputs
+ *
+ * Example:
+ *   simd_apply_fract(float, {1.25, -1.25}) → {0.25, 0.75}
+ */
+#define simd_apply_fract(T, a) \
+({ \
+    simd_t(T) _fr_a = (a), _fr_f = simd_apply_floor(T, _fr_a); \
+    simd_for_lanes(T, i) { \
+        _fr_a.v[i] -= _fr_f.v[i]; \
+    } \
+    _fr_a; \
+})
+
+/**
+ * @brief Magnitude of a with the sign of b, lane by lane.
+ *
+ * @tparam T float or double
+ * @return SIMD vector where each element is copysign(a.v[i], b.v[i])
+ */
+#define simd_apply_copysign(T, a, b) \
+({ \
+    typedef simd_uint_of(T) _cs_u; \
+    simd_t(T) _cs_a = (a), _cs_b = (b); \
+    const _cs_u _cs_sign = (_cs_u)1 << (8 * sizeof(T) - 1); \
+    simd_for_lanes(T, i) { \
+        union { T f; _cs_u u; } _cs_x = { _cs_a.v[i] }, _cs_y = { _cs_b.v[i] }; \
+        _cs_x.u = (_cs_x.u & ~_cs_sign) | (_cs_y.u & _cs_sign); \
+        _cs_a.v[i] = _cs_x.f; \
+    } \
+    _cs_a; \
+})
+
+/**
+ * @brief Multiply every lane by 2^e.v[i].
+ *
+ * @tparam T float or double
+ * @param a SIMD vector
+ * @param e Exponents: simd_t(int32_t) for float, simd_t(int64_t) for double
+ * @return SIMD vector where each element is ldexp(a.v[i], e.v[i])
+ *
+ * The exponent is clamped and applied as three same-signed power-of-two
+ * factors built in the exponent bits, so overflow gives infinity and underflow gives zero
+ * without branches. Results in the subnormal range may be rounded twice.
+ */
+#define simd_apply_ldexp(T, a, e) \
+({ \
+    typedef simd_uint_of(T) _le_u; \
+    typedef simd_int_of(T) _le_s; \
+    simd_t(T) _le_a = (a); \
+    __typeof__(e) _le_e = (e); \
+    const int _le_mant = sizeof(T) == sizeof(float) ? 23 : 52; \
+    const _le_s _le_bias = sizeof(T) == sizeof(float) ? 127 : 1023; \
+    const _le_s _le_lim = 2 * _le_bias + _le_mant + 3; \
+    simd_for_lanes(T, i) { \
+        _le_s _le_n = (_le_s)_le_e.v[i]; \
+        _le_n = _le_n < -_le_lim ? -_le_lim : _le_n; \
+        _le_n = _le_n > _le_lim ? _le_lim : _le_n; \
+        _le_s _le_n1 = _le_n / 3, _le_n2 = (_le_n - _le_n1) / 2; \
+        _le_s _le_n3 = _le_n - _le_n1 - _le_n2; \
+        union { T f; _le_u u; } _le_p1, _le_p2, _le_p3; \
+        _le_p1.u = (_le_u)(_le_n1 + _le_bias) << _le_mant; \
+        _le_p2.u = (_le_u)(_le_n2 + _le_bias) << _le_mant; \
+        _le_p3.u = (_le_u)(_le_n3 + _le_bias) << _le_mant; \
+        _le_a.v[i] = _le_a.v[i] * _le_p1.f * _le_p2.f * _le_p3.f; \
+    } \
+    _le_a; \
+})
+
+/**
+ * @brief Split every lane into a mantissa in [0.5, 1) and a power of two.
+ *
+ * @tparam T float or double
+ * @param a SIMD vector
+ * @param e Pointer to the exponent output, simd_t(int32_t) for float or
+ *          simd_t(int64_t) for double
+ * @return SIMD vector of mantissas m with a.v[i] = m.v[i] * 2^e->v[i]
+ *
+ * Zero, infinity and NaN lanes are returned unchanged with exponent 0, as
+ * frexp() does. Subnormal inputs are normalized first.
+ *
+ * Example:
+ *   simd_apply_frexp(float, {8.0, 0.75}, &e) → {0.5, 0.75}, e = {4, 0}
+ */
+#define simd_apply_frexp(T, a, e) \
+({ \
+    typedef simd_uint_of(T) _fx_u; \
+    typedef simd_int_of(T) _fx_s; \
+    simd_t(T) _fx_a = (a); \
+    __typeof__(*(e)) *_fx_e = (e); \
+    const int _fx_mant = sizeof(T) == sizeof(float) ? 23 : 52; \
+    const _fx_u _fx_emask = sizeof(T) == sizeof(float) ? 0xff : 0x7ff; \
+    const _fx_s _fx_bias = sizeof(T) == sizeof(float) ? 127 : 1023; \
+    simd_for_lanes(T, i) { \
+        union { T f; _fx_u u; } _fx_x = { _fx_a.v[i] }; \
+        _fx_s _fx_adj = 0; \
+        if (((_fx_x.u >> _fx_mant) & _fx_emask) == 0) { \
+            _fx_x.f *= (T)18446744073709551616.0; \
+            _fx_adj = 64; \
+        } \
+        _fx_u _fx_field = (_fx_x.u >> _fx_mant) & _fx_emask; \
+        int _fx_keep = _fx_field == 0 || _fx_field == _fx_emask; \
+        _fx_s _fx_n = _fx_keep ? 0 : (_fx_s)_fx_field - (_fx_bias - 1) - _fx_adj; \
+        _fx_x.u = (_fx_x.u & ~(_fx_emask << _fx_mant)) | ((_fx_u)(_fx_bias - 1) << _fx_mant); \
+        _fx_e->v[i] = _fx_n; \
+        _fx_a.v[i] = _fx_keep ? _fx_a.v[i] : _fx_x.f; \
+    } \
+    _fx_a; \
+})
+
+/* -------------------------------------------------------------------------
+ * SIMD activation and normalization kernels
+ * ------------------------------------------------------------------------- */
+
+/**
+ * @brief Minimum number of elements per softmax block.
+ *
+ * The block is read twice in a row (maximum, then exponentials), so it
+ * should fit in L1: the default is 4 KiB of float.
+ */
+#ifndef SIMD_SOFTMAX_BLOCK
+#define SIMD_SOFTMAX_BLOCK 1024
+#endif
+
+/**
+ * @brief Maximum number of softmax blocks; longer inputs get larger blocks.
+ *
+ * Bounds the per-block maxima softmax keeps on the stack.
+ */
+#ifndef SIMD_SOFTMAX_MAX_BLOCKS
+#define SIMD_SOFTMAX_MAX_BLOCKS 64
+#endif
+
+/**
+ * @brief GELU (tanh approximation) of each lane.
+ *
+ * @tparam T float or double
+ * @param a SIMD vector
+ * @return x - x / (exp(2u) + 1) with u = sqrt(2/pi) * (x + 0.044715 x^3),
+ *         which equals 0.5 x (1 + tanh(u))
+ */
+#define simd_apply_gelu(T, a) \
+({ \
+    simd_t(T) _ge_a = (a), _ge_u; \
+    simd_for_lanes(T, i) { \
+        T _ge_t = _ge_a.v[i]; \
+        _ge_u.v[i] = (T)1.5957691216057308 * (_ge_t + (T)0.044715 * _ge_t * _ge_t * _ge_t); \
+    } \
+    _ge_u = simd_apply_exp(T, _ge_u); \
+    simd_for_lanes(T, i) { \
+        _ge_a.v[i] = _ge_a.v[i] - _ge_a.v[i] / (_ge_u.v[i] + (T)1); \
+    } \
+    _ge_a; \
+})
+
+/**
+ * @brief SiLU (x * sigmoid(x)) of each lane.
+ *
+ * @tparam T float or double
+ * @param a SIMD vector
+ * @return x / (1 + exp(-x)) per lane
+ */
+#define simd_apply_silu(T, a) \
+({ \
+    simd_t(T) _si_a = (a), _si_u; \
+    simd_for_lanes(T, i) { \
+        _si_u.v[i] = -_si_a.v[i]; \
+    } \
+    _si_u = simd_apply_exp(T, _si_u); \
+    simd_for_lanes(T, i) { \
+        _si_a.v[i] = _si_a.v[i] / ((T)1 + _si_u.v[i]); \
+    } \
+    _si_a; \
+})
+
+/**
+ * @brief out[i] = expr over x[0..n), with expr a simd_t(T) expression of
+ *        the loaded vector v, in ascending order.
+ *
+ * Helper of the elementwise nn and poly array kernels. Whole vectors are
+ * loaded and stored; the last n % VLEN(T) elements go through one
+ * zero-padded vector. Each vector is loaded before its store, so the pass
+ * is correct when out starts at or below x.
+ */
+#define simd_array_map_fwd(T, x, n, out, expr) \
+    size_t i = 0; \
+    for (; i + VLEN(T) <= (n); i += VLEN(T)) { \
+        simd_t(T) v = simd_load(T, (x) + i); \
+        simd_store(T, (out) + i, expr); \
+    } \
+    simd_array_map_tail(T, x, n, out, expr)
+
+/**
+ * @brief Like simd_array_map_fwd in descending order: the tail first,
+ *        then whole vectors from the top, for out starting above x.
+ */
+#define simd_array_map_bwd(T, x, n, out, expr) \
+    size_t i = (n) - (n) % VLEN(T); \
+    simd_array_map_tail(T, x, n, out, expr) \
+    while (i) { \
+        i -= VLEN(T); \
+        simd_t(T) v = simd_load(T, (x) + i); \
+        simd_store(T, (out) + i, expr); \
+    }
+
+/** @brief Tail of simd_array_map_fwd and _bwd: elements i..n in one padded vector. */
+#define simd_array_map_tail(T, x, n, out, expr) \
+    if (i < (n)) { \
+        simd_t(T) v = simd_splat(T, 0); \
+        memcpy(&v, (x) + i, ((n) - i) * sizeof(T)); \
+        v = expr; \
+        memcpy((out) + i, &v, ((n) - i) * sizeof(T)); \
+    }
+
+/**
+ * @brief Body of the checked elementwise kernels: run name##_noalias
+ *        (called with args) when out and x are disjoint, otherwise the
+ *        forward or backward pass that overlap allows.
+ */
+#define simd_array_map_checked(T, name, args, x, n, out, expr) \
+    int oa = simd_overlap(out, x, (n) * sizeof(T)); \
+    if (!oa) { \
+        simd_op_name(T,name##_noalias) args; \
+    } else if (oa > 0) { \
+        simd_array_map_bwd(T, x, n, out, expr) \
+    } else { \
+        simd_array_map_fwd(T, x, n, out, expr) \
+    }
+
+/**
+ * @brief Define ML inference kernels over float or double arrays.
+ *
+ * @tparam T float or double; requires decl_simd_t(T)
+ *
+ * Declares functions (out may equal x, but not partially overlap it,
+ * unless noted):
+ *   void softmax_simd_v{T}{XLEN}_t(const T *x, size_t n, T *out)
+ *   void layernorm_simd_v{T}{XLEN}_t(const T *x, size_t n, const T *gamma,
+ *                                    const T *beta, T eps, T *out)
+ *   void rmsnorm_simd_v{T}{XLEN}_t(const T *x, size_t n, const T *gamma,
+ *                                  T eps, T *out)
+ *   void gelu_simd_v{T}{XLEN}_t(const T *x, size_t n, T *out)
+ *   void silu_simd_v{T}{XLEN}_t(const T *x, size_t n, T *out)
+ *   void relu_simd_v{T}{XLEN}_t(const T *x, size_t n, T *out)
+ *
+ * gelu, silu and relu are elementwise: they accept any overlap of out and
+ * x, picking the order of the pass from it, and each has a name_noalias
+ * form with SIMD_RESTRICT pointers for callers that know the arrays are
+ * disjoint. softmax, layernorm and rmsnorm read x in more than one pass,
+ * so no order of a single pass makes a partial overlap safe; they have no
+ * _noalias form.
+ *
+ * softmax makes two passes over memory. The first works block by block:
+ * it takes the block maximum bm (a second read of the block comes from
+ * L1), stores exp(x - bm) and folds the block sum into a running maximum
+ * M and sum S, rescaling S by exp(M_old - M) when M grows. The second
+ * scales each block by exp(bm - M) / S. Blocks hold at least
+ * SIMD_SOFTMAX_BLOCK elements and there are at most
+ * SIMD_SOFTMAX_MAX_BLOCKS of them, so the block maxima live on the stack.
+ * layernorm gets mean and variance from one lane-parallel Welford pass.
+ * gamma and beta may be NULL (scale 1, shift 0). gelu uses the tanh
+ * approximation. relu propagates NaN.
+ */
+#define decl_simd_nn_ops(T) \
+SIMD_FUNC void SIMD_CALLCONV simd_op_name(T,softmax) (const T *x, size_t n, T *out) { \
+    T bmax[SIMD_SOFTMAX_MAX_BLOCKS], m = 0, s = 0; \
+    size_t blk = (n + SIMD_SOFTMAX_MAX_BLOCKS - 1) / SIMD_SOFTMAX_MAX_BLOCKS; \
+    blk = blk > SIMD_SOFTMAX_BLOCK ? blk : SIMD_SOFTMAX_BLOCK; \
+    blk = (blk + VLEN(T) - 1) / VLEN(T) * VLEN(T); \
+    for (size_t j = 0, b = 0; j < n; j += blk, b++) { \
+        const T *xb = x + j; \
+        T *ob = out + j; \
+        size_t len = n - j < blk ? n - j : blk, i = 0; \
+        simd_t(T) vm = simd_splat(T, xb[0]); \
+        for (; i + VLEN(T) <= len; i += VLEN(T)) { \
+            simd_t(T) v = simd_load(T, xb + i); \
+            simd_for_lanes(T, k) { \
+                vm.v[k] = v.v[k] > vm.v[k] ? v.v[k] : vm.v[k]; \
+            } \
+        } \
+        T bm = vm.v[0]; \
+        for (size_t k = 1; k < VLEN(T); k++) { \
+            bm = vm.v[k] > bm ? vm.v[k] : bm; \
+        } \
+        for (; i < len; i++) { \
+            bm = xb[i] > bm ? xb[i] : bm; \
+        } \
+        simd_t(T) vs = simd_splat(T, 0), mm = simd_splat(T, bm); \
+        for (i = 0; i + VLEN(T) <= len; i += VLEN(T)) { \
+            simd_t(T) v = simd_load(T, xb + i); \
+            v = simd_apply_sub(T, v, mm); \
+            v = simd_apply_exp(T, v); \
+            vs = simd_apply_add(T, vs, v); \
+            simd_store(T, ob + i, v); \
+        } \
+        T bs = simd_apply_sum(T, vs); \
+        for (; i < len; i++) { \
+            ob[i] = simd_apply_exp(T, simd_splat(T, xb[i] - bm)).v[0]; \
+            bs += ob[i]; \
+        } \
+        if (b == 0) { \
+            m = bm; \
+        } else if (bm > m) { \
+            s *= simd_apply_exp(T, simd_splat(T, m - bm)).v[0]; \
+            m = bm; \
+        } \
+        s += bs * simd_apply_exp(T, simd_splat(T, bm - m)).v[0]; \
+        bmax[b] = bm; \
+    } \
+    T inv = (T)1 / s; \
+    for (size_t j = 0, b = 0; j < n; j += blk, b++) { \
+        T *ob = out + j; \
+        size_t len = n - j < blk ? n - j : blk, i = 0; \
+        simd_t(T) sc = simd_splat(T, simd_apply_exp(T, simd_splat(T, bmax[b] - m)).v[0] * inv); \
+        for (; i + VLEN(T) <= len; i += VLEN(T)) { \
+            simd_store(T, ob + i, simd_apply_mul(T, simd_load(T, ob + i), sc)); \
+        } \
+        for (; i < len; i++) { \
+            ob[i] *= sc.v[0]; \
+        } \
+    } \
+} \
+SIMD_FUNC void SIMD_CALLCONV \
+simd_op_name(T,layernorm) (const T *x, size_t n, const T *gamma, \
+                           const T *beta, T eps, T *out) { \
+    simd_t(T) mean = simd_splat(T, 0), m2 = mean; \
+    size_t blocks = 0, i = 0; \
+    for (; i + VLEN(T) <= n; i += VLEN(T)) { \
+        simd_t(T) v = simd_load(T, x + i); \
+        T inv = (T)1 / (T)++blocks; \
+        simd_for_lanes(T, k) { \
+            T d = v.v[k] - mean.v[k]; \
+            mean.v[k] += d * inv; \
+            m2.v[k] += d * (v.v[k] - mean.v[k]); \
+        } \
+    } \
+    T cnt = 0, mu = 0, q = 0; \
+    if (blocks) { \
+        cnt = (T)blocks; \
+        mu = mean.v[0]; \
+        q = m2.v[0]; \
+        for (size_t k = 1; k < VLEN(T); k++) { \
+            T nb = (T)blocks, tot = cnt + nb, d = mean.v[k] - mu; \
+            mu += d * nb / tot; \
+            q += m2.v[k] + d * d * cnt * nb / tot; \
+            cnt = tot; \
+        } \
+    } \
+    for (; i < n; i++) { \
+        cnt += 1; \
+        T d = x[i] - mu; \
+        mu += d / cnt; \
+        q += d * (x[i] - mu); \
+    } \
+    T var = cnt > 0 ? q / cnt : (T)0; \
+    T rstd = (T)1 / __builtin_sqrt(var + eps); \
+    for (i = 0; i < n; i++) { \
+        T y = (x[i] - mu) * rstd; \
+        y = gamma ? y * gamma[i] : y; \
+        out[i] = beta ? y + beta[i] : y; \
+    } \
+} \
+SIMD_FUNC void SIMD_CALLCONV \
+simd_op_name(T,rmsnorm) (const T *x, size_t n, const T *gamma, T eps, T *out) { \
+    simd_t(T) acc = simd_splat(T, 0); \
+    size_t i = 0; \
+    for (; i + VLEN(T) <= n; i += VLEN(T)) { \
+        simd_t(T) v = simd_load(T, x + i); \
+        simd_for_lanes(T, k) { \
+            acc.v[k] += v.v[k] * v.v[k]; \
+        } \
+    } \
+    T ss = simd_apply_sum(T, acc); \
+    for (; i < n; i++) { \
+        ss += x[i] * x[i]; \
+    } \
+    T r = (T)1 / __builtin_sqrt((n ? ss / (T)n : (T)0) + eps); \
+    for (i = 0; i < n; i++) { \
+        T y = x[i] * r; \
+        out[i] = gamma ? y * gamma[i] : y; \
+    } \
+} \
+decl_simd_nn_map(T, gelu, simd_apply_gelu(T, v)) \
+decl_simd_nn_map(T, silu, simd_apply_silu(T, v)) \
+decl_simd_nn_map(T, relu, simd_apply_max_scalar(T, v, 0))
+
+/**
+ * @brief Define out[i] = expr(x[i]) as name##_noalias (SIMD_RESTRICT
+ *        pointers) and a checked name that takes any overlap of out and x.
+ *
+ * Helper of decl_simd_nn_ops; expr is a simd_t(T) expression of v.
+ */
+#define decl_simd_nn_map(T, name, expr) \
+SIMD_FUNC void SIMD_CALLCONV \
+simd_op_name(T,name##_noalias) (const T *SIMD_RESTRICT x, size_t n, T *SIMD_RESTRICT out) { \
+    simd_array_map_fwd(T, x, n, out, expr) \
+} \
+SIMD_FUNC void SIMD_CALLCONV simd_op_name(T,name) (const T *x, size_t n, T *out) { \
+    simd_array_map_checked(T, name, (x, n, out), x, n, out, expr) \
+}
+
+/** @brief Numerically stable softmax (requires decl_simd_nn_ops(T)). */
+#define simd_softmax(T, x, n, out) simd_op_name(T,softmax) (x, n, out)
+
+/** @brief (x - mean) / sqrt(var + eps) * gamma + beta. */
+#define simd_layernorm(T, x, n, gamma, beta, eps, out) \
+    simd_op_name(T,layernorm) (x, n, gamma, beta, eps, out)
+
+/** @brief x / sqrt(mean(x^2) + eps) * gamma. */
+#define simd_rmsnorm(T, x, n, gamma, eps, out) \
+    simd_op_name(T,rmsnorm) (x, n, gamma, eps, out)
+
+/** @brief GELU, tanh approximation. */
+#define simd_gelu(T, x, n, out) simd_op_name(T,gelu) (x, n, out)
+
+/** @brief SiLU / swish: x * sigmoid(x). */
+#define simd_silu(T, x, n, out) simd_op_name(T,silu) (x, n, out)
+
+/** @brief ReLU: max(x, 0). */
+#define simd_relu(T, x, n, out) simd_op_name(T,relu) (x, n, out)
+
+/**
+ * @brief Call the no-alias form of an elementwise nn kernel:
+ *        simd_nn_noalias(T, gelu, x, n, out); x and out must not overlap.
+ */
+#define simd_nn_noalias(T, op, ...) simd_op_name(T,op##_noalias) (__VA_ARGS__)
+
+/* -------------------------------------------------------------------------
+ * SIMD statistics
+ * ------------------------------------------------------------------------- */
+
+/**
+ * @brief Name of the streaming moments accumulator type for T.
+ *
+ * Example:
+ *   simd_moments_t(double) → simd_moments_double_t
+ */
+#define simd_moments_t(T) PPCAT(simd_moments_,PPCAT(T,_t))
+
+/**
+ * @brief Define statistics kernels and a streaming accumulator for T.
+ *
+ * @tparam T float or double; requires decl_simd_t(T)
+ *
+ * Declares the accumulator
+ *   simd_moments_t(T) { size_t n; T mean, m2, m3, m4, min, max; }
+ * where m2..m4 are sums of powers of deviations from the mean, and:
+ *   void moments_init_simd_v{T}{XLEN}_t(simd_moments_t(T) *m)
+ *   void moments_push_simd_v{T}{XLEN}_t(simd_moments_t(T) *m, const T *x, size_t n)
+ *   void moments_merge_simd_v{T}{XLEN}_t(simd_moments_t(T) *m, const simd_moments_t(T) *o)
+ *   void mean_var_simd_v{T}{XLEN}_t(const T *x, size_t n, T *mean, T *var)
+ *   T    covariance_simd_v{T}{XLEN}_t(const T *x, const T *y, size_t n)
+ *   void minmax_simd_v{T}{XLEN}_t(const T *x, size_t n, T *min, T *max)
+ *
+ * Every lane runs its own Welford recurrence over the elements it sees;
+ * the lanes are then combined pairwise with the parallel merge formulas
+ * (Chan et al., Pebay), which avoids the cancellation of sum-of-squares
+ * formulas. moments_push feeds one block of a stream; moments_merge
+ * combines accumulators filled by different threads. Variances are
+ * population variances (divided by n).
+ *
+ * Example:
+ *   decl_simd_stats_ops(double)
+ *   simd_moments_t(double) m;
+ *   simd_moments_init(double, &m);
+ *   simd_moments_push(double, &m, block, len);
+ *   double sd = sqrt(simd_moments_var(m)), k = simd_moments_kurtosis(m);
+ */
+#define decl_simd_stats_ops(T) \
+typedef struct simd_moments_t(T) { \
+    size_t n; \
+    T mean, m2, m3, m4, min, max; \
+} simd_moments_t(T); \
+SIMD_FUNC void SIMD_CALLCONV simd_op_name(T,moments_init) (simd_moments_t(T) *m) { \
+    m->n = 0; \
+    m->mean = m->m2 = m->m3 = m->m4 = 0; \
+    m->min = (T)__builtin_inf(); \
+    m->max = -(T)__builtin_inf(); \
+} \
+SIMD_FUNC void SIMD_CALLCONV \
+simd_op_name(T,moments_merge) (simd_moments_t(T) *m, const simd_moments_t(T) *o) { \
+    if (o->n == 0) { \
+        return; \
+    } \
+    if (m->n == 0) { \
+        *m = *o; \
+        return; \
+    } \
+    T na = (T)m->n, nb = (T)o->n, n = na + nb; \
+    T d = o->mean - m->mean, d2 = d * d; \
+    T m4 = m->m4 + o->m4 + d2 * d2 * na * nb * (na * na - na * nb + nb * nb) / (n * n * n) \
+         + 6 * d2 * (na * na * o->m2 + nb * nb * m->m2) / (n * n) \
+         + 4 * d * (na * o->m3 - nb * m->m3) / n; \
+    T m3 = m->m3 + o->m3 + d2 * d * na * nb * (na - nb) / (n * n) \
+         + 3 * d * (na * o->m2 - nb * m->m2) / n; \
+    m->m2 += o->m2 + d2 * na * nb / n; \
+    m->m3 = m3; \
+    m->m4 = m4; \
+    m->mean += d * nb / n; \
+    m->n += o->n; \
+    m->min = o->min < m->min ? o->min : m->min; \
+    m->max = o->max > m->max ? o->max : m->max; \
+} \
+SIMD_FUNC void SIMD_CALLCONV \
+simd_op_name(T,moments_push) (simd_moments_t(T) *m, const T *x, size_t n) { \
+    simd_t(T) mean = simd_splat(T, 0), m2 = mean, m3 = mean, m4 = mean; \
+    simd_t(T) mn = simd_splat(T, (T)__builtin_inf()), mx = simd_splat(T, -(T)__builtin_inf()); \
+    size_t blocks = 0, i = 0; \
+    for (; i + VLEN(T) <= n; i += VLEN(T)) { \
+        simd_t(T) v = simd_load(T, x + i); \
+        T n1 = (T)blocks++, nn = (T)blocks, inv = (T)1 / nn; \
+        simd_for_lanes(T, k) { \
+            T d = v.v[k] - mean.v[k], dn = d * inv, dn2 = dn * dn, t1 = d * dn * n1; \
+            mean.v[k] += dn; \
+            m4.v[k] += t1 * dn2 * (nn * nn - 3 * nn + 3) + 6 * dn2 * m2.v[k] - 4 * dn * m3.v[k]; \
+            m3.v[k] += t1 * dn * (nn - 2) - 3 * dn * m2.v[k]; \
+            m2.v[k] += t1; \
+            mn.v[k] = v.v[k] < mn.v[k] ? v.v[k] : mn.v[k]; \
+            mx.v[k] = v.v[k] > mx.v[k] ? v.v[k] : mx.v[k]; \
+        } \
+    } \
+    simd_moments_t(T) lane[VLEN(T)]; \
+    simd_for_lanes(T, k) { \
+        lane[k].n = blocks; \
+        lane[k].mean = mean.v[k]; \
+        lane[k].m2 = m2.v[k]; \
+        lane[k].m3 = m3.v[k]; \
+        lane[k].m4 = m4.v[k]; \
+        lane[k].min = mn.v[k]; \
+        lane[k].max = mx.v[k]; \
+    } \
+    for (size_t half = VLEN(T) / 2; half > 0; half /= 2) { \
+        for (size_t k = 0; k < half; k++) { \
+            simd_op_name(T,moments_merge)(&lane[k], &lane[k + half]); \
+        } \
+    } \
+    for (; i < n; i++) { \
+        simd_moments_t(T) one = { 1, x[i], 0, 0, 0, x[i], x[i] }; \
+        simd_op_name(T,moments_merge)(&lane[0], &one); \
+    } \
+    simd_op_name(T,moments_merge)(m, &lane[0]); \
+} \
+SIMD_FUNC void SIMD_CALLCONV \
+simd_op_name(T,mean_var) (const T *x, size_t n, T *mean_out, T *var_out) { \
+    simd_t(T) mean = simd_splat(T, 0), m2 = mean; \
+    size_t blocks = 0, i = 0; \
+    for (; i + VLEN(T) <= n; i += VLEN(T)) { \
+        simd_t(T) v = simd_load(T, x + i); \
+        T inv = (T)1 / (T)++blocks; \
+        simd_for_lanes(T, k) { \
+            T d = v.v[k] - mean.v[k]; \
+            mean.v[k] += d * inv; \
+            m2.v[k] += d * (v.v[k] - mean.v[k]); \
+        } \
+    } \
+    T cnt[VLEN(T)]; \
+    simd_for_lanes(T, k) { \
+        cnt[k] = (T)blocks; \
+    } \
+    for (size_t half = VLEN(T) / 2; half > 0; half /= 2) { \
+        for (size_t k = 0; k < half; k++) { \
+            T na = cnt[k], nb = cnt[k + half], tot = na + nb; \
+            if (tot > 0) { \
+                T d = mean.v[k + half] - mean.v[k]; \
+                mean.v[k] += d * nb / tot; \
+                m2.v[k] += m2.v[k + half] + d * d * na * nb / tot; \
+            } \
+            cnt[k] = tot; \
+        } \
+    } \
+    T c = cnt[0], mu = mean.v[0], q = m2.v[0]; \
+    for (; i < n; i++) { \
+        c += 1; \
+        T d = x[i] - mu; \
+        mu += d / c; \
+        q += d * (x[i] - mu); \
+    } \
+    *mean_out = mu; \
+    *var_out = c > 0 ? q / c : (T)0; \
+} \
+SIMD_FUNC T SIMD_CALLCONV simd_op_name(T,covariance) (const T *x, const T *y, size_t n) { \
+    simd_t(T) mx = simd_splat(T, 0), my = mx, cxy = mx; \
+    size_t blocks = 0, i = 0; \
+    for (; i + VLEN(T) <= n; i += VLEN(T)) { \
+        simd_t(T) vx = simd_load(T, x + i), vy = simd_load(T, y + i); \
+        T inv = (T)1 / (T)++blocks; \
+        simd_for_lanes(T, k) { \
+            T dx = vx.v[k] - mx.v[k]; \
+            mx.v[k] += dx * inv; \
+            my.v[k] += (vy.v[k] - my.v[k]) * inv; \
+            cxy.v[k] += dx * (vy.v[k] - my.v[k]); \
+        } \
+    } \
+    T cnt[VLEN(T)]; \
+    simd_for_lanes(T, k) { \
+        cnt[k] = (T)blocks; \
+    } \
+    for (size_t half = VLEN(T) / 2; half > 0; half /= 2) { \
+        for (size_t k = 0; k < half; k++) { \
+            T na = cnt[k], nb = cnt[k + half], tot = na + nb; \
+            if (tot > 0) { \
+                T dx = mx.v[k + half] - mx.v[k], dy = my.v[k + half] - my.v[k]; \
+                mx.v[k] += dx * nb / tot; \
+                my.v[k] += dy * nb / tot; \
+                cxy.v[k] += cxy.v[k + half] + dx * dy * na * nb / tot; \
+            } \
+            cnt[k] = tot; \
+        } \
+    } \
+    T c = cnt[0], ax = mx.v[0], ay = my.v[0], q = cxy.v[0]; \
+    for (; i < n; i++) { \
+        c += 1; \
+        T dx = x[i] - ax; \
+        ax += dx / c; \
+        ay += (y[i] - ay) / c; \
+        q += dx * (y[i] - ay); \
+    } \
+    return c > 0 ? q / c : (T)0; \
+} \
+SIMD_FUNC void SIMD_CALLCONV \
+simd_op_name(T,minmax) (const T *x, size_t n, T *min_out, T *max_out) { \
+    simd_t(T) mn = simd_splat(T, (T)__builtin_inf()), mx = simd_splat(T, -(T)__builtin_inf()); \
+    size_t i = 0; \
+    for (; i + VLEN(T) <= n; i += VLEN(T)) { \
+        simd_t(T) v = simd_load(T, x + i); \
+        simd_for_lanes(T, k) { \
+            mn.v[k] = v.v[k] < mn.v[k] ? v.v[k] : mn.v[k]; \
+            mx.v[k] = v.v[k] > mx.v[k] ? v.v[k] : mx.v[k]; \
+        } \
+    } \
+    T a = mn.v[0], b = mx.v[0]; \
+    for (size_t k = 1; k < VLEN(T); k++) { \
+        a = mn.v[k] < a ? mn.v[k] : a; \
+        b = mx.v[k] > b ? mx.v[k] : b; \
+    } \
+    for (; i < n; i++) { \
+        a = x[i] < a ? x[i] : a; \
+        b = x[i] > b ? x[i] : b; \
+    } \
+    *min_out = a; \
+    *max_out = b; \
+}
+
+/** @brief Reset a moments accumulator (requires decl_simd_stats_ops(T)). */
+#define simd_moments_init(T, m) simd_op_name(T,moments_init) (m)
+
+/** @brief Add n samples to a moments accumulator. */
+#define simd_moments_push(T, m, x, n) simd_op_name(T,moments_push) (m, x, n)
+
+/** @brief Combine accumulator o into m (e.g. partial results of threads). */
+#define simd_moments_merge(T, m, o) simd_op_name(T,moments_merge) (m, o)
+
+/** @brief Population variance of an accumulator (a struct value). */
+#define simd_moments_var(m) ((m).n ? (m).m2 / (m).n : 0)
+
+/** @brief Skewness of an accumulator (a struct value). */
+#define simd_moments_skewness(m) \
+    ((m).m2 > 0 ? __builtin_sqrt((double)(m).n) * (m).m3 / __builtin_pow((m).m2, 1.5) : 0)
+
+/** @brief Excess kurtosis of an accumulator (a struct value). */
+#define simd_moments_kurtosis(m) \
+    ((m).m2 > 0 ? (double)(m).n * (m).m4 / ((m).m2 * (m).m2) - 3.0 : 0)
+
+/** @brief Mean and population variance in a single pass. */
+#define simd_mean_var(T, x, n, mean, var) simd_op_name(T,mean_var) (x, n, mean, var)
+
+/** @brief Population covariance of x and y in a single pass. */
+#define simd_covariance(T, x, y, n) simd_op_name(T,covariance) (x, y, n)
+
+/** @brief Minimum and maximum in a single pass. */
+#define simd_minmax(T, x, n, min, max) simd_op_name(T,minmax) (x, n, min, max)
+
+/* -------------------------------------------------------------------------
+ * SIMD polynomial evaluation and table interpolation
+ * ------------------------------------------------------------------------- */
+
+/**
+ * @brief Lowest degree evaluated with Estrin's scheme by simd_polyval.
+ *
+ * Horner's scheme is a chain of degree dependent multiply-adds. The Estrin
+ * evaluator splits the polynomial into four interleaved Horner chains in
+ * x^4 and joins them with the top two levels of Estrin's tree, so its
+ * dependency chain is about degree/4 + 2 steps. That wins once the chain
+ * is long enough to be latency-bound.
+ */
+#ifndef SIMD_POLY_ESTRIN_DEGREE
+#define SIMD_POLY_ESTRIN_DEGREE 5
+#endif
+
+/**
+ * @brief Define polynomial and lookup-table interpolation kernels for T.
+ *
+ * @tparam T float or double; requires decl_simd_t(T)
+ *
+ * Polynomials use ascending coefficients:
+ *   p(x) = c[0] + c[1]*x + ... + c[degree]*x^degree
+ *
+ * Declares functions:
+ *   simd_t(T) polyval_horner_simd_v{T}{XLEN}_t(const T *c, int degree, simd_t(T) x)
+ *   simd_t(T) polyval_estrin_simd_v{T}{XLEN}_t(const T *c, int degree, simd_t(T) x)
+ *   simd_t(T) polyval_simd_v{T}{XLEN}_t(const T *c, int degree, simd_t(T) x)
+ *   void      polyval_array_simd_v{T}{XLEN}_t(const T *c, int degree,
+ *                                             const T *x, size_t n, T *out)
+ *   simd_t(T) lut_interp_simd_v{T}{XLEN}_t(const T *table, size_t n, simd_t(T) x)
+ *   void      lut_interp_array_simd_v{T}{XLEN}_t(const T *table, size_t n,
+ *                                                const T *x, size_t count, T *out)
+ *
+ * The two array kernels accept any overlap of out and x, picking the
+ * order of the pass from it (the coefficients and the table must not
+ * overlap out), and each has a name_noalias form with SIMD_RESTRICT
+ * pointers for disjoint arrays, called through simd_poly_noalias.
+ *
+ * polyval picks Estrin's scheme from SIMD_POLY_ESTRIN_DEGREE upwards; any
+ * degree is supported and degrees below 3 always use Horner's scheme. The
+ * multiply-adds are written as a*b + c so they contract to FMA when the
+ * target has it (GCC's default -ffp-contract=fast, or -ffp-contract=on).
+ *
+ * lut_interp treats x as a fractional index into table[0..n-1] (clamped
+ * to that range) and linearly interpolates between the two neighbouring
+ * entries, gathering them per lane. Scale x beforehand to map a physical
+ * range onto the table.
+ *
+ * Example:
+ *   decl_simd_poly_ops(float)
+ *   static const float c[] = {1.0f, 0.5f, 0.25f};
+ *   simd_t(float) y = simd_polyval(float, c, 2, x);
+ */
+#define decl_simd_poly_ops(T) \
+SIMD_FUNC simd_t(T) SIMD_CALLCONV \
+simd_op_name(T,polyval_horner) (const T *c, int degree, simd_t(T) x) { \
+    simd_t(T) r = simd_splat(T, c[degree]); \
+    for (int k = degree - 1; k >= 0; k--) { \
+        simd_for_lanes(T, i) { \
+            r.v[i] = r.v[i] * x.v[i] + c[k]; \
+        } \
+    } \
+    return r; \
+} \
+SIMD_FUNC simd_t(T) SIMD_CALLCONV \
+simd_op_name(T,polyval_estrin) (const T *c, int degree, simd_t(T) x) { \
+    if (degree < 3) { \
+        return simd_op_name(T,polyval_horner)(c, degree, x); \
+    } \
+    int top = degree / 4, d = degree - 4 * top; \
+    simd_t(T) x2 = simd_apply_mul(T, x, x), x4 = simd_apply_mul(T, x2, x2), r; \
+    simd_t(T) p0 = simd_splat(T, c[4 * top]); \
+    simd_t(T) p1 = simd_splat(T, d >= 1 ? c[4 * top + 1] : (T)0); \
+    simd_t(T) p2 = simd_splat(T, d >= 2 ? c[4 * top + 2] : (T)0); \
+    simd_t(T) p3 = simd_splat(T, d >= 3 ? c[4 * top + 3] : (T)0); \
+    for (int k = top - 1; k >= 0; k--) { \
+        const T *ck = c + 4 * k; \
+        simd_for_lanes(T, i) { \
+            p0.v[i] = p0.v[i] * x4.v[i] + ck[0]; \
+            p1.v[i] = p1.v[i] * x4.v[i] + ck[1]; \
+            p2.v[i] = p2.v[i] * x4.v[i] + ck[2]; \
+            p3.v[i] = p3.v[i] * x4.v[i] + ck[3]; \
+        } \
+    } \
+    simd_for_lanes(T, i) { \
+        r.v[i] = (p0.v[i] + p1.v[i] * x.v[i]) + (p2.v[i] + p3.v[i] * x.v[i]) * x2.v[i]; \
+    } \
+    return r; \
+} \
+SIMD_FUNC simd_t(T) SIMD_CALLCONV simd_op_name(T,polyval) (const T *c, int degree, simd_t(T) x) { \
+    return degree >= SIMD_POLY_ESTRIN_DEGREE \
+        ? simd_op_name(T,polyval_estrin)(c, degree, x) \
+        : simd_op_name(T,polyval_horner)(c, degree, x); \
+} \
+SIMD_FUNC void SIMD_CALLCONV \
+simd_op_name(T,polyval_array_noalias) (const T *SIMD_RESTRICT c, int degree, \
+                                       const T *SIMD_RESTRICT x, size_t n, T *SIMD_RESTRICT out) { \
+    simd_array_map_fwd(T, x, n, out, simd_op_name(T,polyval)(c, degree, v)) \
+} \
+SIMD_FUNC void SIMD_CALLCONV \
+simd_op_name(T,polyval_array) (const T *c, int degree, const T *x, size_t n, T *out) { \
+    simd_array_map_checked(T, polyval_array, (c, degree, x, n, out), x, n, out, \
+                           simd_op_name(T,polyval)(c, degree, v)) \
+} \
+SIMD_FUNC simd_t(T) SIMD_CALLCONV \
+simd_op_name(T,lut_interp) (const T *table, size_t n, simd_t(T) x) { \
+    simd_t(T) r; \
+    if (n < 2) { \
+        return simd_splat(T, n ? table[0] : (T)0); \
+    } \
+    const T hi = (T)(n - 1); \
+    const int32_t last = (int32_t)n - 2; \
+    simd_for_lanes_rolled(T, i) { \
+        T xc = x.v[i] > (T)0 ? x.v[i] : (T)0; \
+        xc = xc < hi ? xc : hi; \
+        int32_t k = (int32_t)xc; \
+        k = k < last ? k : last; \
+        T f = xc - (T)k, a = table[k], b = table[k + 1]; \
+        r.v[i] = a + f * (b - a); \
+    } \
+    return r; \
+} \
+SIMD_FUNC void SIMD_CALLCONV \
+simd_op_name(T,lut_interp_array_noalias) (const T *SIMD_RESTRICT table, size_t n, \
+                                          const T *SIMD_RESTRICT x, size_t count, \
+                                          T *SIMD_RESTRICT out) { \
+    simd_array_map_fwd(T, x, count, out, simd_op_name(T,lut_interp)(table, n, v)) \
+} \
+SIMD_FUNC void SIMD_CALLCONV \
+simd_op_name(T,lut_interp_array) (const T *table, size_t n, const T *x, \
+                                  size_t count, T *out) { \
+    simd_array_map_checked(T, lut_interp_array, (table, n, x, count, out), x, count, out, \
+                           simd_op_name(T,lut_interp)(table, n, v)) \
+}
+
+/** @brief Evaluate a polynomial on every lane (requires decl_simd_poly_ops(T)). */
+#define simd_polyval(T, coeffs, degree, x) simd_op_name(T,polyval) (coeffs, degree, x)
+
+/** @brief Evaluate a polynomial with Horner's scheme. */
+#define simd_polyval_horner(T, coeffs, degree, x) \
+    simd_op_name(T,polyval_horner) (coeffs, degree, x)
+
+/** @brief Evaluate a polynomial with Estrin's scheme. */
+#define simd_polyval_estrin(T, coeffs, degree, x) \
+    simd_op_name(T,polyval_estrin) (coeffs, degree, x)
+
+/** @brief out[i] = p(x[i]) for i < n. */
+#define simd_polyval_array(T, coeffs, degree, x, n, out) \
+    simd_op_name(T,polyval_array) (coeffs, degree, x, n, out)
+
+/** @brief Piecewise-linear table lookup at fractional indices x. */
+#define simd_lut_interp(T, table, n, x) simd_op_name(T,lut_interp) (table, n, x)
+
+/** @brief out[i] = simd_lut_interp at x[i] for i < count. */
+#define simd_lut_interp_array(T, table, n, x, count, out) \
+    simd_op_name(T,lut_interp_array) (table, n, x, count, out)
+
+/**
+ * @brief Call the no-alias form of a poly array kernel:
+ *        simd_poly_noalias(T, polyval_array, c, degree, x, n, out).
+ */
+#define simd_poly_noalias(T, op, ...) simd_op_name(T,op##_noalias) (__VA_ARGS__)
+
+/* -------------------------------------------------------------------------
+ * SIMD random number generation
+ * ------------------------------------------------------------------------- */
+
+/**
+ * @brief Number of independent xoshiro256++ streams in a simd_rng_t.
+ *
+ * Fixed independently of XLEN so that a given seed produces the same
+ * sequence at every register width. Must be even, since normal variates
+ * are produced in pairs.
+ */
+#ifndef SIMD_RNG_STREAMS
+#define SIMD_RNG_STREAMS 16
+#endif
+
+/**
+ * @brief Rotate a 64-bit word left by k bits (0 < k < 64).
+ */
+#define simd_rotl64(x, k) (((x) << (k)) | ((x) >> (64 - (k))))
+
+/**
+ * @brief Define the per-type uniform and normal fill kernels of the RNG.
+ *
+ * @param T float or double
+ * @param S Suffix selecting the libm builtins for T (f for float, empty for double)
+ * @param MANT Number of random mantissa bits used per value (24 or 53)
+ *
+ * Used by decl_simd_rng_ops(); not meant to be expanded directly.
+ */
+#define decl_simd_rng_real(T, S, MANT) \
+SIMD_FUNC void SIMD_CALLCONV simd_op_name(T,rng_uniform) (simd_rng_t *r, T *out, size_t n) { \
+    uint64_t u[SIMD_RNG_STREAMS]; \
+    for (size_t i = 0; i < n; i += SIMD_RNG_STREAMS) { \
+        size_t len = n - i < SIMD_RNG_STREAMS ? n - i : SIMD_RNG_STREAMS; \
+        simd_op_name(uint64_t,rng_fill_u64)(r, u, len); \
+        for (size_t j = 0; j < len; j++) { \
+            out[i + j] = (T)(u[j] >> (64 - MANT)) * ((T)1 / (T)(1ull << MANT)); \
+        } \
+    } \
+} \
+SIMD_FUNC void SIMD_CALLCONV \
+simd_op_name(T,rng_normal) (simd_rng_t *r, T *out, size_t n, T mean, T stddev) { \
+    enum { H = SIMD_RNG_STREAMS / 2 }; \
+    const T two_pi = (T)6.283185307179586476925286766559; \
+    const T scale = (T)1 / (T)(1ull << MANT); \
+    uint64_t u[SIMD_RNG_STREAMS]; \
+    T z[SIMD_RNG_STREAMS]; \
+    for (size_t i = 0; i < n; i += SIMD_RNG_STREAMS) { \
+        size_t len = n - i < SIMD_RNG_STREAMS ? n - i : SIMD_RNG_STREAMS; \
+        simd_op_name(uint64_t,rng_fill_u64)(r, u, SIMD_RNG_STREAMS); \
+        for (int j = 0; j < H; j++) { \
+            T u1 = (T)((u[j] >> (64 - MANT)) + 1) * scale; \
+            T u2 = (T)(u[j + H] >> (64 - MANT)) * scale; \
+            T rad = stddev * PPCAT(__builtin_sqrt,S)(-2 * PPCAT(__builtin_log,S)(u1)); \
+            z[j] = mean + rad * PPCAT(__builtin_cos,S)(two_pi * u2); \
+            z[j + H] = mean + rad * PPCAT(__builtin_sin,S)(two_pi * u2); \
+        } \
+        memcpy(out + i, z, len * sizeof(T)); \
+    } \
+}
+
+/**
+ * @brief Define the multi-stream xoshiro256++ generator and its kernels.
+ *
+ * Requires decl_simd_t(uint64_t). Expand once per program (per XLEN).
+ *
+ * Declares the state
+ *   simd_rng_t { uint64_t s[4][SIMD_RNG_STREAMS]; uint64_t buf[...]; unsigned pos; }
+ * and:
+ *   void              rng_seed_simd_vuint64_t{XLEN}_t(simd_rng_t *r, uint64_t seed)
+ *   simd_t(uint64_t)  rng_next_simd_vuint64_t{XLEN}_t(simd_rng_t *r)
+ *   void              rng_fill_u64_simd_vuint64_t{XLEN}_t(simd_rng_t *r, uint64_t *out, size_t n)
+ *   void              rng_range_u32_simd_vuint64_t{XLEN}_t(simd_rng_t *r, uint32_t *out,
+ *                                                         size_t n, uint32_t lo, uint32_t hi)
+ *   void              rng_uniform_simd_v{T}{XLEN}_t(simd_rng_t *r, T *out, size_t n)
+ *   void              rng_normal_simd_v{T}{XLEN}_t(simd_rng_t *r, T *out, size_t n,
+ *                                                  T mean, T stddev)
+ * for T in float and double.
+ *
+ * The state holds SIMD_RNG_STREAMS xoshiro256++ generators laid out
+ * structure-of-arrays, so one step advances all of them with plain lane
+ * loops. The streams are seeded from a single splitmix64 sequence. Each
+ * step yields one output per stream, consumed in stream order, so the
+ * produced sequence depends only on the seed, never on XLEN.
+ *
+ * Uniform reals lie in [0, 1) and use the top 24 (float) or 53 (double)
+ * bits of an output. Integer ranges [lo, hi] use the multiply-shift
+ * reduction of a full 64-bit output (bias below (hi - lo + 1) / 2^64).
+ * Normal variates use the Box-Muller transform on pairs of outputs and
+ * consume SIMD_RNG_STREAMS outputs per started group of that many values.
+ *
+ * Example:
+ *   decl_simd_t(uint64_t)
+ *   decl_simd_rng_ops()
+ *   simd_rng_t rng;
+ *   simd_rng_seed(&rng, 42);
+ *   simd_rng_normal(double, &rng, samples, n, 0.0, 1.0);
+ */
+#define decl_simd_rng_ops() \
+typedef struct simd_rng_t { \
+    uint64_t s[4][SIMD_RNG_STREAMS]; \
+    uint64_t buf[SIMD_RNG_STREAMS]; \
+    unsigned pos; \
+} simd_rng_t; \
+SIMD_FUNC void SIMD_CALLCONV simd_op_name(uint64_t,rng_step) (simd_rng_t *r, uint64_t *out) { \
+    uint64_t *s0 = r->s[0], *s1 = r->s[1], *s2 = r->s[2], *s3 = r->s[3]; \
+    for (int j = 0; j < SIMD_RNG_STREAMS; j++) { \
+        uint64_t sum = s0[j] + s3[j]; \
+        out[j] = simd_rotl64(sum, 23) + s0[j]; \
+        uint64_t t = s1[j] << 17; \
+        s2[j] ^= s0[j]; \
+        s3[j] ^= s1[j]; \
+        s1[j] ^= s2[j]; \
+        s0[j] ^= s3[j]; \
+        s2[j] ^= t; \
+        s3[j] = simd_rotl64(s3[j], 45); \
+    } \
+} \
+SIMD_FUNC void SIMD_CALLCONV simd_op_name(uint64_t,rng_seed) (simd_rng_t *r, uint64_t seed) { \
+    for (int k = 0; k < 4; k++) { \
+        for (int j = 0; j < SIMD_RNG_STREAMS; j++) { \
+            uint64_t z = (seed += 0x9e3779b97f4a7c15ull); \
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull; \
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebull; \
+            r->s[k][j] = z ^ (z >> 31); \
+        } \
+    } \
+    r->pos = SIMD_RNG_STREAMS; \
+} \
+SIMD_FUNC void SIMD_CALLCONV \
+simd_op_name(uint64_t,rng_fill_u64) (simd_rng_t *r, uint64_t *out, size_t n) { \
+    size_t i = 0; \
+    while (i < n && r->pos < SIMD_RNG_STREAMS) { \
+        out[i++] = r->buf[r->pos++]; \
+    } \
+    for (; i + SIMD_RNG_STREAMS <= n; i += SIMD_RNG_STREAMS) { \
+        simd_op_name(uint64_t,rng_step)(r, out + i); \
+    } \
+    if (i < n) { \
+        simd_op_name(uint64_t,rng_step)(r, r->buf); \
+        r->pos = 0; \
+        while (i < n) { \
+            out[i++] = r->buf[r->pos++]; \
+        } \
+    } \
+} \
+SIMD_FUNC simd_t(uint64_t) SIMD_CALLCONV simd_op_name(uint64_t,rng_next) (simd_rng_t *r) { \
+    simd_t(uint64_t) v; \
+    simd_op_name(uint64_t,rng_fill_u64)(r, v.v, VLEN(uint64_t)); \
+    return v; \
+} \
+SIMD_FUNC void SIMD_CALLCONV \
+simd_op_name(uint64_t,rng_range_u32) (simd_rng_t *r, uint32_t *out, size_t n, \
+                                      uint32_t lo, uint32_t hi) { \
+    uint64_t u[SIMD_RNG_STREAMS]; \
+    uint64_t span = (uint64_t)hi - lo + 1; \
+    for (size_t i = 0; i < n; i += SIMD_RNG_STREAMS) { \
+        size_t len = n - i < SIMD_RNG_STREAMS ? n - i : SIMD_RNG_STREAMS; \
+        simd_op_name(uint64_t,rng_fill_u64)(r, u, len); \
+        for (size_t j = 0; j < len; j++) { \
+            out[i + j] = lo + (uint32_t)(((unsigned __int128)u[j] * span) >> 64); \
+        } \
+    } \
+} \
+decl_simd_rng_real(float, f, 24) \
+decl_simd_rng_real(double, , 53)
+
+/** @brief Seed all streams of a simd_rng_t (requires decl_simd_rng_ops()). */
+#define simd_rng_seed(r, seed) simd_op_name(uint64_t,rng_seed) (r, seed)
+
+/** @brief Next VLEN(uint64_t) outputs as one register. */
+#define simd_rng_next(r) simd_op_name(uint64_t,rng_next) (r)
+
+/** @brief Fill out[0..n) with raw 64-bit outputs. */
+#define simd_rng_fill_u64(r, out, n) simd_op_name(uint64_t,rng_fill_u64) (r, out, n)
+
+/** @brief Fill out[0..n) with integers uniform in [lo, hi]. */
+#define simd_rng_range_u32(r, out, n, lo, hi) \
+    simd_op_name(uint64_t,rng_range_u32) (r, out, n, lo, hi)
+
+/** @brief Fill out[0..n) with reals uniform in [0, 1); T is float or double. */
+#define simd_rng_uniform(T, r, out, n) simd_op_name(T,rng_uniform) (r, out, n)
+
+/** @brief Fill out[0..n) with normal variates N(mean, stddev^2). */
+#define simd_rng_normal(T, r, out, n, mean, stddev) \
+    simd_op_name(T,rng_normal) (r, out, n, mean, stddev)
+
+/* -------------------------------------------------------------------------
+ * SIMD array kernels
+ * ------------------------------------------------------------------------- */
+
+/**
+ * @brief Classify how dst overlaps src over the first bytes of each.
+ *
+ * @return 0 if the ranges are disjoint, -1 if they overlap and dst starts
+ *         at or below src (a forward pass is safe), 1 if they overlap and
+ *         dst starts above src (a backward pass is needed)
+ */
+#define simd_overlap(dst, src, bytes) \
+({ \
+    uintptr_t _ov_d = (uintptr_t)(dst), _ov_s = (uintptr_t)(src); \
+    size_t _ov_n = (bytes); \
+    (_ov_d >= _ov_s + _ov_n || _ov_s >= _ov_d + _ov_n) ? 0 : _ov_d <= _ov_s ? -1 : 1; \
+})
+
+/**
+ * @brief Run BLOCK over whole vectors, then ELEM over the tail, ascending.
+ *
+ * Helper of the array kernels. BLOCK loads a full vector of every input
+ * before storing to dst, so the pass is correct when dst starts at or
+ * below each input it overlaps.
+ */
+#define simd_array_loop_fwd(T, n, BLOCK, ELEM, expr) \
+    size_t i = 0; \
+    for (; i + VLEN(T) <= (n); i += VLEN(T)) { \
+        BLOCK(T, i, expr) \
+    } \
+    for (; i < (n); i++) { \
+        ELEM(T, i, expr) \
+    }
+
+/**
+ * @brief Run ELEM over the tail, then BLOCK over whole vectors, descending.
+ *
+ * Mirror of simd_array_loop_fwd, correct when dst starts at or above each
+ * input it overlaps.
+ */
+#define simd_array_loop_bwd(T, n, BLOCK, ELEM, expr) \
+    size_t i = (n) - (n) % VLEN(T); \
+    for (size_t j = (n); j > i; ) { \
+        j--; \
+        ELEM(T, j, expr) \
+    } \
+    while (i) { \
+        i -= VLEN(T); \
+        BLOCK(T, i, expr) \
+    }
+
+/** @brief One vector of dst = expr(x = a[i + k], y = b[i + k]). */
+#define simd_array_binop_block(T, i, expr) \
+    simd_t(T) va = simd_load(T, a + (i)), vb = simd_load(T, b + (i)), vc; \
+    simd_for_lanes(T, k) { \
+        T x = va.v[k], y = vb.v[k]; \
+        vc.v[k] = expr; \
+    } \
+    simd_store(T, dst + (i), vc);
+
+/** @brief One element of dst = expr(x = a[i], y = b[i]). */
+#define simd_array_binop_elem(T, i, expr) \
+    T x = a[i], y = b[i]; \
+    dst[i] = expr;
+
+/** @brief One vector of dst = expr(x = a[i + k]). */
+#define simd_array_unop_block(T, i, expr) \
+    simd_t(T) va = simd_load(T, a + (i)), vc; \
+    simd_for_lanes(T, k) { \
+        T x = va.v[k]; \
+        vc.v[k] = expr; \
+    } \
+    simd_store(T, dst + (i), vc);
+
+/** @brief One element of dst = expr(x = a[i]). */
+#define simd_array_unop_elem(T, i, expr) \
+    T x = a[i]; \
+    dst[i] = expr;
+
+/**
+ * @brief Minimum element count for which SIMD_OMP_PARALLEL forks threads.
+ */
+#ifndef SIMD_OMP_PARALLEL_MIN
+#define SIMD_OMP_PARALLEL_MIN 65536
+#endif
+
+/**
+ * @brief Thread affinity policy of the SIMD_OMP_PARALLEL team (spread, close
+ *        or master).
+ *
+ * Together with schedule(static) this keeps each thread on the same
+ * place and the same chunk of an array across calls, which is what makes
+ * SIMD_ALLOC_FIRST_TOUCH placement pay off. The OpenMP runtime only binds
+ * when it has a place list, e.g. OMP_PLACES=cores in the environment.
+ */
+#ifndef SIMD_OMP_PROC_BIND
+#define SIMD_OMP_PROC_BIND spread
+#endif
+
+/**
+ * @brief aligned clause for the pointers of an OpenMP array loop.
+ *
+ * Empty unless SIMD_OMP_ASSUME_ALIGNED is defined, which promises that
+ * every array passed to the array kernels is aligned to XLEN / 8 bytes.
+ */
+#ifdef SIMD_OMP_ASSUME_ALIGNED
+#define simd_omp_aligned(...) aligned(__VA_ARGS__ : XLEN / 8)
+#else
+#define simd_omp_aligned(...)
+#endif
+
+/**
+ * @brief OpenMP pragma of an array loop of T: "omp simd simdlen(VLEN(T))"
+ *        followed by the extra clauses.
+ */
+#define simd_omp_loop(T, ...) _Pragma(PPSTR(omp simd simdlen(VLEN(T)) __VA_ARGS__))
+
+/**
+ * @brief OpenMP pragma of a threaded array loop of T: "omp parallel for
+ *        simd" with a static schedule and SIMD_OMP_PROC_BIND binding,
+ *        followed by the extra clauses.
+ */
+#define simd_omp_parallel_loop(T, ...) \
+    _Pragma(PPSTR(omp parallel for simd simdlen(VLEN(T)) schedule(static) \
+                  proc_bind(SIMD_OMP_PROC_BIND) __VA_ARGS__))
+
+/**
+ * @brief for (size_t i = 0; i < n; i++) { BODY } under the OpenMP array
+ *        loop pragma with the given clauses.
+ *
+ * With SIMD_OMP_PARALLEL, n >= SIMD_OMP_PARALLEL_MIN takes the threaded
+ * loop and shorter arrays the omp simd loop. n is tested here rather
+ * than in an if(parallel:) clause because that clause still calls into
+ * the OpenMP runtime and an outlined loop, which costs more than a whole
+ * L1-sized pass (see bench/bench_openmp.c).
+ */
+#ifdef SIMD_OMP_PARALLEL
+#define simd_omp_for(T, n, clauses, BODY) \
+    if ((n) >= SIMD_OMP_PARALLEL_MIN) { \
+        simd_omp_parallel_loop(T, clauses) \
+        for (size_t i = 0; i < (n); i++) { \
+            BODY \
+        } \
+    } else { \
+        simd_omp_loop(T, clauses) \
+        for (size_t i = 0; i < (n); i++) { \
+            BODY \
+        } \
+    }
+#else
+#define simd_omp_for(T, n, clauses, BODY) \
+    simd_omp_loop(T, clauses) \
+    for (size_t i = 0; i < (n); i++) { \
+        BODY \
+    }
+#endif
+
+/**
+ * @brief Loop of the _noalias kernels over n elements; ptrs is the
+ *        parenthesized list of array parameters.
+ *
+ * By default the simd_array_loop_fwd block loop. Defining SIMD_OPENMP
+ * (and compiling with -fopenmp or -fopenmp-simd) selects the OpenMP
+ * backend: one flat element loop under simd_omp_for, leaving
+ * vectorization, the tail and, with SIMD_OMP_PARALLEL, threading to the
+ * OpenMP implementation. The checked entry points keep their plain
+ * forward and backward passes for overlapping arrays, whose iterations
+ * are not independent as omp simd requires.
+ */
+#ifdef SIMD_OPENMP
+#define simd_array_loop_noalias(T, n, ptrs, BLOCK, ELEM, expr) \
+    simd_omp_for(T, n, simd_omp_aligned ptrs, ELEM(T, i, expr))
+#else
+#define simd_array_loop_noalias(T, n, ptrs, BLOCK, ELEM, expr) \
+    simd_array_loop_fwd(T, n, BLOCK, ELEM, expr)
+#endif
+
+/**
+ * @brief Body of array_sum: return the sum of a[0..n).
+ *
+ * Four vector accumulators by default, so the add of one vector does not
+ * wait for the previous one; an omp simd reduction(+) loop with
+ * SIMD_OPENMP.
+ */
+#ifdef SIMD_OPENMP
+#define simd_array_sum_body(T, a, n) \
+    T r = 0; \
+    simd_omp_for(T, n, reduction(+: r) simd_omp_aligned(a), r += a[i];) \
+    return r;
+#else
+#define simd_array_sum_body(T, a, n) \
+    simd_t(T) acc = simd_splat(T, 0), acc1 = acc, acc2 = acc, acc3 = acc; \
+    size_t i = 0; \
+    for (; i + 4 * VLEN(T) <= (n); i += 4 * VLEN(T)) { \
+        acc = simd_apply_add(T, acc, simd_load(T, a + i)); \
+        acc1 = simd_apply_add(T, acc1, simd_load(T, a + i + VLEN(T))); \
+        acc2 = simd_apply_add(T, acc2, simd_load(T, a + i + 2 * VLEN(T))); \
+        acc3 = simd_apply_add(T, acc3, simd_load(T, a + i + 3 * VLEN(T))); \
+    } \
+    for (; i + VLEN(T) <= (n); i += VLEN(T)) { \
+        acc = simd_apply_add(T, acc, simd_load(T, a + i)); \
+    } \
+    acc = simd_apply_add(T, simd_apply_add(T, acc, acc1), simd_apply_add(T, acc2, acc3)); \
+    T r = simd_apply_sum(T, acc); \
+    for (; i < (n); i++) { \
+        r += a[i]; \
+    } \
+    return r;
+#endif
+
+/**
+ * @brief Define dst[i] = expr(x, y) over two arrays, with x = a[i], y = b[i].
+ *
+ * Helper of decl_simd_array_ops. Whole vectors go through simd_t(T)
+ * registers; the final n % VLEN(T) elements are handled one by one.
+ *
+ * Defines two functions:
+ *   name##_noalias: SIMD_RESTRICT pointers, so dst must not overlap a or b
+ *                   and the compiler needs no runtime alias checks
+ *   name:           accepts any overlap. It classifies dst against a and b
+ *                   once on entry and runs the no-alias kernel when both are
+ *                   disjoint, a forward pass when dst starts at or below
+ *                   every overlapping input (this includes in place), or a
+ *                   backward pass when it starts at or above them. When dst
+ *                   lies strictly between two overlapping inputs, no order
+ *                   of the pass is safe, so the lower input is first copied
+ *                   to a heap scratch buffer. Returns 0, or -1 with errno
+ *                   set to ENOMEM and dst untouched if that allocation
+ *                   fails.
+ */
+#define decl_simd_array_binop(T, name, expr) \
+SIMD_FUNC void SIMD_CALLCONV \
+simd_op_name(T,name##_noalias) (T *SIMD_RESTRICT dst, const T *SIMD_RESTRICT a, \
+                                const T *SIMD_RESTRICT b, size_t n) { \
+    simd_array_loop_noalias(T, n, (dst, a, b), simd_array_binop_block, simd_array_binop_elem, expr) \
+} \
+SIMD_FUNC int SIMD_CALLCONV simd_op_name(T,name) (T *dst, const T *a, const T *b, size_t n) { \
+    int oa = simd_overlap(dst, a, n * sizeof(T)), ob = simd_overlap(dst, b, n * sizeof(T)); \
+    void *tmp = NULL; \
+    if (!oa && !ob) { \
+        simd_op_name(T,name##_noalias) (dst, a, b, n); \
+        return 0; \
+    } \
+    if (oa * ob < 0) { \
+        tmp = malloc(n * sizeof(T)); \
+        if (!tmp) { \
+            errno = ENOMEM; \
+            return -1; \
+        } \
+        if (oa > 0) { \
+            a = (const T *)memcpy(tmp, a, n * sizeof(T)); \
+        } else { \
+            b = (const T *)memcpy(tmp, b, n * sizeof(T)); \
+        } \
+    } \
+    if (oa >= 0 && ob >= 0) { \
+        simd_array_loop_bwd(T, n, simd_array_binop_block, simd_array_binop_elem, expr) \
+    } else { \
+        simd_array_loop_fwd(T, n, simd_array_binop_block, simd_array_binop_elem, expr) \
+    } \
+    free(tmp); \
+    return 0; \
+}
+
+/**
+ * @brief Define dst[i] = expr(x, s) with x = a[i] and a scalar s.
+ *
+ * Helper of decl_simd_array_ops. Like decl_simd_array_binop, defines a
+ * name##_noalias kernel and a checked name that takes any overlap of dst
+ * and a (forward or backward pass; never needs scratch memory).
+ */
+#define decl_simd_array_scalar_op(T, name, expr) \
+SIMD_FUNC void SIMD_CALLCONV \
+simd_op_name(T,name##_noalias) (T *SIMD_RESTRICT dst, const T *SIMD_RESTRICT a, T s, size_t n) { \
+    simd_array_loop_noalias(T, n, (dst, a), simd_array_unop_block, simd_array_unop_elem, expr) \
+} \
+SIMD_FUNC void SIMD_CALLCONV simd_op_name(T,name) (T *dst, const T *a, T s, size_t n) { \
+    int oa = simd_overlap(dst, a, n * sizeof(T)); \
+    if (!oa) { \
+        simd_op_name(T,name##_noalias) (dst, a, s, n); \
+    } else if (oa > 0) { \
+        simd_array_loop_bwd(T, n, simd_array_unop_block, simd_array_unop_elem, expr) \
+    } else { \
+        simd_array_loop_fwd(T, n, simd_array_unop_block, simd_array_unop_elem, expr) \
+    } \
+}
+
+/**
+ * @brief Define dst[i] = expr(x) with x = a[i].
+ *
+ * Helper of decl_simd_array_ops; defines name##_noalias and a checked
+ * name as decl_simd_array_scalar_op does.
+ */
+#define decl_simd_array_unop(T, name, expr) \
+SIMD_FUNC void SIMD_CALLCONV \
+simd_op_name(T,name##_noalias) (T *SIMD_RESTRICT dst, const T *SIMD_RESTRICT a, size_t n) { \
+    simd_array_loop_noalias(T, n, (dst, a), simd_array_unop_block, simd_array_unop_elem, expr) \
+} \
+SIMD_FUNC void SIMD_CALLCONV simd_op_name(T,name) (T *dst, const T *a, size_t n) { \
+    int oa = simd_overlap(dst, a, n * sizeof(T)); \
+    if (!oa) { \
+        simd_op_name(T,name##_noalias) (dst, a, n); \
+    } else if (oa > 0) { \
+        simd_array_loop_bwd(T, n, simd_array_unop_block, simd_array_unop_elem, expr) \
+    } else { \
+        simd_array_loop_fwd(T, n, simd_array_unop_block, simd_array_unop_elem, expr) \
+    } \
+}
+
+/** @brief One vector of dst = clamp(a[i + k], lo, hi). */
+#define simd_array_clamp_block(T, i, expr) \
+    simd_store(T, dst + (i), simd_apply_clamp(T, simd_load(T, a + (i)), lo, hi));
+
+/** @brief One element of dst = clamp(a[i], lo, hi). */
+#define simd_array_clamp_elem(T, i, expr) \
+    T x = a[i] < lo ? lo : a[i]; \
+    dst[i] = x > hi ? hi : x;
+
+/**
+ * @brief Define whole-array elementwise kernels for T.
+ *
+ * @tparam T Scalar type; requires decl_simd_t(T)
+ *
+ * Declares functions (dst may overlap a or b in any way):
+ *   int  array_{add,sub,mul,div,min,max}_simd_v{T}{XLEN}_t(T *dst, const T *a,
+ *                                                           const T *b, size_t n)
+ *   void array_{add,sub,mul,div,min,max}_scalar_simd_v{T}{XLEN}_t(T *dst, const T *a,
+ *                                                                  T s, size_t n)
+ *   void array_{abs,neg}_simd_v{T}{XLEN}_t(T *dst, const T *a, size_t n)
+ *   void array_clamp_simd_v{T}{XLEN}_t(T *dst, const T *a, T lo, T hi, size_t n)
+ *   T    array_sum_simd_v{T}{XLEN}_t(const T *a, size_t n)
+ * and, for every kernel except array_sum, a name_noalias form with the
+ * same parameters declared SIMD_RESTRICT, for callers that know dst does
+ * not overlap the inputs.
+ *
+ * The two-input kernels return 0, or -1 with errno set to ENOMEM and dst
+ * untouched when dst lies strictly between two inputs it overlaps and
+ * the scratch copy cannot be allocated (see decl_simd_array_binop). All
+ * other calls, and every _noalias form, cannot fail.
+ *
+ * Each kernel is a single pass over its inputs. min, max, abs and clamp
+ * are written as selects, which the compiler lowers to vector
+ * min/max/blend instructions rather than branches. array_abs follows the
+ * same rules as simd_apply_abs (signed or floating-point T).
+ *
+ * Example:
+ *   decl_simd_array_ops(float)
+ *   simd_array_clamp(float, y, x, 0.0f, 1.0f, n);
+ */
+#define decl_simd_array_ops(T) \
+decl_simd_array_binop(T, array_add, x + y) \
+decl_simd_array_binop(T, array_sub, x - y) \
+decl_simd_array_binop(T, array_mul, x * y) \
+decl_simd_array_binop(T, array_div, x / y) \
+decl_simd_array_binop(T, array_min, y < x ? y : x) \
+decl_simd_array_binop(T, array_max, y > x ? y : x) \
+decl_simd_array_scalar_op(T, array_add_scalar, x + s) \
+decl_simd_array_scalar_op(T, array_sub_scalar, x - s) \
+decl_simd_array_scalar_op(T, array_mul_scalar, x * s) \
+decl_simd_array_scalar_op(T, array_div_scalar, x / s) \
+decl_simd_array_scalar_op(T, array_min_scalar, s < x ? s : x) \
+decl_simd_array_scalar_op(T, array_max_scalar, s > x ? s : x) \
+decl_simd_array_unop(T, array_abs, simd_scalar_abs(T, x)) \
+decl_simd_array_unop(T, array_neg, simd_scalar_neg(T, x)) \
+SIMD_FUNC void SIMD_CALLCONV \
+simd_op_name(T,array_clamp_noalias) (T *SIMD_RESTRICT dst, const T *SIMD_RESTRICT a, \
+                                     T lo, T hi, size_t n) { \
+    simd_array_loop_noalias(T, n, (dst, a), simd_array_clamp_block, simd_array_clamp_elem, ) \
+} \
+SIMD_FUNC void SIMD_CALLCONV \
+simd_op_name(T,array_clamp) (T *dst, const T *a, T lo, T hi, size_t n) { \
+    int oa = simd_overlap(dst, a, n * sizeof(T)); \
+    if (!oa) { \
+        simd_op_name(T,array_clamp_noalias) (dst, a, lo, hi, n); \
+    } else if (oa > 0) { \
+        simd_array_loop_bwd(T, n, simd_array_clamp_block, simd_array_clamp_elem, ) \
+    } else { \
+        simd_array_loop_fwd(T, n, simd_array_clamp_block, simd_array_clamp_elem, ) \
+    } \
+} \
+SIMD_FUNC T SIMD_CALLCONV simd_op_name(T,array_sum) (const T *a, size_t n) { \
+    simd_array_sum_body(T, a, n) \
+}
+
+/** @brief dst[i] = a[i] + b[i] (requires decl_simd_array_ops(T)). */
+#define simd_array_add(T, dst, a, b, n) simd_op_name(T,array_add) (dst, a, b, n)
+
+/** @brief dst[i] = a[i] - b[i]. */
+#define simd_array_sub(T, dst, a, b, n) simd_op_name(T,array_sub) (dst, a, b, n)
+
+/** @brief dst[i] = a[i] * b[i]. */
+#define simd_array_mul(T, dst, a, b, n) simd_op_name(T,array_mul) (dst, a, b, n)
+
+/** @brief dst[i] = a[i] / b[i]. */
+#define simd_array_div(T, dst, a, b, n) simd_op_name(T,array_div) (dst, a, b, n)
+
+/** @brief dst[i] = min(a[i], b[i]). */
+#define simd_array_min(T, dst, a, b, n) simd_op_name(T,array_min) (dst, a, b, n)
+
+/** @brief dst[i] = max(a[i], b[i]). */
+#define simd_array_max(T, dst, a, b, n) simd_op_name(T,array_max) (dst, a, b, n)
+
+/** @brief dst[i] = a[i] + s. */
+#define simd_array_add_scalar(T, dst, a, s, n) simd_op_name(T,array_add_scalar) (dst, a, s, n)
+
+/** @brief dst[i] = a[i] - s. */
+#define simd_array_sub_scalar(T, dst, a, s, n) simd_op_name(T,array_sub_scalar) (dst, a, s, n)
+
+/** @brief dst[i] = a[i] * s. */
+#define simd_array_mul_scalar(T, dst, a, s, n) simd_op_name(T,array_mul_scalar) (dst, a, s, n)
+
+/** @brief dst[i] = a[i] / s. */
+#define simd_array_div_scalar(T, dst, a, s, n) simd_op_name(T,array_div_scalar) (dst, a, s, n)
+
+/** @brief dst[i] = min(a[i], s). */
+#define simd_array_min_scalar(T, dst, a, s, n) simd_op_name(T,array_min_scalar) (dst, a, s, n)
+
+/** @brief dst[i] = max(a[i], s). */
+#define simd_array_max_scalar(T, dst, a, s, n) simd_op_name(T,array_max_scalar) (dst, a, s, n)
+
+/** @brief dst[i] = |a[i]|. */
+#define simd_array_abs(T, dst, a, n) simd_op_name(T,array_abs) (dst, a, n)
+
+/** @brief dst[i] = -a[i]. */
+#define simd_array_neg(T, dst, a, n) simd_op_name(T,array_neg) (dst, a, n)
+
+/** @brief dst[i] = min(max(a[i], lo), hi). */
+#define simd_array_clamp(T, dst, a, lo, hi, n) simd_op_name(T,array_clamp) (dst, a, lo, hi, n)
+
+/** @brief Sum of a[0..n). */
+#define simd_array_sum(T, a, n) simd_op_name(T,array_sum) (a, n)
+
+/**
+ * @brief Call the no-alias form of an array kernel: simd_array_noalias(T, add, dst, a, b, n).
+ *
+ * dst must not overlap any input array; the arguments are those of the
+ * matching simd_array_* macro.
+ */
+#define simd_array_noalias(T, op, ...) simd_op_name(T,array_##op##_noalias) (__VA_ARGS__)
+
+/* -------------------------------------------------------------------------
+ * SIMD strided and 2-D views
+ * ------------------------------------------------------------------------- */
+
+/**
+ * @brief Type name of a strided 2-D view of T elements.
+ *
+ * Example:
+ *   simd_view_t(float) → simd_view_float_t
+ */
+#define simd_view_t(T) PPCAT(simd_view_,PPCAT(T,_t))
+
+/**
+ * @brief Body of a view kernel: run one row at a time over the rows of
+ *        dst, with the contiguous array kernel when every stride is 1 and
+ *        the gather/scatter loop otherwise.
+ *
+ * PTRS declares the row pointers pa (and pb) of the input views, LOAD
+ * reads element j of every input into x (and y), OP computes vc.v[k],
+ * and ARRAY is the call of the contiguous kernel on d, pa (and pb).
+ */
+#define simd_view_rows(T, unit, PTRS, LOAD, OP, ARRAY) \
+    for (size_t r = 0; r < dst.rows; r++) { \
+        T *d = dst.base + (ptrdiff_t)r * dst.pitch; \
+        PTRS(T) \
+        if (unit) { \
+            ARRAY; \
+            continue; \
+        } \
+        size_t i = 0; \
+        for (; i + VLEN(T) <= dst.len; i += VLEN(T)) { \
+            simd_t(T) vc; \
+            simd_for_lanes(T, k) { \
+                LOAD(T, i + k) \
+                OP \
+            } \
+            simd_for_lanes(T, k) { \
+                d[(ptrdiff_t)(i + k) * dst.stride] = vc.v[k]; \
+            } \
+        } \
+        for (; i < dst.len; i++) { \
+            simd_t(T) vc; \
+            size_t k = 0; \
+            LOAD(T, i) \
+            OP \
+            d[(ptrdiff_t)i * dst.stride] = vc.v[0]; \
+        } \
+    }
+
+/** @brief Row pointer pa of view a in row r. */
+#define simd_view_ptrs_a(T) \
+    const T *pa = a.base + (ptrdiff_t)r * a.pitch;
+
+/** @brief Row pointers pa, pb of views a, b in row r. */
+#define simd_view_ptrs_ab(T) \
+    const T *pa = a.base + (ptrdiff_t)r * a.pitch; \
+    const T *pb = b.base + (ptrdiff_t)r * b.pitch;
+
+/** @brief True when views x and y have the same rows and length. */
+#define simd_view_same_shape(x, y) ((x).rows == (y).rows && (x).len == (y).len)
+
+/**
+ * @brief True when view v is the transpose of contiguous rows (pitch 1,
+ *        several rows); elementwise kernels then swap the loops.
+ */
+#define simd_view_is_transposed(v) ((v).pitch == 1 && (v).rows > 1 && (v).stride != 1)
+
+/** @brief x = a at element j (lane k of the current vector). */
+#define simd_view_load_a(T, j) \
+    T x = pa[(ptrdiff_t)(j) * a.stride]; (void)k;
+
+/** @brief x = a, y = b at element j (lane k of the current vector). */
+#define simd_view_load_ab(T, j) \
+    T x = pa[(ptrdiff_t)(j) * a.stride], y = pb[(ptrdiff_t)(j) * b.stride]; (void)k;
+
+/**
+ * @brief Define view_name(dst, a, b): dst = expr(x = a, y = b) elementwise.
+ *
+ * Helper of decl_simd_view_ops; the contiguous path is array_name.
+ */
+#define decl_simd_view_binop(T, name, expr) \
+SIMD_FUNC int SIMD_CALLCONV \
+simd_op_name(T,view_##name) (simd_view_t(T) dst, simd_view_t(T) a, simd_view_t(T) b) { \
+    if (!simd_view_same_shape(dst, a) || !simd_view_same_shape(dst, b)) { \
+        errno = EINVAL; \
+        return -1; \
+    } \
+    if (simd_view_is_transposed(dst) && simd_view_is_transposed(a) && simd_view_is_transposed(b)) { \
+        return simd_op_name(T,view_##name) (simd_view_transpose(T, dst), simd_view_transpose(T, a), \
+                                            simd_view_transpose(T, b)); \
+    } \
+    simd_view_rows(T, dst.stride == 1 && a.stride == 1 && b.stride == 1, \
+                   simd_view_ptrs_ab, simd_view_load_ab, vc.v[k] = expr;, \
+                   if (simd_op_name(T,array_##name) (d, pa, pb, dst.len)) return -1) \
+    return 0; \
+}
+
+/**
+ * @brief Define view_name(dst, a, s): dst = expr(x = a, s) elementwise.
+ *
+ * Helper of decl_simd_view_ops; the contiguous path is array_name.
+ */
+#define decl_simd_view_scalar_op(T, name, expr) \
+SIMD_FUNC int SIMD_CALLCONV \
+simd_op_name(T,view_##name) (simd_view_t(T) dst, simd_view_t(T) a, T s) { \
+    if (!simd_view_same_shape(dst, a)) { \
+        errno = EINVAL; \
+        return -1; \
+    } \
+    if (simd_view_is_transposed(dst) && simd_view_is_transposed(a)) { \
+        return simd_op_name(T,view_##name) (simd_view_transpose(T, dst), simd_view_transpose(T, a), s); \
+    } \
+    simd_view_rows(T, dst.stride == 1 && a.stride == 1, \
+                   simd_view_ptrs_a, simd_view_load_a, vc.v[k] = expr;, \
+                   simd_op_name(T,array_##name) (d, pa, s, dst.len)) \
+    return 0; \
+}
+
+/**
+ * @brief Define strided 2-D views and the array kernels over them for T.
+ *
+ * @tparam T Scalar type; requires decl_simd_array_ops(T)
+ *
+ * A view addresses rows × len elements of T:
+ *   element (r, i) = base[r * pitch + i * stride]
+ * with stride and pitch counted in elements and allowed to be negative.
+ * A plain 1-D view has rows = 1. Columns, every k-th element and
+ * sub-blocks of a row-major matrix are all views of the matrix memory,
+ * so no scratch copy is needed.
+ *
+ * Declares types and functions:
+ *   simd_view_t(T)                                  { base, len, stride, rows, pitch }
+ *   simd_view_t(T) view_simd_v{T}{XLEN}_t(T *base, size_t len, ptrdiff_t stride,
+ *                                         size_t rows, ptrdiff_t pitch)
+ *   int view_{add,sub,mul,div,min,max}_simd_v{T}{XLEN}_t(dst, a, b)
+ *   int view_{add,sub,mul,div,min,max}_scalar_simd_v{T}{XLEN}_t(dst, a, T s)
+ *   int view_copy_simd_v{T}{XLEN}_t(dst, a)
+ *   T   view_sum_simd_v{T}{XLEN}_t(a)
+ * The int kernels return 0, or -1 with errno = EINVAL when the views do
+ * not all have the shape of dst. A two-input kernel also fails with
+ * ENOMEM where its contiguous array_* kernel does; rows before the
+ * failing one are then already written.
+ *
+ * Rows whose views all have stride 1 run the contiguous array_* kernel
+ * (so any overlap is handled as there). When every view is a transpose
+ * of contiguous rows (pitch 1), the kernel transposes them all back and
+ * takes that path, since the element order does not matter. Other
+ * strided rows gather VLEN(T) elements into a simd_t(T) register,
+ * compute, and scatter the result; there dst may be identical to an
+ * input but must not otherwise overlap it. view_copy between a view and
+ * its transpose packs or unpacks a block in one pass.
+ *
+ * Example:
+ *   decl_simd_view_ops(float)
+ *   simd_view_t(float) col = simd_view_col(float, m, rows, cols, 3);
+ *   simd_view_mul_scalar(float, col, col, 2.0f);   // scale column 3
+ */
+#define decl_simd_view_ops(T) \
+typedef struct simd_view_t(T) { \
+    T        *base;   /* element (0, 0) */ \
+    size_t    len;    /* elements per row */ \
+    ptrdiff_t stride; /* distance between elements of a row */ \
+    size_t    rows;   /* number of rows, 1 for a 1-D view */ \
+    ptrdiff_t pitch;  /* distance between rows */ \
+} simd_view_t(T); \
+SIMD_FUNC simd_view_t(T) SIMD_CALLCONV \
+simd_op_name(T,view) (T *base, size_t len, ptrdiff_t stride, size_t rows, ptrdiff_t pitch) { \
+    simd_view_t(T) v; \
+    v.base = base; \
+    v.len = len; \
+    v.stride = stride; \
+    v.rows = rows; \
+    v.pitch = pitch; \
+    return v; \
+} \
+decl_simd_view_binop(T, add, x + y) \
+decl_simd_view_binop(T, sub, x - y) \
+decl_simd_view_binop(T, mul, x * y) \
+decl_simd_view_binop(T, div, x / y) \
+decl_simd_view_binop(T, min, y < x ? y : x) \
+decl_simd_view_binop(T, max, y > x ? y : x) \
+decl_simd_view_scalar_op(T, add_scalar, x + s) \
+decl_simd_view_scalar_op(T, sub_scalar, x - s) \
+decl_simd_view_scalar_op(T, mul_scalar, x * s) \
+decl_simd_view_scalar_op(T, div_scalar, x / s) \
+decl_simd_view_scalar_op(T, min_scalar, s < x ? s : x) \
+decl_simd_view_scalar_op(T, max_scalar, s > x ? s : x) \
+SIMD_FUNC int SIMD_CALLCONV simd_op_name(T,view_copy) (simd_view_t(T) dst, simd_view_t(T) a) { \
+    if (!simd_view_same_shape(dst, a)) { \
+        errno = EINVAL; \
+        return -1; \
+    } \
+    if (simd_view_is_transposed(dst) && simd_view_is_transposed(a)) { \
+        return simd_op_name(T,view_copy) (simd_view_transpose(T, dst), simd_view_transpose(T, a)); \
+    } \
+    simd_view_rows(T, dst.stride == 1 && a.stride == 1, \
+                   simd_view_ptrs_a, simd_view_load_a, vc.v[k] = x;, \
+                   memmove(d, pa, dst.len * sizeof(T))) \
+    return 0; \
+} \
+SIMD_FUNC T SIMD_CALLCONV simd_op_name(T,view_sum) (simd_view_t(T) a) { \
+    if (simd_view_is_transposed(a)) { \
+        return simd_op_name(T,view_sum) (simd_view_transpose(T, a)); \
+    } \
+    T r = 0; \
+    for (size_t row = 0; row < a.rows; row++) { \
+        const T *p = a.base + (ptrdiff_t)row * a.pitch; \
+        if (a.stride == 1) { \
+            r += simd_op_name(T,array_sum) (p, a.len); \
+            continue; \
+        } \
+        simd_t(T) acc = simd_splat(T, 0); \
+        size_t i = 0; \
+        for (; i + VLEN(T) <= a.len; i += VLEN(T)) { \
+            simd_t(T) va; \
+            simd_for_lanes(T, k) { \
+                va.v[k] = p[(ptrdiff_t)(i + k) * a.stride]; \
+            } \
+            acc = simd_apply_add(T, acc, va); \
+        } \
+        r += simd_apply_sum(T, acc); \
+        for (; i < a.len; i++) { \
+            r += p[(ptrdiff_t)i * a.stride]; \
+        } \
+    } \
+    return r; \
+}
+
+/** @brief 1-D view of len elements of T, stride elements apart. */
+#define simd_view(T, base, len, stride) simd_op_name(T,view) (base, len, stride, 1, 0)
+
+/** @brief rows × cols block of a row-major matrix whose rows are pitch elements apart. */
+#define simd_view_2d(T, base, rows, cols, pitch) simd_op_name(T,view) (base, cols, 1, rows, pitch)
+
+/** @brief Column col of a rows × cols row-major matrix, as a 1-D view. */
+#define simd_view_col(T, base, rows, cols, col) \
+    simd_op_name(T,view) ((base) + (col), rows, (ptrdiff_t)(cols), 1, 0)
+
+/** @brief Transpose of a view: element (r, i) becomes (i, r). */
+#define simd_view_transpose(T, v) \
+    simd_op_name(T,view) ((v).base, (v).rows, (v).pitch, (v).len, (v).stride)
+
+/** @brief dst = a + b over views (requires decl_simd_view_ops(T)). */
+#define simd_view_add(T, dst, a, b) simd_op_name(T,view_add) (dst, a, b)
+
+/** @brief dst = a - b over views. */
+#define simd_view_sub(T, dst, a, b) simd_op_name(T,view_sub) (dst, a, b)
+
+/** @brief dst = a * b over views. */
+#define simd_view_mul(T, dst, a, b) simd_op_name(T,view_mul) (dst, a, b)
+
+/** @brief dst = a / b over views. */
+#define simd_view_div(T, dst, a, b) simd_op_name(T,view_div) (dst, a, b)
+
+/** @brief dst = min(a, b) over views. */
+#define simd_view_min(T, dst, a, b) simd_op_name(T,view_min) (dst, a, b)
+
+/** @brief dst = max(a, b) over views. */
+#define simd_view_max(T, dst, a, b) simd_op_name(T,view_max) (dst, a, b)
+
+/** @brief dst = a + s over a view. */
+#define simd_view_add_scalar(T, dst, a, s) simd_op_name(T,view_add_scalar) (dst, a, s)
+
+/** @brief dst = a - s over a view. */
+#define simd_view_sub_scalar(T, dst, a, s) simd_op_name(T,view_sub_scalar) (dst, a, s)
+
+/** @brief dst = a * s over a view. */
+#define simd_view_mul_scalar(T, dst, a, s) simd_op_name(T,view_mul_scalar) (dst, a, s)
+
+/** @brief dst = a / s over a view. */
+#define simd_view_div_scalar(T, dst, a, s) simd_op_name(T,view_div_scalar) (dst, a, s)
+
+/** @brief dst = min(a, s) over a view. */
+#define simd_view_min_scalar(T, dst, a, s) simd_op_name(T,view_min_scalar) (dst, a, s)
+
+/** @brief dst = max(a, s) over a view. */
+#define simd_view_max_scalar(T, dst, a, s) simd_op_name(T,view_max_scalar) (dst, a, s)
+
+/** @brief dst = a over views of any strides (pack, unpack, transpose). */
+#define simd_view_copy(T, dst, a) simd_op_name(T,view_copy) (dst, a)
+
+/** @brief Sum of every element of a view. */
+#define simd_view_sum(T, a) simd_op_name(T,view_sum) (a)
+
+/* -------------------------------------------------------------------------
+ * SIMD division by invariant integers
+ * ------------------------------------------------------------------------- */
+
+/**
+ * @brief Name of the precomputed divider type for integer type T.
+ *
+ * Example:
+ *   simd_divider_t(uint32_t) → simd_divider_uint32_t_t
+ */
+#define simd_divider_t(T) PPCAT(simd_divider_,PPCAT(T,_t))
+
+/**
+ * @brief Unsigned integer type twice as wide as T, used for high products.
+ *
+ * Example:
+ *   simd_uwide_of(uint32_t) → uint64_t, simd_uwide_of(int64_t) → unsigned __int128
+ */
+#ifdef __cplusplus
+#define simd_uwide_of(T) simd_int_of_size<sizeof(T)>::w
+#else
+#define simd_uwide_of(T) \
+    __typeof__(__builtin_choose_expr(sizeof(T) == 1, (uint16_t)0, \
+               __builtin_choose_expr(sizeof(T) == 2, (uint32_t)0, \
+               __builtin_choose_expr(sizeof(T) == 4, (uint64_t)0, (unsigned __int128)0))))
+#endif
+
+/**
+ * @brief One lane of decl_simd_divider's division: c.v[i] = a.v[i] / d.
+ *
+ * Used by decl_simd_divider(); not meant to be expanded directly. The
+ * sign of a signed lane comes from its top bit, so unsigned T never
+ * compares against zero.
+ */
+#define simd_div_const_lane(T, U, W, a, dv, c, i) \
+    U sign = simd_is_signed(T) ? (U)((U)0 - (U)((U)a.v[i] >> (8 * sizeof(T) - 1))) : 0; \
+    U n = ((U)a.v[i] ^ sign) - sign; \
+    U t = (U)(((W)n * dv.magic) >> (8 * sizeof(T))); \
+    U q = (U)(t + (U)((U)(n - t) >> dv.sh1)) >> dv.sh2; \
+    sign ^= (U)dv.neg; \
+    c.v[i] = (T)((q ^ sign) - sign);
+
+/**
+ * @brief Define division and remainder by a runtime-invariant divisor for T.
+ *
+ * @tparam T 8/16/32/64-bit signed or unsigned integer; requires decl_simd_t(T)
+ *
+ * Declares the divider
+ *   simd_divider_t(T) { simd_uint_of(T) magic, d; unsigned char sh1, sh2; T neg; }
+ * and:
+ *   simd_divider_t(T) divider_simd_v{T}{XLEN}_t(T d)
+ *   simd_t(T)         div_const_simd_v{T}{XLEN}_t(simd_t(T) a, simd_divider_t(T) dv)
+ *   simd_t(T)         mod_const_simd_v{T}{XLEN}_t(simd_t(T) a, simd_divider_t(T) dv)
+ *
+ * Division uses the Granlund-Montgomery round-up method: with
+ * L = ceil(log2 d) and N = 8*sizeof(T),
+ *   m = floor(2^N * (2^L - d) / d) + 1
+ *   t = mulhi(m, n),  q = (t + ((n - t) >> min(L, 1))) >> max(L - 1, 0)
+ * which is exact for every n and every d >= 1 with one multiply, one
+ * subtract and three shifts per lane, and no branches. The high product
+ * comes from a multiply in the next wider type. 8/16/32-bit lanes run a
+ * rolled lane loop, whose widening multiply the loop vectorizer turns
+ * into pmulhuw/pmuludq even when the kernel is not inlined. 64-bit lanes
+ * need a 128-bit product per lane and stay unrolled.
+ *
+ * Signed T divides magnitudes and restores the sign, giving C's truncating
+ * division and a remainder with the sign of the dividend. d must be
+ * non-zero; dividing the minimum value by -1 wraps instead of trapping.
+ *
+ * Example:
+ *   decl_simd_divider(uint32_t)
+ *   simd_divider_t(uint32_t) by7 = simd_divider(uint32_t, 7);
+ *   simd_t(uint32_t) q = simd_apply_div_const(uint32_t, v, by7);
+ */
+#define decl_simd_divider(T) \
+typedef struct simd_divider_t(T) { \
+    simd_uint_of(T) magic, d; \
+    unsigned char sh1, sh2; \
+    T neg; \
+} simd_divider_t(T); \
+SIMD_FUNC simd_divider_t(T) SIMD_CALLCONV simd_op_name(T,divider) (T d) { \
+    typedef simd_uint_of(T) U; \
+    typedef simd_uwide_of(T) W; \
+    const U dneg = simd_is_signed(T) ? (U)((U)d >> (8 * sizeof(T) - 1)) : 0; \
+    simd_divider_t(T) dv; \
+    dv.neg = (T)((U)0 - dneg); \
+    dv.d = dneg ? (U)((U)0 - (U)d) : (U)d; \
+    int l = dv.d > 1 ? 64 - __builtin_clzll((unsigned long long)(dv.d - 1)) : 0; \
+    dv.magic = (U)((((W)1 << (8 * sizeof(T))) * (((W)1 << l) - dv.d)) / dv.d + 1); \
+    dv.sh1 = (unsigned char)(l < 1 ? l : 1); \
+    dv.sh2 = (unsigned char)(l > 1 ? l - 1 : 0); \
+    return dv; \
+} \
+SIMD_FUNC simd_t(T) SIMD_CALLCONV simd_op_name(T,div_const) (simd_t(T) a, simd_divider_t(T) dv) { \
+    typedef simd_uint_of(T) U; \
+    typedef simd_uwide_of(T) W; \
+    simd_t(T) c; \
+    if (sizeof(T) < 8) { \
+        simd_for_lanes_rolled(T, i) { simd_div_const_lane(T, U, W, a, dv, c, i) } \
+    } else { \
+        simd_for_lanes(T, i) { simd_div_const_lane(T, U, W, a, dv, c, i) } \
+    } \
+    return c; \
+} \
+SIMD_FUNC simd_t(T) SIMD_CALLCONV simd_op_name(T,mod_const) (simd_t(T) a, simd_divider_t(T) dv) { \
+    typedef simd_uint_of(T) U; \
+    simd_t(T) q = simd_op_name(T,div_const)(a, dv); \
+    U d = ((dv.d ^ (U)dv.neg) - (U)dv.neg); \
+    simd_for_lanes(T, i) { \
+        q.v[i] = (T)((U)a.v[i] - (U)q.v[i] * d); \
+    } \
+    return q; \
+}
+
+/** @brief Precompute a divider for d != 0 (requires decl_simd_divider(T)). */
+#define simd_divider(T, d) simd_op_name(T,divider) (d)
+
+/** @brief Lane-wise a.v[i] / d using a divider from simd_divider(T, d). */
+#define simd_apply_div_const(T, a, dv) simd_op_name(T,div_const) (a, dv)
+
+/** @brief Lane-wise a.v[i] % d using a divider from simd_divider(T, d). */
+#define simd_apply_mod_const(T, a, dv) simd_op_name(T,mod_const) (a, dv)
+
+/* -------------------------------------------------------------------------
+ * SIMD fixed-point (Q15 / Q31) arithmetic
+ * ------------------------------------------------------------------------- */
+
+/**
+ * @brief SIMD types holding Q15 (int16_t) and Q31 (int32_t) lanes.
+ *
+ * Q15 represents x / 2^15 in [-1, 1); Q31 represents x / 2^31.
+ * Require decl_simd_t(int16_t) and decl_simd_t(int32_t) respectively.
+ */
+#define simd_q15_t simd_t(int16_t)
+#define simd_q31_t simd_t(int32_t)
+
+/**
+ * @brief Lane-wise saturating fixed-point operation in a wider type.
+ *
+ * @tparam T Lane type (int16_t or int32_t)
+ * @param W Signed type wide enough for expr (int32_t or int64_t)
+ * @param expr Expression of the widened lanes x and y
+ *
+ * Helper of the simd_q15_* / simd_q31_* macros: evaluates expr in W and
+ * saturates the result to the range of T.
+ */
+#define simd_q_sat_op(T, W, a, b, expr) \
+({ \
+    simd_t(T) _q_a = (a), _q_b = (b); \
+    const W _q_max = (W)(((uint64_t)1 << (8 * sizeof(T) - 1)) - 1); \
+    simd_for_lanes(T, i) { \
+        W x = _q_a.v[i], y = _q_b.v[i]; \
+        W _q_r = expr; \
+        _q_r = _q_r > _q_max ? _q_max : _q_r; \
+        _q_r = _q_r < -_q_max - 1 ? -_q_max - 1 : _q_r; \
+        _q_a.v[i] = (T)_q_r; \
+    } \
+    _q_a; \
+})
+
+/**
+ * @brief Q15 rounding multiply: sat((a * b + 2^14) >> 15) per lane.
+ *
+ * Same rounding as x86 pmulhrsw and ARM vqrdmulh; like vqrdmulh the single
+ * overflowing case, -1 * -1, saturates to 0x7fff instead of wrapping.
+ */
+#define simd_q15_mul(a, b) simd_q_sat_op(int16_t, int32_t, a, b, (x * y + (1 << 14)) >> 15)
+
+/** @brief Q15 saturating addition. */
+#define simd_q15_add(a, b) simd_q_sat_op(int16_t, int32_t, a, b, x + y)
+
+/** @brief Q15 saturating subtraction. */
+#define simd_q15_sub(a, b) simd_q_sat_op(int16_t, int32_t, a, b, x - y)
+
+/** @brief Q31 rounding multiply: sat((a * b + 2^30) >> 31) per lane. */
+#define simd_q31_mul(a, b) \
+    simd_q_sat_op(int32_t, int64_t, a, b, (x * y + ((int64_t)1 << 30)) >> 31)
+
+/** @brief Q31 saturating addition. */
+#define simd_q31_add(a, b) simd_q_sat_op(int32_t, int64_t, a, b, x + y)
+
+/** @brief Q31 saturating subtraction. */
+#define simd_q31_sub(a, b) simd_q_sat_op(int32_t, int64_t, a, b, x - y)
+
+/**
+ * @brief Define float to Q-format conversion of one lane.
+ *
+ * Helper of decl_simd_fixed_ops. Rounds x * 2^FRAC half away from zero and
+ * saturates to T, matching lroundf bit for bit. The scaling is exact; the
+ * rounding adds copysign(0.5 - 2^-25, y) and truncates, the same trick
+ * simd_apply_round uses. Adding 0.5 itself would round twice: in the add,
+ * then in the truncation. That turned 0.49999997 into 1 and every odd
+ * value in [2^23, 2^24) into the next even one. The range test and the
+ * selects work on the IEEE bit patterns, so the loop vectorizes (float
+ * compares feeding a conversion are not if-converted under
+ * -ftrapping-math). NaN converts to 0.
+ */
+#define decl_simd_q_from_float(T, name, FRAC) \
+SIMD_FUNC void SIMD_CALLCONV simd_op_name(T,name) (const float *x, size_t n, T *out) { \
+    const union { float f; uint32_t u; } half = { 0.5f - 0x1p-25f }, \
+                                         lim = { (float)((uint64_t)1 << FRAC) }; \
+    const int32_t max = (int32_t)(((uint64_t)1 << FRAC) - 1); \
+    for (size_t i = 0; i < n; i++) { \
+        union { float f; uint32_t u; } v = { x[i] }, h, y; \
+        h.u = half.u | (v.u & 0x80000000u); \
+        y.f = v.f * (float)((uint64_t)1 << FRAC) + h.f; \
+        uint32_t mag = y.u & 0x7fffffffu; \
+        uint32_t msat = -(uint32_t)(mag >= lim.u); \
+        uint32_t mnan = -(uint32_t)(mag > 0x7f800000u); \
+        y.u &= ~msat; \
+        int32_t k = (int32_t)y.f; \
+        int32_t sat = max ^ -(int32_t)(v.u >> 31); \
+        k = (int32_t)(((uint32_t)k & ~msat) | ((uint32_t)sat & msat)) & (int32_t)~mnan; \
+        out[i] = (T)k; \
+    } \
+}
+
+/**
+ * @brief Define Q15/Q31 conversion, dot product and FIR kernels.
+ *
+ * Requires decl_simd_t(int16_t). Expand once per program (per XLEN).
+ *
+ * Declares:
+ *   void    q15_from_float_simd_vint16_t{XLEN}_t(const float *x, size_t n, int16_t *out)
+ *   void    q15_to_float_simd_vint16_t{XLEN}_t(const int16_t *q, size_t n, float *out)
+ *   void    q31_from_float_simd_vint32_t{XLEN}_t(const float *x, size_t n, int32_t *out)
+ *   void    q31_to_float_simd_vint32_t{XLEN}_t(const int32_t *q, size_t n, float *out)
+ *   int64_t q15_dot_simd_vint16_t{XLEN}_t(const int16_t *a, const int16_t *b, size_t n)
+ *   void    q15_fir_simd_vint16_t{XLEN}_t(const int16_t *x, size_t n, const int16_t *h,
+ *                                         size_t taps, int16_t *y)
+ *
+ * Conversions from float round half away from zero and saturate.
+ * q15_dot returns the exact sum of the Q30 products: products are formed
+ * in 32 bits and accumulated in 64-bit lanes, so it never overflows.
+ * q15_fir computes the n - taps + 1 fully overlapped outputs
+ *   y[i] = sat(round(sum_k h[k] * x[i + taps - 1 - k] / 2^15))
+ * with the same 64-bit accumulation, VLEN(int16_t) outputs at a time.
+ *
+ * Example:
+ *   decl_simd_t(int16_t)
+ *   decl_simd_t(int32_t)
+ *   decl_simd_fixed_ops()
+ *   simd_q15_fir(signal, n, coeffs, taps, filtered);
+ */
+#define decl_simd_fixed_ops() \
+decl_simd_q_from_float(int16_t, q15_from_float, 15) \
+decl_simd_q_from_float(int32_t, q31_from_float, 31) \
+SIMD_FUNC void SIMD_CALLCONV \
+simd_op_name(int16_t,q15_to_float) (const int16_t *q, size_t n, float *out) { \
+    for (size_t i = 0; i < n; i++) { \
+        out[i] = (float)q[i] * (1.0f / 32768.0f); \
+    } \
+} \
+SIMD_FUNC void SIMD_CALLCONV \
+simd_op_name(int32_t,q31_to_float) (const int32_t *q, size_t n, float *out) { \
+    for (size_t i = 0; i < n; i++) { \
+        out[i] = (float)q[i] * (1.0f / 2147483648.0f); \
+    } \
+} \
+SIMD_FUNC int64_t SIMD_CALLCONV \
+simd_op_name(int16_t,q15_dot) (const int16_t *a, const int16_t *b, size_t n) { \
+    int64_t acc[VLEN(int16_t)] = {0}; \
+    size_t i = 0; \
+    for (; i + VLEN(int16_t) <= n; i += VLEN(int16_t)) { \
+        simd_t(int16_t) va = simd_load(int16_t, a + i), vb = simd_load(int16_t, b + i); \
+        simd_for_lanes(int16_t, k) { \
+            acc[k] += (int32_t)va.v[k] * vb.v[k]; \
+        } \
+    } \
+    int64_t r = 0; \
+    simd_for_lanes(int16_t, k) { \
+        r += acc[k]; \
+    } \
+    for (; i < n; i++) { \
+        r += (int32_t)a[i] * b[i]; \
+    } \
+    return r; \
+} \
+SIMD_FUNC void SIMD_CALLCONV \
+simd_op_name(int16_t,q15_fir) (const int16_t *x, size_t n, const int16_t *h, \
+                               size_t taps, int16_t *y) { \
+    if (taps == 0 || n < taps) { \
+        return; \
+    } \
+    size_t nout = n - taps + 1; \
+    for (size_t i = 0; i < nout; i += VLEN(int16_t)) { \
+        size_t len = nout - i < VLEN(int16_t) ? nout - i : VLEN(int16_t); \
+        int64_t acc[VLEN(int16_t)] = {0}; \
+        if (len == VLEN(int16_t)) { \
+            for (size_t k = 0; k < taps; k++) { \
+                simd_t(int16_t) vx = simd_load(int16_t, x + i + taps - 1 - k); \
+                simd_for_lanes(int16_t, j) { \
+                    acc[j] += (int32_t)h[k] * vx.v[j]; \
+                } \
+            } \
+        } else { \
+            for (size_t k = 0; k < taps; k++) { \
+                for (size_t j = 0; j < len; j++) { \
+                    acc[j] += (int32_t)h[k] * x[i + j + taps - 1 - k]; \
+                } \
+            } \
+        } \
+        for (size_t j = 0; j < len; j++) { \
+            int64_t r = (acc[j] + (1 << 14)) >> 15; \
+            y[i + j] = (int16_t)(r > 32767 ? 32767 : r < -32768 ? -32768 : r); \
+        } \
+    } \
+}
+
+/** @brief Convert floats to saturated Q15 (requires decl_simd_fixed_ops()). */
+#define simd_q15_from_float(x, n, out) simd_op_name(int16_t,q15_from_float) (x, n, out)
+
+/** @brief Convert Q15 values to float. */
+#define simd_q15_to_float(q, n, out) simd_op_name(int16_t,q15_to_float) (q, n, out)
+
+/** @brief Convert floats to saturated Q31. */
+#define simd_q31_from_float(x, n, out) simd_op_name(int32_t,q31_from_float) (x, n, out)
+
+/** @brief Convert Q31 values to float. */
+#define simd_q31_to_float(q, n, out) simd_op_name(int32_t,q31_to_float) (q, n, out)
+
+/** @brief Exact Q30 dot product of two Q15 arrays. */
+#define simd_q15_dot(a, b, n) simd_op_name(int16_t,q15_dot) (a, b, n)
+
+/** @brief Q15 FIR filter producing n - taps + 1 outputs. */
+#define simd_q15_fir(x, n, h, taps, y) simd_op_name(int16_t,q15_fir) (x, n, h, taps, y)
+
+/* -------------------------------------------------------------------------
+ * SIMD memory-mapped array files
+ * ------------------------------------------------------------------------- */
+
+/** @brief File magic of the array format, including its terminating NUL. */
+#define SIMD_FILE_MAGIC "SIMDARR"
+
+/** @brief Version written to and accepted from simd_file_header_t. */
+#define SIMD_FILE_VERSION 1
+
+/**
+ * @brief Alignment of the payload in bytes; a multiple of XLEN / 8.
+ *
+ * The writer starts the payload at this offset, so a mapping of the file
+ * (page aligned) places element 0 on a SIMD_FILE_ALIGN boundary.
+ */
+#ifndef SIMD_FILE_ALIGN
+#define SIMD_FILE_ALIGN 4096
+#endif
+
+/**
+ * @brief On-disk header of a simd array file.
+ *
+ * Fields are in the writer's native byte order. The payload holds count
+ * elements of elem_size bytes at offset, zero padded to a whole number of
+ * the writer's XLEN-bit vectors.
+ */
+typedef struct simd_file_header_t {
+    char     magic[8];      /* SIMD_FILE_MAGIC */
+    uint32_t version;       /* SIMD_FILE_VERSION */
+    uint32_t elem_size;     /* sizeof(T) */
+    char     elem_type[24]; /* T as spelled by the writer, NUL padded */
+    uint32_t xlen;          /* XLEN of the writer */
+    uint32_t align;         /* payload alignment in bytes */
+    uint64_t count;         /* number of elements */
+    uint64_t offset;        /* payload offset from the start of the file */
+} simd_file_header_t;
+
+/** @brief madvise(MADV_SEQUENTIAL): read ahead aggressively, reclaim early. */
+#define SIMD_MMAP_SEQUENTIAL 1
+/** @brief madvise(MADV_RANDOM): no read-ahead. */
+#define SIMD_MMAP_RANDOM     2
+/** @brief madvise(MADV_WILLNEED): start reading the whole range now. */
+#define SIMD_MMAP_WILLNEED   4
+/** @brief madvise(MADV_HUGEPAGE) where the kernel offers it; ignored elsewhere. */
+#define SIMD_MMAP_HUGEPAGE   8
+/** @brief mmap(MAP_POPULATE): fault in every page before returning (Linux). */
+#define SIMD_MMAP_POPULATE  16
+/** @brief Stream reader: drop consumed windows from the page cache. */
+#define SIMD_MMAP_DROP      32
+
+/**
+ * @brief A whole-file read-only mapping opened by simd_mmap_open.
+ */
+typedef struct simd_mmap_t {
+    void       *base;  /* start of the mapping (the header) */
+    size_t      size;  /* mapped bytes */
+    const void *data;  /* first element, SIMD_FILE_ALIGN aligned */
+    size_t      count; /* number of elements */
+} simd_mmap_t;
+
+/**
+ * @brief A sliding-window reader opened by simd_mmap_stream_open.
+ */
+typedef struct simd_mmap_stream_t {
+    int      fd;
+    int      flags;
+    size_t   elem_size;
+    size_t   window;   /* bytes mapped per step, a multiple of the page size */
+    uint64_t offset;   /* payload offset */
+    uint64_t count;    /* number of elements */
+    uint64_t pos;      /* elements already returned */
+    void    *map;      /* current window mapping, or NULL */
+    size_t   map_len;
+    uint64_t map_off;  /* file offset of map */
+} simd_mmap_stream_t;
+
+/**
+ * @brief Define the array file writer, the mapping and the stream reader.
+ *
+ * POSIX only (mmap, madvise, pread); expand once per program. Strict ISO
+ * modes such as -std=c11 hide some of those declarations, so a program
+ * that expands this macro needs a GNU dialect or _DEFAULT_SOURCE defined
+ * before any include. Merely including the header is fine in strict
+ * modes: the allocator then falls back to malloc (see SIMD_MAP_ANON) and
+ * simd_numa_mbind to ENOSYS.
+ *
+ * Declares (besides the helpers simd_file_check and simd_mmap_advise):
+ *   int         simd_mmap_write_raw(const char *path, const char *type, size_t size,
+ *                                   const void *data, size_t n)
+ *   const void *simd_mmap_open_raw(simd_mmap_t *m, const char *path, const char *type,
+ *                                  size_t size, int flags)
+ *   void        simd_mmap_close(simd_mmap_t *m)
+ *   int         simd_mmap_stream_open_raw(simd_mmap_stream_t *s, const char *path,
+ *                                         const char *type, size_t size,
+ *                                         size_t window, int flags)
+ *   const void *simd_mmap_stream_next_raw(simd_mmap_stream_t *s, size_t *n)
+ *   void        simd_mmap_stream_close(simd_mmap_stream_t *s)
+ * used through the typed macros simd_mmap_write, simd_mmap_open,
+ * simd_mmap_stream_open and simd_mmap_stream_next.
+ *
+ * Opening checks the magic, version, element type name and size, and that
+ * the file holds the whole payload. Failures return -1 or NULL with errno
+ * set (EINVAL for a file that is not a matching array). The mapping is
+ * MAP_SHARED and read-only, so kernels read the page cache directly with
+ * no copy; the flags are SIMD_MMAP_* hints, and a hint the system rejects
+ * is ignored.
+ *
+ * The stream reader maps one window of the payload at a time, for files
+ * larger than memory or address space: each next call unmaps the previous
+ * window (and with SIMD_MMAP_DROP also evicts it from the page cache) and
+ * returns the following elements. When sizeof(T) divides XLEN / 8, every
+ * chunk but the last is a multiple of VLEN(T) elements and starts on a
+ * vector boundary of the payload; a chunk holds at least one element even
+ * when T is larger than the window.
+ *
+ * Example:
+ *   decl_simd_mmap_ops()
+ *   simd_mmap_write("x.simd", float, x, n);
+ *   simd_mmap_t m;
+ *   const simd_t(float) *v = simd_mmap_open(&m, "x.simd", float, SIMD_MMAP_SEQUENTIAL);
+ *   float total = simd_array_sum(float, (const float *)v, m.count);
+ *   simd_mmap_close(&m);
+ */
+#if defined(__unix__) || defined(__APPLE__)
+#define decl_simd_mmap_ops() \
+SIMD_FUNC int SIMD_CALLCONV \
+simd_file_check(const simd_file_header_t *h, const char *type, size_t size, uint64_t file_size) { \
+    if (memcmp(h->magic, SIMD_FILE_MAGIC, sizeof(SIMD_FILE_MAGIC)) != 0 || \
+        h->version != SIMD_FILE_VERSION || h->elem_size != size || \
+        strncmp(h->elem_type, type, sizeof(h->elem_type)) != 0 || \
+        h->offset < sizeof(*h) || h->offset > file_size || \
+        h->count > (file_size - h->offset) / size) { \
+        errno = EINVAL; \
+        return -1; \
+    } \
+    return 0; \
+} \
+SIMD_FUNC void SIMD_CALLCONV simd_mmap_advise(void *p, size_t len, int flags) { \
+    if (flags & SIMD_MMAP_SEQUENTIAL) (void)madvise(p, len, MADV_SEQUENTIAL); \
+    if (flags & SIMD_MMAP_RANDOM) (void)madvise(p, len, MADV_RANDOM); \
+    if (flags & SIMD_MMAP_WILLNEED) (void)madvise(p, len, MADV_WILLNEED); \
+    simd_mmap_advise_hugepage(p, len, flags); \
+} \
+SIMD_FUNC int SIMD_CALLCONV \
+simd_mmap_write_raw(const char *path, const char *type, size_t size, const void *data, size_t n) { \
+    static const char zero[SIMD_FILE_ALIGN] = {0}; \
+    simd_file_header_t h; \
+    size_t bytes = n * size, pad = (XLEN / 8 - bytes % (XLEN / 8)) % (XLEN / 8); \
+    memset(&h, 0, sizeof(h)); \
+    memcpy(h.magic, SIMD_FILE_MAGIC, sizeof(SIMD_FILE_MAGIC)); \
+    h.version = SIMD_FILE_VERSION; \
+    h.elem_size = (uint32_t)size; \
+    strncpy(h.elem_type, type, sizeof(h.elem_type) - 1); \
+    h.xlen = XLEN; \
+    h.align = SIMD_FILE_ALIGN; \
+    h.count = n; \
+    h.offset = (sizeof(h) + SIMD_FILE_ALIGN - 1) / SIMD_FILE_ALIGN * SIMD_FILE_ALIGN; \
+    FILE *f = fopen(path, "wb"); \
+    if (!f) { \
+        return -1; \
+    } \
+    int ok = fwrite(&h, sizeof(h), 1, f) == 1 && \
+             fwrite(zero, 1, h.offset - sizeof(h), f) == h.offset - sizeof(h) && \
+             fwrite(data, 1, bytes, f) == bytes && \
+             fwrite(zero, 1, pad, f) == pad; \
+    if (fclose(f) != 0 || !ok) { \
+        return -1; \
+    } \
+    return 0; \
+} \
+SIMD_FUNC const void * SIMD_CALLCONV \
+simd_mmap_open_raw(simd_mmap_t *m, const char *path, const char *type, size_t size, int flags) { \
+    struct stat st; \
+    int fd = open(path, O_RDONLY); \
+    if (fd < 0) { \
+        return NULL; \
+    } \
+    if (fstat(fd, &st) != 0) { \
+        close(fd); \
+        return NULL; \
+    } \
+    if ((size_t)st.st_size < sizeof(simd_file_header_t)) { \
+        close(fd); \
+        errno = EINVAL; \
+        return NULL; \
+    } \
+    int mflags = MAP_SHARED; \
+    simd_mmap_populate_flag(mflags, flags); \
+    void *base = mmap(NULL, (size_t)st.st_size, PROT_READ, mflags, fd, 0); \
+    close(fd); \
+    if (base == MAP_FAILED) { \
+        return NULL; \
+    } \
+    const simd_file_header_t *h = (const simd_file_header_t *)base; \
+    if (simd_file_check(h, type, size, (uint64_t)st.st_size) != 0) { \
+        munmap(base, (size_t)st.st_size); \
+        return NULL; \
+    } \
+    m->base = base; \
+    m->size = (size_t)st.st_size; \
+    m->data = (const char *)base + h->offset; \
+    m->count = (size_t)h->count; \
+    simd_mmap_advise(base, m->size, flags); \
+    return m->data; \
+} \
+SIMD_FUNC void SIMD_CALLCONV simd_mmap_close(simd_mmap_t *m) { \
+    if (m->base) { \
+        munmap(m->base, m->size); \
+    } \
+    m->base = NULL; \
+    m->data = NULL; \
+    m->size = m->count = 0; \
+} \
+SIMD_FUNC int SIMD_CALLCONV \
+simd_mmap_stream_open_raw(simd_mmap_stream_t *s, const char *path, const char *type, \
+                          size_t size, size_t window, int flags) { \
+    simd_file_header_t h; \
+    struct stat st; \
+    size_t page = (size_t)sysconf(_SC_PAGESIZE); \
+    memset(s, 0, sizeof(*s)); \
+    s->fd = open(path, O_RDONLY); \
+    if (s->fd < 0) { \
+        return -1; \
+    } \
+    int err = fstat(s->fd, &st) != 0 ? errno : \
+              pread(s->fd, &h, sizeof(h), 0) != (ssize_t)sizeof(h) ? EINVAL : \
+              simd_file_check(&h, type, size, (uint64_t)st.st_size) != 0 ? EINVAL : 0; \
+    if (err) { \
+        close(s->fd); \
+        s->fd = -1; \
+        errno = err; \
+        return -1; \
+    } \
+    s->flags = flags; \
+    s->elem_size = size; \
+    s->window = window < page ? page : window / page * page; \
+    s->offset = h.offset; \
+    s->count = h.count; \
+    return 0; \
+} \
+SIMD_FUNC const void * SIMD_CALLCONV simd_mmap_stream_next_raw(simd_mmap_stream_t *s, size_t *n) { \
+    size_t page = (size_t)sysconf(_SC_PAGESIZE); \
+    if (s->map) { \
+        munmap(s->map, s->map_len); \
+        simd_mmap_drop(s->fd, s->map_off, s->map_len, s->flags); \
+        s->map = NULL; \
+    } \
+    if (s->pos >= s->count) { \
+        *n = 0; \
+        return NULL; \
+    } \
+    uint64_t off = s->offset + s->pos * s->elem_size; \
+    uint64_t off0 = off / page * page; \
+    size_t lead = (size_t)(off - off0); \
+    uint64_t left = s->count - s->pos; \
+    uint64_t vl = (XLEN / 8) % s->elem_size ? 1 : XLEN / 8 / s->elem_size; \
+    uint64_t take = (s->window - lead) / s->elem_size / vl * vl; \
+    take = take ? take : 1; \
+    take = take < left ? take : left; \
+    s->map_len = lead + (size_t)take * s->elem_size; \
+    s->map_off = off0; \
+    s->map = mmap(NULL, s->map_len, PROT_READ, MAP_SHARED, s->fd, (off_t)off0); \
+    if (s->map == MAP_FAILED) { \
+        s->map = NULL; \
+        *n = 0; \
+        return NULL; \
+    } \
+    simd_mmap_advise(s->map, s->map_len, s->flags); \
+    s->pos += take; \
+    *n = (size_t)take; \
+    return (const char *)s->map + lead; \
+} \
+SIMD_FUNC void SIMD_CALLCONV simd_mmap_stream_close(simd_mmap_stream_t *s) { \
+    if (s->map) { \
+        munmap(s->map, s->map_len); \
+        s->map = NULL; \
+    } \
+    if (s->fd >= 0) { \
+        close(s->fd); \
+    } \
+    s->fd = -1; \
+}
+#endif
+
+/**
+ * @brief Apply SIMD_MMAP_HUGEPAGE to a mapping (helper of decl_simd_mmap_ops).
+ */
+#ifdef MADV_HUGEPAGE
+#define simd_mmap_advise_hugepage(p, len, flags) \
+    ((flags) & SIMD_MMAP_HUGEPAGE ? (void)madvise(p, len, MADV_HUGEPAGE) : (void)0)
+#else
+#define simd_mmap_advise_hugepage(p, len, flags) ((void)0)
+#endif
+
+/**
+ * @brief Add MAP_POPULATE to mflags for SIMD_MMAP_POPULATE (helper of decl_simd_mmap_ops).
+ */
+#ifdef MAP_POPULATE
+#define simd_mmap_populate_flag(mflags, flags) \
+    ((flags) & SIMD_MMAP_POPULATE ? (void)((mflags) |= MAP_POPULATE) : (void)0)
+#else
+#define simd_mmap_populate_flag(mflags, flags) ((void)0)
+#endif
+
+/**
+ * @brief Evict a consumed stream window for SIMD_MMAP_DROP (helper of decl_simd_mmap_ops).
+ */
+#ifdef POSIX_FADV_DONTNEED
+#define simd_mmap_drop(fd, off, len, flags) \
+    ((flags) & SIMD_MMAP_DROP ? (void)posix_fadvise(fd, (off_t)(off), (off_t)(len), \
+                                                    POSIX_FADV_DONTNEED) : (void)0)
+#else
+#define simd_mmap_drop(fd, off, len, flags) ((void)0)
+#endif
+
+/** @brief Write n elements of T as an array file; returns 0 or -1 with errno. */
+#define simd_mmap_write(path, T, data, n) \
+    simd_mmap_write_raw(path, PPSTR(T), sizeof(T), data, n)
+
+/**
+ * @brief Map an array file of T read-only; returns its simd_t(T) payload or NULL.
+ *
+ * m receives the mapping and the element count; release it with
+ * simd_mmap_close(m). flags is a combination of SIMD_MMAP_* hints.
+ */
+#define simd_mmap_open(m, path, T, flags) \
+    ((const simd_t(T) *)simd_mmap_open_raw(m, path, PPSTR(T), sizeof(T), flags))
+
+/**
+ * @brief Open a windowed reader of an array file of T; returns 0 or -1.
+ *
+ * window is the number of bytes mapped at a time (rounded to pages).
+ */
+#define simd_mmap_stream_open(s, path, T, window, flags) \
+    simd_mmap_stream_open_raw(s, path, PPSTR(T), sizeof(T), window, flags)
+
+/** @brief Next chunk of a stream as const T *, its length in *n; NULL at the end. */
+#define simd_mmap_stream_next(T, s, n) ((const T *)simd_mmap_stream_next_raw(s, n))
+
+/* -------------------------------------------------------------------------
+ * SIMD aligned allocation
+ * ------------------------------------------------------------------------- */
+
+/**
+ * @brief Alignment of simd_alloc blocks: a cache line, or XLEN / 8 if larger.
+ */
+#ifndef SIMD_ALLOC_ALIGN
+#define SIMD_ALLOC_ALIGN (XLEN / 8 > 64 ? XLEN / 8 : 64)
+#endif
+
+/** @brief simd_alloc_ex flag: first-touch each page from the thread that owns it. */
+#define SIMD_ALLOC_FIRST_TOUCH 1
+/** @brief simd_alloc_ex flag: interleave the pages over all allowed NUMA nodes. */
+#define SIMD_ALLOC_INTERLEAVE  2
+/** @brief simd_alloc_ex flag: back the block with transparent huge pages. */
+#define SIMD_ALLOC_HUGEPAGE    4
+/** @brief simd_alloc_ex flag: try reserved MAP_HUGETLB pages first (implies HUGEPAGE). */
+#define SIMD_ALLOC_HUGETLB     8
+
+/**
+ * @brief Huge page size assumed by SIMD_ALLOC_HUGEPAGE / SIMD_ALLOC_HUGETLB.
+ */
+#ifndef SIMD_HUGEPAGE_SIZE
+#define SIMD_HUGEPAGE_SIZE ((size_t)2 << 20)
+#endif
+
+/**
+ * @brief mmap flag for anonymous memory: MAP_ANONYMOUS, or the older
+ *        BSD spelling MAP_ANON.
+ *
+ * Left undefined where the system headers show neither, as glibc does
+ * under -std=c11; simd_alloc_ex then takes every block from malloc.
+ */
+#if defined(MAP_ANONYMOUS)
+#define SIMD_MAP_ANON MAP_ANONYMOUS
+#elif defined(MAP_ANON)
+#define SIMD_MAP_ANON MAP_ANON
+#endif
+
+/**
+ * @brief Backing of a simd_alloc block, as returned by simd_alloc_kind.
+ */
+typedef enum simd_alloc_kind_t {
+    SIMD_ALLOC_KIND_HEAP,    /* malloc */
+    SIMD_ALLOC_KIND_PAGES,   /* anonymous mmap, base pages */
+    SIMD_ALLOC_KIND_THP,     /* huge-page aligned mmap advised MADV_HUGEPAGE */
+    SIMD_ALLOC_KIND_HUGETLB  /* MAP_HUGETLB mapping */
+} simd_alloc_kind_t;
+
+/**
+ * @brief Bookkeeping stored just below every simd_alloc block.
+ */
+typedef struct simd_alloc_hdr_t {
+    void  *base;   /* pointer returned by the underlying allocator */
+    size_t bytes;  /* usable bytes of the block */
+    size_t mapped; /* length of the mmap backing the block, 0 for malloc */
+    int    kind;   /* simd_alloc_kind_t */
+} simd_alloc_hdr_t;
+
+/**
+ * @brief Pragma of the first-touch loop of simd_alloc_ex.
+ *
+ * Uses the team, schedule and binding of the SIMD_OMP_PARALLEL array
+ * loops, so each page is faulted in by the thread whose static chunk
+ * will cover it; empty without SIMD_OMP_PARALLEL.
+ */
+#ifdef SIMD_OMP_PARALLEL
+#define simd_omp_touch(n) \
+    _Pragma(PPSTR(omp parallel for schedule(static) proc_bind(SIMD_OMP_PROC_BIND) \
+                  if((n) >= SIMD_OMP_PARALLEL_MIN)))
+#else
+#define simd_omp_touch(n)
+#endif
+
+#if defined(__linux__)
+/**
+ * @brief Apply a NUMA memory policy to [p, p + len) with the raw mbind
+ *        syscall (no libnuma).
+ *
+ * mode is a kernel MPOL_* value (3 = MPOL_INTERLEAVE) applied over every
+ * node the process may allocate from. Returns 0 on success, 1 if there
+ * is only one such node and nothing was done, and -1 if the kernel
+ * refused (ENOSYS, EPERM under seccomp, ...). The memory stays usable
+ * in every case. Strict ISO modes such as -std=c11 hide syscall(), so
+ * there it always returns -1 with errno = ENOSYS.
+ */
+static inline int simd_numa_mbind(void *p, size_t len, int mode) {
+#if defined(SYS_mbind) && defined(SYS_get_mempolicy) && \
+    (defined(_GNU_SOURCE) || defined(_DEFAULT_SOURCE) || defined(_BSD_SOURCE))
+    unsigned long mask[1024 / (8 * sizeof(unsigned long))] = {0};
+    int cur, nodes = 0;
+    if (syscall(SYS_get_mempolicy, &cur, mask, 1024UL + 1, NULL, 4UL /* MPOL_F_MEMS_ALLOWED */)) {
+        return -1;
+    }
+    for (size_t i = 0; i < sizeof(mask) / sizeof(mask[0]); i++) {
+        for (unsigned long m = mask[i]; m; m &= m - 1) {
+            nodes++;
+        }
+    }
+    if (nodes <= 1) {
+        return 1;
+    }
+    return syscall(SYS_mbind, p, len, (unsigned long)mode, mask, 1024UL + 1, 0UL) ? -1 : 0;
+#else
+    (void)p; (void)len; (void)mode;
+    errno = ENOSYS;
+    return -1;
+#endif
+}
+#endif
+
+#if defined(SIMD_MAP_ANON)
+/**
+ * @brief Anonymous mapping of at least total bytes for simd_alloc_ex_raw.
+ *
+ * Stores the mapped length in *mapped and the simd_alloc_kind_t in
+ * *kind. Huge page requests fall back one step at a time: MAP_HUGETLB,
+ * then an SIMD_HUGEPAGE_SIZE-aligned mapping advised MADV_HUGEPAGE, then
+ * base pages. Returns NULL if no mapping could be made.
+ */
+static inline char *simd_alloc_map(size_t total, int flags, size_t *mapped, int *kind) {
+    size_t page = (size_t)sysconf(_SC_PAGESIZE), huge = SIMD_HUGEPAGE_SIZE;
+    int prot = PROT_READ | PROT_WRITE, mflags = MAP_PRIVATE | SIMD_MAP_ANON;
+    char *p;
+    if (flags & (SIMD_ALLOC_HUGEPAGE | SIMD_ALLOC_HUGETLB) && total <= SIZE_MAX - 2 * huge) {
+        size_t len = (total + huge - 1) / huge * huge;
+#ifdef MAP_HUGETLB
+        if (flags & SIMD_ALLOC_HUGETLB) {
+            p = (char *)mmap(NULL, len, prot, mflags | MAP_HUGETLB, -1, 0);
+            if (p != (char *)MAP_FAILED) {
+                *mapped = len;
+                *kind = SIMD_ALLOC_KIND_HUGETLB;
+                return p;
+            }
+        }
+#endif
+#ifdef MADV_HUGEPAGE
+        /* over-map by one huge page, then trim to an aligned len */
+        p = (char *)mmap(NULL, len + huge, prot, mflags, -1, 0);
+        if (p != (char *)MAP_FAILED) {
+            char *at = (char *)(((uintptr_t)p + huge - 1) & ~(uintptr_t)(huge - 1));
+            if (at > p) {
+                munmap(p, (size_t)(at - p));
+            }
+            if (p + huge > at) {
+                munmap(at + len, (size_t)(p + huge - at));
+            }
+            madvise(at, len, MADV_HUGEPAGE);
+            *mapped = len;
+            *kind = SIMD_ALLOC_KIND_THP;
+            return at;
+        }
+#endif
+    }
+    *mapped = (total + page - 1) / page * page;
+    *kind = SIMD_ALLOC_KIND_PAGES;
+    p = (char *)mmap(NULL, *mapped, prot, mflags, -1, 0);
+    return p == (char *)MAP_FAILED ? NULL : p;
+}
+#endif
+
+/**
+ * @brief Allocate room for n elements of size bytes, aligned to
+ *        SIMD_ALLOC_ALIGN, with page and NUMA placement flags.
+ *
+ * The usable size is rounded up to whole XLEN-bit vectors, so the last
+ * simd_t(T) of the array can be loaded and stored in full. Returns NULL
+ * if the size overflows or memory is exhausted. Release with simd_free.
+ *
+ * With flags == 0 the block comes from malloc. Otherwise (on POSIX) it
+ * is a fresh anonymous mapping, zero filled, and:
+ *   - SIMD_ALLOC_HUGEPAGE aligns the mapping to SIMD_HUGEPAGE_SIZE and
+ *     advises MADV_HUGEPAGE, so large scans take few TLB misses;
+ *     SIMD_ALLOC_HUGETLB first tries MAP_HUGETLB (reserved pages, see
+ *     /proc/sys/vm/nr_hugepages). simd_alloc_kind tells what was used;
+ *   - SIMD_ALLOC_INTERLEAVE spreads its pages round-robin over the NUMA
+ *     nodes (Linux, raw mbind), for data read by every thread;
+ *   - SIMD_ALLOC_FIRST_TOUCH writes one byte per page from the OpenMP
+ *     team of the SIMD_OMP_PARALLEL kernels, in the same static
+ *     schedule, so the pages of each thread's chunk of an n-element
+ *     array are placed on that thread's node (to page granularity).
+ * When a step is not available (single NUMA node, no huge pages, not
+ * Linux, no SIMD_OMP_PARALLEL) it is skipped and the block is an
+ * ordinary aligned allocation. Without SIMD_MAP_ANON (not POSIX, or a
+ * strict ISO mode such as -std=c11) every block comes from malloc.
+ */
+static inline void *simd_alloc_ex_raw(size_t n, size_t size, int flags) {
+    size_t vec = XLEN / 8, align = SIMD_ALLOC_ALIGN;
+    if (size && n > (SIZE_MAX - align - sizeof(simd_alloc_hdr_t) - vec) / size) {
+        return NULL;
+    }
+    size_t bytes = (n * size + vec - 1) / vec * vec;
+    size_t total = bytes + align + sizeof(simd_alloc_hdr_t);
+    size_t mapped = 0;
+    int kind = SIMD_ALLOC_KIND_HEAP;
+    char *base;
+#if defined(SIMD_MAP_ANON)
+    if (flags) {
+        size_t page = (size_t)sysconf(_SC_PAGESIZE);
+        base = simd_alloc_map(total, flags, &mapped, &kind);
+        if (!base) {
+            return NULL;
+        }
+#if defined(__linux__)
+        if (flags & SIMD_ALLOC_INTERLEAVE) {
+            simd_numa_mbind(base, mapped, 3 /* MPOL_INTERLEAVE */);
+        }
+#endif
+        if (flags & SIMD_ALLOC_FIRST_TOUCH) {
+            volatile char *v = base;
+            simd_omp_touch(n)
+            for (size_t i = 0; i < mapped / page; i++) {
+                v[i * page] = 0;
+            }
+        }
+    } else
+#endif
+    {
+        (void)flags;
+        base = (char *)malloc(total);
+        if (!base) {
+            return NULL;
+        }
+    }
+    uintptr_t at = ((uintptr_t)base + sizeof(simd_alloc_hdr_t) + align - 1) & ~(uintptr_t)(align - 1);
+    simd_alloc_hdr_t *h = (simd_alloc_hdr_t *)at - 1;
+    h->base = base;
+    h->bytes = bytes;
+    h->mapped = mapped;
+    h->kind = kind;
+    return (void *)at;
+}
+
+/**
+ * @brief Backing actually obtained for a simd_alloc block (simd_alloc_kind_t).
+ */
+static inline int simd_alloc_kind(const void *p) {
+    return ((const simd_alloc_hdr_t *)p - 1)->kind;
+}
+
+/**
+ * @brief Allocate room for n elements of size bytes, aligned to SIMD_ALLOC_ALIGN.
+ *
+ * simd_alloc_ex_raw without placement flags.
+ */
+static inline void *simd_alloc_raw(size_t n, size_t size) {
+    return simd_alloc_ex_raw(n, size, 0);
+}
+
+/**
+ * @brief Release a block from simd_alloc_raw / simd_alloc / simd_alloc_ex;
+ *        NULL is ignored.
+ */
+static inline void simd_free(void *p) {
+    if (p) {
+        simd_alloc_hdr_t *h = (simd_alloc_hdr_t *)p - 1;
+#if defined(__unix__) || defined(__APPLE__)
+        if (h->mapped) {
+            munmap(h->base, h->mapped);
+            return;
+        }
+#endif
+        free(h->base);
+    }
+}
+
+/**
+ * @brief Allocate an aligned array of n elements of T (see simd_alloc_raw).
+ *
+ * Example:
+ *   float *x = simd_alloc(float, n);
+ *   ...
+ *   simd_free(x);
+ */
+#define simd_alloc(T, n) ((T *)simd_alloc_raw(n, sizeof(T)))
+
+/**
+ * @brief Allocate an aligned array of n elements of T with NUMA placement
+ *        flags (see simd_alloc_ex_raw).
+ *
+ * Example (threads bound with OMP_PLACES=cores):
+ *   float *x = simd_alloc_ex(float, n, SIMD_ALLOC_FIRST_TOUCH);
+ *   simd_array_add(float, x, x, y, n);   // same static chunks per thread
+ *   simd_free(x);
+ */
+#define simd_alloc_ex(T, n, flags) ((T *)simd_alloc_ex_raw(n, sizeof(T), flags))
+
+/* -------------------------------------------------------------------------
+ * SIMD streaming block pipeline
+ * ------------------------------------------------------------------------- */
+
+/** @brief Default block size of a pipeline in bytes, sized to stay in L1. */
+#ifndef SIMD_PIPE_BLOCK
+#define SIMD_PIPE_BLOCK 16384
+#endif
+
+/** @brief Maximum number of stages of a pipeline. */
+#ifndef SIMD_PIPE_MAX_STAGES
+#define SIMD_PIPE_MAX_STAGES 16
+#endif
+
+/**
+ * @brief Name of the pipeline type for element type T.
+ *
+ * Example:
+ *   simd_pipe_t(float) → simd_pipe_simd_vfloat128_t
+ */
+#define simd_pipe_t(T) PPCAT(simd_pipe_,simd_t(T))
+
+/**
+ * @brief Name of the stage function type of simd_pipe_t(T).
+ *
+ * A stage transforms a block in place:
+ *   void stage(simd_t(T) *v, size_t n, size_t pos, const void *arg)
+ * where v holds n valid elements (the last vector zero padded past n),
+ * pos is the index of v's first element in the whole stream and arg is
+ * the pointer given to simd_pipe_add.
+ */
+#define simd_pipe_stage_t(T) PPCAT(simd_pipe_stage_,simd_t(T))
+
+/**
+ * @brief Name of the source function type of simd_pipe_t(T).
+ *
+ * A source writes elements pos .. pos + n - 1 of the stream to dst:
+ *   void source(T *dst, size_t pos, size_t n, const void *arg)
+ * It lets the first step convert from another type or representation.
+ */
+#define simd_pipe_source_t(T) PPCAT(simd_pipe_source_,simd_t(T))
+
+/**
+ * @brief Define the block pipeline for T.
+ *
+ * @tparam T Scalar type; requires decl_simd_t(T)
+ *
+ * Declares the pipeline type and functions:
+ *   int  pipe_init_simd_v{T}{XLEN}_t(simd_pipe_t(T) *p, size_t block)
+ *   int  pipe_add_simd_v{T}{XLEN}_t(simd_pipe_t(T) *p, simd_pipe_stage_t(T) fn,
+ *                                   const void *arg)
+ *   T    pipe_exec_simd_v{T}{XLEN}_t(simd_pipe_t(T) *p, simd_pipe_source_t(T) src,
+ *                                    const void *arg, size_t n, T *out, int sum)
+ *   void pipe_free_simd_v{T}{XLEN}_t(simd_pipe_t(T) *p)
+ *
+ * Chaining simd_array_* calls makes one pass over memory per stage. A
+ * pipeline instead cuts the stream into blocks of `block` elements
+ * (SIMD_PIPE_BLOCK bytes by default, rounded to whole vectors) and runs
+ * every stage on a block, in an aligned buffer that stays in cache, before
+ * fetching the next one. Each block is filled by the source, passed
+ * through the stages in the order they were added, then stored to out
+ * (unless NULL) and, if sum is nonzero, added to the returned sum.
+ *
+ * init and add return 0, or -1 when the buffer cannot be allocated or the
+ * pipeline already has SIMD_PIPE_MAX_STAGES stages. Stages adapting
+ * decl_simd_bin_op operations come from decl_simd_pipe_stage.
+ *
+ * Example:
+ *   decl_simd_pipe_ops(float)
+ *   simd_pipe_t(float) p;
+ *   simd_pipe_init(float, &p, 0);
+ *   simd_pipe_bin_op_vs(mul, float, &p, &scale);
+ *   simd_pipe_bin_op_vv(add, float, &p, bias);
+ *   float total = simd_pipe_sum(float, &p, x, n);
+ *   simd_pipe_free(float, &p);
+ */
+#define decl_simd_pipe_ops(T) \
+typedef void (*simd_pipe_stage_t(T))(simd_t(T) *v, size_t n, size_t pos, const void *arg); \
+typedef void (*simd_pipe_source_t(T))(T *dst, size_t pos, size_t n, const void *arg); \
+typedef struct simd_pipe_t(T) { \
+    size_t     block;   /* elements per block, a multiple of VLEN(T) */ \
+    size_t     nstages; \
+    simd_t(T) *buf;     /* block buffer */ \
+    struct { \
+        simd_pipe_stage_t(T) fn; \
+        const void          *arg; \
+    } stage[SIMD_PIPE_MAX_STAGES]; \
+} simd_pipe_t(T); \
+SIMD_FUNC int SIMD_CALLCONV simd_op_name(T,pipe_init) (simd_pipe_t(T) *p, size_t block) { \
+    if (!block) { \
+        block = SIMD_PIPE_BLOCK / sizeof(T); \
+    } \
+    p->block = (block + VLEN(T) - 1) / VLEN(T) * VLEN(T); \
+    p->nstages = 0; \
+    p->buf = simd_alloc(simd_t(T), p->block / VLEN(T)); \
+    return p->buf ? 0 : -1; \
+} \
+SIMD_FUNC int SIMD_CALLCONV \
+simd_op_name(T,pipe_add) (simd_pipe_t(T) *p, simd_pipe_stage_t(T) fn, const void *arg) { \
+    if (p->nstages == SIMD_PIPE_MAX_STAGES) { \
+        return -1; \
+    } \
+    p->stage[p->nstages].fn = fn; \
+    p->stage[p->nstages].arg = arg; \
+    p->nstages++; \
+    return 0; \
+} \
+SIMD_FUNC void SIMD_CALLCONV \
+simd_op_name(T,pipe_source_array) (T *dst, size_t pos, size_t n, const void *arg) { \
+    memcpy(dst, (const T *)arg + pos, n * sizeof(T)); \
+} \
+SIMD_FUNC T SIMD_CALLCONV \
+simd_op_name(T,pipe_exec) (simd_pipe_t(T) *p, simd_pipe_source_t(T) src, const void *arg, \
+                           size_t n, T *out, int sum) { \
+    simd_t(T) acc = simd_splat(T, 0); \
+    T *b = (T *)p->buf; \
+    T tail = 0; \
+    for (size_t pos = 0; pos < n; pos += p->block) { \
+        size_t m = n - pos < p->block ? n - pos : p->block; \
+        size_t nv = m / VLEN(T); \
+        src(b, pos, m, arg); \
+        if (m % VLEN(T)) { \
+            memset(b + m, 0, (VLEN(T) - m % VLEN(T)) * sizeof(T)); \
+        } \
+        for (size_t s = 0; s < p->nstages; s++) { \
+            p->stage[s].fn(p->buf, m, pos, p->stage[s].arg); \
+        } \
+        if (out) { \
+            memcpy(out + pos, b, m * sizeof(T)); \
+        } \
+        if (sum) { \
+            for (size_t i = 0; i < nv; i++) { \
+                acc = simd_apply_add(T, acc, p->buf[i]); \
+            } \
+            for (size_t i = nv * VLEN(T); i < m; i++) { \
+                tail += b[i]; \
+            } \
+        } \
+    } \
+    return simd_apply_sum(T, acc) + tail; \
+} \
+SIMD_FUNC void SIMD_CALLCONV simd_op_name(T,pipe_free) (simd_pipe_t(T) *p) { \
+    simd_free(p->buf); \
+    p->buf = NULL; \
+    p->nstages = 0; \
+}
+
+/**
+ * @brief Define pipeline stages for a decl_simd_bin_op operation.
+ *
+ * @param name Operation name given to decl_simd_bin_op(name, T, op)
+ * @tparam T   Scalar type; requires decl_simd_pipe_ops(T)
+ *
+ * Declares simd_pipe_stage_t(T) functions:
+ *   pipe_name_vs_simd_v{T}{XLEN}_t: v = name_vs(v, *(const T *)arg)
+ *   pipe_name_vv_simd_v{T}{XLEN}_t: v = name(v, b[pos ..]) with b = (const T *)arg,
+ *                                   an array as long as the stream
+ * In the vv stage the lanes past the end of the stream repeat b's last
+ * element, so an integer division never divides a padding lane by zero
+ * unless the data does. Any other function of type simd_pipe_stage_t(T)
+ * can be added to a pipeline the same way.
+ */
+#define decl_simd_pipe_stage(name, T) \
+SIMD_FUNC void SIMD_CALLCONV \
+simd_op_name(T,PPCAT(pipe_,PPCAT(name,_vs))) (simd_t(T) *v, size_t n, size_t pos, const void *arg) { \
+    T s = *(const T *)arg; \
+    (void)pos; \
+    for (size_t i = 0; i * VLEN(T) < n; i++) { \
+        v[i] = simd_op_name(T,PPCAT(name,_vs)) (v[i], s); \
+    } \
+} \
+SIMD_FUNC void SIMD_CALLCONV \
+simd_op_name(T,PPCAT(pipe_,PPCAT(name,_vv))) (simd_t(T) *v, size_t n, size_t pos, const void *arg) { \
+    const T *b = (const T *)arg + pos; \
+    size_t i = 0; \
+    for (; (i + 1) * VLEN(T) <= n; i++) { \
+        v[i] = simd_op_name(T,name) (v[i], simd_load(T, b + i * VLEN(T))); \
+    } \
+    if (i * VLEN(T) < n) { \
+        simd_t(T) t; \
+        simd_for_lanes(T, k) { \
+            t.v[k] = b[i * VLEN(T) + k < n ? i * VLEN(T) + k : n - 1]; \
+        } \
+        v[i] = simd_op_name(T,name) (v[i], t); \
+    } \
+}
+
+/** @brief Initialize a pipeline; block = elements per block, 0 for the default. */
+#define simd_pipe_init(T, p, block) simd_op_name(T,pipe_init) (p, block)
+
+/** @brief Append a stage function with its argument. */
+#define simd_pipe_add(T, p, fn, arg) simd_op_name(T,pipe_add) (p, fn, arg)
+
+/** @brief Append the stage v = name_vs(v, *s) (requires decl_simd_pipe_stage(name, T)). */
+#define simd_pipe_bin_op_vs(name, T, p, s) \
+    simd_op_name(T,pipe_add) (p, simd_op_name(T,PPCAT(pipe_,PPCAT(name,_vs))), s)
+
+/** @brief Append the stage v = name(v, b[...]) over the array b. */
+#define simd_pipe_bin_op_vv(name, T, p, b) \
+    simd_op_name(T,pipe_add) (p, simd_op_name(T,PPCAT(pipe_,PPCAT(name,_vv))), b)
+
+/** @brief Run the stages over in[0..n) and store the results to out (may equal in). */
+#define simd_pipe_run(T, p, in, n, out) \
+    ((void)simd_op_name(T,pipe_exec) (p, simd_op_name(T,pipe_source_array), in, n, out, 0))
+
+/** @brief Run the stages over in[0..n) and return the sum of the results. */
+#define simd_pipe_sum(T, p, in, n) \
+    simd_op_name(T,pipe_exec) (p, simd_op_name(T,pipe_source_array), in, n, NULL, 1)
+
+/** @brief Run the stages over a custom source; out may be NULL, sum selects the reduction. */
+#define simd_pipe_exec(T, p, src, arg, n, out, sum) \
+    simd_op_name(T,pipe_exec) (p, src, arg, n, out, sum)
+
+/** @brief Release the pipeline's block buffer. */
+#define simd_pipe_free(T, p) simd_op_name(T,pipe_free) (p)
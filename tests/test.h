@@ -0,0 +1,40 @@
+/*
+ * Shared helpers of the notasimdlib.h tests.
+ *
+ * CHECK() records a failure and keeps going, so one run reports every
+ * broken case; test_done() prints the verdict and gives the exit code.
+ */
+#ifndef NOTASIMDLIB_TEST_H
+#define NOTASIMDLIB_TEST_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+static int test_failures;
+
+/** @brief Record a failure of cond (the first 20 are printed). */
+#define CHECK(cond) \
+    do { \
+        if (!(cond) && test_failures++ < 20) \
+            fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+    } while (0)
+
+/** @brief Print the verdict of the test named name; returns the exit code. */
+static inline int test_done(const char *name) {
+    if (test_failures) {
+        fprintf(stderr, "%s: %d check(s) failed\n", name, test_failures);
+        return 1;
+    }
+    printf("%s: ok\n", name);
+    return 0;
+}
+
+/** @brief Deterministic 64-bit generator (splitmix64) for test data. */
+static inline uint64_t test_rand(uint64_t *s) {
+    uint64_t z = (*s += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+#endif
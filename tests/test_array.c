@@ -0,0 +1,58 @@
+/*
+ * Checked two-input array kernels (user-068) under every overlap of dst
+ * with a and b: disjoint, in place, dst below, above and strictly
+ * between the inputs, against a scalar loop over copies of the inputs.
+ * When the scratch copy cannot be allocated the kernel must fail with
+ * ENOMEM and leave dst untouched, never compute from overwritten input.
+ */
+#include "notasimdlib.h"
+#include "test.h"
+#include <errno.h>
+#include <stdint.h>
+
+decl_simd_t(int32_t)
+decl_simd_array_ops(int32_t)
+
+#define M 200
+
+int main(void) {
+    static int32_t buf[3 * M], ref[3 * M], a0[M], b0[M];
+    const int offs[] = { 0, 1, 3, 8, 13, 40, 100, 250, 399 };
+    const size_t noffs = sizeof(offs) / sizeof(offs[0]);
+    const size_t lens[] = { 0, 1, 7, 8, 9, 33, 100, 200 };
+
+    for (size_t li = 0; li < sizeof(lens) / sizeof(lens[0]); li++) {
+        size_t n = lens[li];
+        for (size_t x = 0; x < noffs; x++)
+        for (size_t y = 0; y < noffs; y++)
+        for (size_t z = 0; z < noffs; z++) {
+            int32_t *dst = buf + offs[x];
+            const int32_t *a = buf + offs[y], *b = buf + offs[z];
+            for (size_t i = 0; i < 3 * M; i++)
+                buf[i] = ref[i] = (int32_t)(i * 7919u % 1000u) - 500;
+            for (size_t i = 0; i < n; i++) {
+                a0[i] = a[i];
+                b0[i] = b[i];
+            }
+            for (size_t i = 0; i < n; i++)
+                ref[offs[x] + i] = a0[i] - b0[i];
+            CHECK(simd_array_sub(int32_t, dst, a, b, n) == 0);
+            CHECK(memcmp(buf, ref, sizeof(buf)) == 0);
+        }
+    }
+
+    /*
+     * dst strictly between a and b with a length no allocation can
+     * satisfy: only the addresses are compared before the failure.
+     */
+    for (size_t i = 0; i < 3 * M; i++)
+        buf[i] = ref[i] = (int32_t)i;
+    /* Opaque, or the inlined (SIMD_INLINE) kernel draws -Warray-bounds. */
+    volatile size_t huge = SIZE_MAX / 8;
+    errno = 0;
+    CHECK(simd_array_add(int32_t, buf + 1, buf, buf + 2, huge) == -1);
+    CHECK(errno == ENOMEM);
+    CHECK(memcmp(buf, ref, sizeof(buf)) == 0);
+
+    return test_done("test_array");
+}
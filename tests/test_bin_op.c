@@ -0,0 +1,78 @@
+/*
+ * decl_simd_bin_op (user-065): the vector-vector, vector-scalar,
+ * scalar-vector, in-place and pointer forms against the scalar operator,
+ * for float and int32_t. sub, div and shl are not commutative, so the
+ * scalar-vector form must compute s op b.v[i] and not b.v[i] op s. The
+ * pointer forms are also run with the output aliasing an input.
+ */
+#include "notasimdlib.h"
+#include "test.h"
+
+decl_simd_t(float)
+decl_simd_t(int32_t)
+decl_simd_bin_op(add, float, +)
+decl_simd_bin_op(sub, float, -)
+decl_simd_bin_op(div, float, /)
+decl_simd_bin_op(sub, int32_t, -)
+decl_simd_bin_op(mul, int32_t, *)
+decl_simd_bin_op(shl, int32_t, <<)
+
+#define ROUNDS 50
+
+/* Every form of one decl_simd_bin_op(name, T, op) for one pair a, b and scalar s. */
+#define CHECK_FORMS(name, T, op, a, b, s) do { \
+    simd_t(T) vv = simd_bin_op(name, T, a, b); \
+    simd_t(T) vs = simd_bin_op_vs(name, T, a, s); \
+    simd_t(T) sv = simd_bin_op_sv(name, T, s, b); \
+    simd_t(T) ip = a, p, pa = a, pb = b; \
+    simd_bin_op_inplace(name, T, &ip, &b); \
+    simd_bin_op_p(name, T, &p, &a, &b); \
+    simd_bin_op_p(name, T, &pa, &pa, &b); \
+    simd_bin_op_p(name, T, &pb, &a, &pb); \
+    for (size_t i = 0; i < VLEN(T); i++) { \
+        T r = (T)(a.v[i] op b.v[i]); \
+        CHECK(vv.v[i] == r); \
+        CHECK(vs.v[i] == (T)(a.v[i] op s)); \
+        CHECK(sv.v[i] == (T)(s op b.v[i])); \
+        CHECK(ip.v[i] == r); \
+        CHECK(p.v[i] == r); \
+        CHECK(pa.v[i] == r); \
+        CHECK(pb.v[i] == r); \
+    } \
+} while (0)
+
+int main(void) {
+    uint64_t seed = 65;
+    for (int r = 0; r < ROUNDS; r++) {
+        simd_t(float) fa, fb;
+        simd_t(int32_t) ia, ib, sh;
+        for (size_t i = 0; i < VLEN(float); i++) {
+            fa.v[i] = (float)(int)(test_rand(&seed) % 2001 - 1000) / 8;
+            fb.v[i] = (float)(int)(test_rand(&seed) % 2001 - 1000) / 8 + 0.5f;
+        }
+        for (size_t i = 0; i < VLEN(int32_t); i++) {
+            ia.v[i] = (int32_t)(test_rand(&seed) % 20001) - 10000;
+            ib.v[i] = (int32_t)(test_rand(&seed) % 20001) - 10000;
+            sh.v[i] = (int32_t)(test_rand(&seed) % 16);
+        }
+        float fs = (float)(r + 1) / 4;
+        int32_t is = r * 37 - 900;
+        CHECK_FORMS(add, float, +, fa, fb, fs);
+        CHECK_FORMS(sub, float, -, fa, fb, fs);
+        CHECK_FORMS(div, float, /, fa, fb, fs);
+        CHECK_FORMS(sub, int32_t, -, ia, ib, is);
+        CHECK_FORMS(mul, int32_t, *, ia, ib, is);
+        CHECK_FORMS(shl, int32_t, <<, sh, sh, 3);
+    }
+
+    /* Operand order spelled out: 10 - b and 10 / b, not b - 10 and b / 10. */
+    simd_t(float) two = simd_splat(float, 2.0f);
+    CHECK(simd_bin_op_sv(sub, float, 10.0f, two).v[0] == 8.0f);
+    CHECK(simd_bin_op_vs(sub, float, two, 10.0f).v[0] == -8.0f);
+    CHECK(simd_bin_op_sv(div, float, 10.0f, two).v[0] == 5.0f);
+    CHECK(simd_bin_op_vs(div, float, two, 10.0f).v[0] == 0.2f);
+    simd_t(int32_t) one = simd_splat(int32_t, 1);
+    CHECK(simd_bin_op_sv(shl, int32_t, 1, simd_splat(int32_t, 4)).v[VLEN(int32_t) - 1] == 16);
+    CHECK(simd_bin_op_sv(sub, int32_t, 0, one).v[0] == -1);
+    return test_done("test_bin_op");
+}
@@ -0,0 +1,102 @@
+#!/bin/sh
+# Codegen check for the threshold, clamp and abs ops (user-060): compiles
+# them to assembly and fails if any contains a conditional branch that
+# does not belong to its loop.
+#
+#   simd_apply_{min,max,abs,neg,clamp,min_scalar,max_scalar} wrapped in
+#   one function each must contain no conditional jump at all.
+#
+#   array_{min,max,abs,neg,clamp,min_scalar,max_scalar}_noalias may only
+#   branch around their loops: every loop body (from a label back to the
+#   conditional jump that returns to it) must hold no other conditional
+#   jump.
+#
+# Run from tests/ (make -C tests does); honours CC, CFLAGS (-O2 or higher,
+# so the lane loops are unrolled) and XLEN.
+
+CC=${CC:-cc}
+CFLAGS=${CFLAGS:--O2 -march=native}
+XLEN=${XLEN:-256}
+tmp=${TMPDIR:-/tmp}/test_branchfree.$$
+trap 'rm -f "$tmp.c" "$tmp.s"' EXIT
+
+{
+    echo '#include "notasimdlib.h"'
+    for T in int16_t int32_t float double; do
+        echo "decl_simd_t($T)"
+        echo "decl_simd_array_ops($T)"
+        for op in min max; do
+            echo "simd_t($T) bf_${op}_$T(simd_t($T) a, simd_t($T) b) { return simd_apply_$op($T, a, b); }"
+            echo "simd_t($T) bf_${op}_scalar_$T(simd_t($T) a, $T s) { return simd_apply_${op}_scalar($T, a, s); }"
+        done
+        for op in abs neg; do
+            echo "simd_t($T) bf_${op}_$T(simd_t($T) a) { return simd_apply_$op($T, a); }"
+        done
+        echo "simd_t($T) bf_clamp_$T(simd_t($T) a, $T lo, $T hi) { return simd_apply_clamp($T, a, lo, hi); }"
+    done
+} > "$tmp.c"
+
+# shellcheck disable=SC2086
+$CC -std=gnu11 -S -I.. -DXLEN="$XLEN" $CFLAGS -USIMD_INLINE "$tmp.c" -o "$tmp.s" || exit 1
+
+# Number of conditional jumps (j<cc>, not jmp) in function $1, or -1 if
+# the function is missing from the assembly.
+jumps() {
+    awk -v f="$1" '
+        $0 == f ":" { found = 1; inside = 1; next }
+        inside && /\.cfi_endproc|^\t\.size/ { exit }
+        inside && $1 ~ /^j/ && $1 != "jmp" { n++ }
+        END { print found ? n + 0 : -1 }' "$tmp.s"
+}
+
+# Number of conditional jumps inside the loop bodies of function $1 that
+# do not return to the loop head, or -1 if the function is missing. A
+# backward jump over a ret or jmp enters a peeled tail, not a loop.
+loop_jumps() {
+    awk -v f="$1" '
+        $0 == f ":" { found = 1; inside = 1; next }
+        !inside { next }
+        /\.cfi_endproc|^\t\.size/ { exit }
+        /^\.?L[A-Za-z0-9_]*:/ { sub(/:.*/, ""); at[$0] = i; next }
+        /^\t\./ { next }
+        { i++ }
+        $1 ~ /^j/ && $1 != "jmp" { cj[i] = 1; to[i] = $2 }
+        $1 == "jmp" || $1 ~ /^ret/ { out[i] = 1 }
+        END {
+            if (!found) { print -1; exit }
+            for (j = 1; j <= i; j++) {
+                if (!(j in cj) || !(to[j] in at) || at[to[j]] >= j) continue
+                m = 0
+                for (k = at[to[j]] + 1; k < j; k++) {
+                    if (k in out) { m = 0; break }
+                    m += (k in cj) && to[k] != to[j]
+                }
+                n += m
+            }
+            print n + 0
+        }' "$tmp.s"
+}
+
+fail=0
+for T in int16_t int32_t float double; do
+    for op in min max min_scalar max_scalar abs neg clamp; do
+        n=$(jumps "bf_${op}_$T")
+        if [ "$n" -ne 0 ]; then
+            echo "test_branchfree: simd_apply_$op($T) has $n conditional jump(s)" >&2
+            fail=1
+        fi
+    done
+    for op in min max min_scalar max_scalar abs neg clamp; do
+        n=$(loop_jumps "array_${op}_noalias_simd_v$T${XLEN}_t")
+        if [ "$n" -ne 0 ]; then
+            echo "test_branchfree: array_${op}_noalias($T) has $n conditional jump(s) in a loop body" >&2
+            fail=1
+        fi
+    done
+done
+
+if [ "$fail" -ne 0 ]; then
+    echo "test_branchfree: failed" >&2
+    exit 1
+fi
+echo "test_branchfree: ok"
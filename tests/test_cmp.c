@@ -0,0 +1,68 @@
+/*
+ * simd_apply_cmp and its named forms against a scalar bit loop (user-070)
+ * for every lane width: 8-bit lanes at XLEN 512 fill all 64 mask bits in
+ * eight T-wide chunks, 16-bit lanes two. Lanes are drawn from a small
+ * range so equal lanes are common, and float lanes include NaN, which
+ * compares false.
+ */
+#include "notasimdlib.h"
+#include "test.h"
+#include <math.h>
+
+#define ROUNDS 200
+
+#define decl_cmp_test(T) \
+    decl_simd_t(T) \
+    static void test_cmp_##T(uint64_t *seed) { \
+        for (int r = 0; r < ROUNDS; r++) { \
+            simd_t(T) a, b; \
+            for (size_t i = 0; i < VLEN(T); i++) { \
+                a.v[i] = (T)((int)(test_rand(seed) % 7) - 3); \
+                b.v[i] = (T)((int)(test_rand(seed) % 7) - 3); \
+            } \
+            if (r % 3 == 0 && (T)0.5 != 0) \
+                a.v[test_rand(seed) % VLEN(T)] = (T)NAN; \
+            simd_mask_t lt = 0, le = 0, gt = 0, ge = 0, eq = 0, ne = 0; \
+            for (size_t i = 0; i < VLEN(T); i++) { \
+                lt |= (simd_mask_t)(a.v[i] < b.v[i]) << i; \
+                le |= (simd_mask_t)(a.v[i] <= b.v[i]) << i; \
+                gt |= (simd_mask_t)(a.v[i] > b.v[i]) << i; \
+                ge |= (simd_mask_t)(a.v[i] >= b.v[i]) << i; \
+                eq |= (simd_mask_t)(a.v[i] == b.v[i]) << i; \
+                ne |= (simd_mask_t)(a.v[i] != b.v[i]) << i; \
+            } \
+            CHECK(simd_apply_cmplt(T, a, b) == lt); \
+            CHECK(simd_apply_cmple(T, a, b) == le); \
+            CHECK(simd_apply_cmpgt(T, a, b) == gt); \
+            CHECK(simd_apply_cmpge(T, a, b) == ge); \
+            CHECK(simd_apply_cmpeq(T, a, b) == eq); \
+            CHECK(simd_apply_cmp(T, a, b, !=) == ne); \
+        } \
+        simd_t(T) z = simd_splat(T, 0); \
+        CHECK(simd_apply_cmpeq(T, z, z) == (VLEN(T) == 64 ? ~(simd_mask_t)0 \
+                                                          : ((simd_mask_t)1 << VLEN(T)) - 1)); \
+    }
+
+decl_cmp_test(int8_t)
+decl_cmp_test(uint8_t)
+decl_cmp_test(int16_t)
+decl_cmp_test(uint16_t)
+decl_cmp_test(int32_t)
+decl_cmp_test(uint32_t)
+decl_cmp_test(int64_t)
+decl_cmp_test(float)
+decl_cmp_test(double)
+
+int main(void) {
+    uint64_t seed = 70;
+    test_cmp_int8_t(&seed);
+    test_cmp_uint8_t(&seed);
+    test_cmp_int16_t(&seed);
+    test_cmp_uint16_t(&seed);
+    test_cmp_int32_t(&seed);
+    test_cmp_uint32_t(&seed);
+    test_cmp_int64_t(&seed);
+    test_cmp_float(&seed);
+    test_cmp_double(&seed);
+    return test_done("test_cmp");
+}
@@ -0,0 +1,90 @@
+/*
+ * Round trips of the integer codecs (user-052): bit-packing at every
+ * width, delta, delta-of-delta and frame-of-reference, for lengths that
+ * do and do not fill whole blocks, and simd_prefix_sum against a serial sum.
+ */
+#include "notasimdlib.h"
+#include "test.h"
+#include <string.h>
+
+#define CODEC_MAX 4100
+
+#define decl_codec_test(T) \
+    decl_simd_t(T) \
+    decl_simd_codec_ops(T) \
+    static void test_codec_##T(uint64_t *seed) { \
+        static T in[CODEC_MAX], tmp[CODEC_MAX], out[CODEC_MAX]; \
+        static T packed[CODEC_MAX + simd_bitpack_block_len(T)]; \
+        const unsigned width = 8 * sizeof(T); \
+        const size_t lens[] = { 0, 1, VLEN(T) - 1, VLEN(T), simd_bitpack_block_len(T) - 1, \
+                                simd_bitpack_block_len(T) + 3, CODEC_MAX }; \
+        for (size_t li = 0; li < sizeof(lens) / sizeof(lens[0]); li++) { \
+            size_t n = lens[li] < CODEC_MAX ? lens[li] : CODEC_MAX; \
+            for (unsigned bits = 0; bits <= width; bits++) { \
+                T mask = bits == width ? (T)~(T)0 : (T)(((T)1 << bits) - 1); \
+                if (bits == 0) mask = 0; \
+                for (size_t i = 0; i < n; i++) \
+                    in[i] = (T)test_rand(seed) & mask; \
+                if (n) in[test_rand(seed) % n] = mask; /* width is reached */ \
+                \
+                size_t words = simd_bitpack(T, in, n, bits, packed); \
+                CHECK(words == simd_bitpack_words(T, n, bits)); \
+                memset(out, 0xa5, sizeof(out)); \
+                simd_bitunpack(T, packed, n, bits, out); \
+                CHECK(memcmp(in, out, n * sizeof(T)) == 0); \
+                CHECK(n == 0 || simd_max_bits(T, in, n) == bits); \
+                \
+                T prev = (T)test_rand(seed); \
+                simd_delta_encode(T, in, n, prev, tmp); \
+                simd_delta_decode(T, tmp, n, prev, out); \
+                CHECK(memcmp(in, out, n * sizeof(T)) == 0); \
+                \
+                memcpy(tmp, in, n * sizeof(T)); \
+                simd_delta2_encode(T, tmp, n, tmp); \
+                simd_delta2_decode(T, tmp, n, out); \
+                CHECK(memcmp(in, out, n * sizeof(T)) == 0); \
+                \
+                T ref = simd_for_encode(T, in, n, tmp); \
+                for (size_t i = 0; i < n; i++) \
+                    CHECK(in[i] >= ref && tmp[i] == (T)(in[i] - ref)); \
+                simd_for_decode(T, tmp, n, ref, out); \
+                CHECK(memcmp(in, out, n * sizeof(T)) == 0); \
+            } \
+        } \
+        for (int r = 0; r < 100; r++) { \
+            simd_t(T) v, p; \
+            T run = 0; \
+            simd_for_lanes(T, k) v.v[k] = (T)test_rand(seed); \
+            p = simd_prefix_sum(T, v); \
+            simd_for_lanes(T, k) { \
+                run = (T)(run + v.v[k]); \
+                CHECK(p.v[k] == run); \
+            } \
+        } \
+        /* Sorted input: the delta + bit-pack pipeline the codecs are for. */ \
+        size_t n = CODEC_MAX; \
+        in[0] = 0; \
+        for (size_t i = 1; i < n; i++) \
+            in[i] = (T)(in[i - 1] + (T)(test_rand(seed) & 3)); \
+        simd_delta_encode(T, in, n, 0, tmp); \
+        unsigned bits = simd_max_bits(T, tmp, n); \
+        CHECK(bits <= 2); \
+        simd_bitpack(T, tmp, n, bits, packed); \
+        simd_bitunpack(T, packed, n, bits, tmp); \
+        simd_delta_decode(T, tmp, n, 0, out); \
+        CHECK(memcmp(in, out, n * sizeof(T)) == 0); \
+    }
+
+decl_codec_test(uint8_t)
+decl_codec_test(uint16_t)
+decl_codec_test(uint32_t)
+decl_codec_test(uint64_t)
+
+int main(void) {
+    uint64_t seed = 52;
+    test_codec_uint8_t(&seed);
+    test_codec_uint16_t(&seed);
+    test_codec_uint32_t(&seed);
+    test_codec_uint64_t(&seed);
+    return test_done("test_codec");
+}
@@ -0,0 +1,120 @@
+#!/bin/sh
+# Codegen check for the built-in lane ops (user-070): at -O2 every
+# simd_apply_{add,sub,mul,div,and,or,xor} and simd_apply_cmp{lt,eq}
+# wrapper must compile to packed instructions of its own kind that cover
+# exactly XLEN bits: one zmm, two ymm or four xmm instructions at 512,
+# and so on. A lane left scalar or a register missing from the sum shows
+# up as a mismatch.
+#
+#   add, sub, mul   float, double (addps/pd...), int32_t, int16_t
+#                   (paddd/w, psubd/w, pmulld/w)
+#   div             float, double; x86 has no integer vector division
+#   and, or, xor    int32_t, int16_t (pand/por/pxor or the ps/pd forms)
+#   cmplt, cmpeq    float and int32_t with AVX2, int16_t with AVX-512BW
+#                   and VL: the mask bits need a per-lane variable shift,
+#                   without which the compare stays scalar (see
+#                   simd_apply_cmp)
+#
+# Each op sits in a noinline wrapper that takes its operands by pointer,
+# so the ABI's handling of simd_t never enters the count. Runs XLEN 128,
+# 256 and 512 in turn, whatever XLEN says; honours CC and CFLAGS, which
+# must enable the vector ISA (-O2 is appended). int32_t mul needs SSE4.1
+# (pmulld) and is left out without it, as are the compares above.
+# Skipped on non-x86 targets.
+
+CC=${CC:-cc}
+CFLAGS=${CFLAGS:--O2 -march=native}
+tmp=${TMPDIR:-/tmp}/test_codegen.$$
+trap 'rm -f "$tmp.c" "$tmp.s"' EXIT
+
+# shellcheck disable=SC2086
+defs=$($CC $CFLAGS -dM -E - </dev/null 2>/dev/null)
+case $defs in
+*__x86_64__*|*__i386__*) ;;
+*) echo "test_codegen: skipped (not x86)"; exit 0 ;;
+esac
+has() {
+    case $defs in *"#define $1 "*) return 0 ;; esac
+    return 1
+}
+mul32=0 cmp32=0 cmp16=0
+has __SSE4_1__ && mul32=1
+has __AVX2__ && cmp32=1
+has __AVX512BW__ && has __AVX512VL__ && cmp16=1
+
+# Prints "op T regex" for every case checked.
+cases() {
+    for T in float double; do
+        for op in add sub mul div; do
+            echo "$op $T ^v?${op}p[sd]\$"
+        done
+    done
+    for T in int32_t int16_t; do
+        s=d
+        [ "$T" = int16_t ] && s=w
+        echo "add $T ^v?padd$s\$"
+        echo "sub $T ^v?psub$s\$"
+        [ "$T" = int16_t ] || [ "$mul32" -eq 1 ] && echo "mul $T ^v?pmull$s\$"
+        for op in and or xor; do
+            echo "$op $T ^v?p$op[dq]?\$|^v?${op}p[sd]\$"
+        done
+        if [ "$T" = int16_t ] && [ "$cmp16" -eq 1 ] || [ "$T" = int32_t ] && [ "$cmp32" -eq 1 ]; then
+            echo "cmplt $T ^v?pcmp[a-z]*$s\$"
+            echo "cmpeq $T ^v?pcmp[a-z]*$s\$"
+        fi
+    done
+    if [ "$cmp32" -eq 1 ]; then
+        echo "cmplt float ^v?cmp[a-z]*ps\$"
+        echo "cmpeq float ^v?cmp[a-z]*ps\$"
+    fi
+}
+
+# Bits of vector register covered by the instructions matching regex $2
+# in function $1, from the first %xmm/%ymm/%zmm operand of each; -1 if
+# the function is missing from the assembly.
+bits() {
+    awk -v f="$1" -v re="$2" '
+        $0 == f ":" { found = 1; inside = 1; next }
+        inside && /\.cfi_endproc|^\t\.size/ { exit }
+        inside && $1 ~ re && match($0, /%[xyz]mm/) {
+            r = substr($0, RSTART + 1, 1)
+            n += r == "x" ? 128 : r == "y" ? 256 : 512
+        }
+        END { print found ? n + 0 : -1 }' "$tmp.s"
+}
+
+fail=0
+for XLEN in 128 256 512; do
+    {
+        echo '#include <notasimdlib.h>'
+        for T in float double int32_t int16_t; do
+            echo "decl_simd_t($T)"
+        done
+        cases | while read -r op T re; do
+            case $op in
+            cmp*)
+                echo "__attribute__((noinline)) simd_mask_t cg_${op}_$T(const simd_t($T) *a," \
+                     "const simd_t($T) *b) { return simd_apply_$op($T, *a, *b); }" ;;
+            *)
+                echo "__attribute__((noinline)) void cg_${op}_$T(simd_t($T) *o, const simd_t($T) *a," \
+                     "const simd_t($T) *b) { *o = simd_apply_$op($T, *a, *b); }" ;;
+            esac
+        done
+    } > "$tmp.c"
+    # shellcheck disable=SC2086
+    $CC -std=gnu11 -S -I.. -DXLEN="$XLEN" $CFLAGS -O2 -USIMD_INLINE "$tmp.c" -o "$tmp.s" || exit 1
+    cases > "$tmp.c"
+    while read -r op T re; do
+        n=$(bits "cg_${op}_$T" "$re")
+        if [ "$n" -ne "$XLEN" ]; then
+            echo "test_codegen: XLEN $XLEN simd_apply_$op($T) covers $n bits in packed instructions" >&2
+            fail=1
+        fi
+    done < "$tmp.c"
+done
+
+if [ "$fail" -ne 0 ]; then
+    echo "test_codegen: failed" >&2
+    exit 1
+fi
+echo "test_codegen: ok"
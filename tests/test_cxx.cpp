@@ -0,0 +1,125 @@
+/*
+ * The header must stay usable from C++ (g++/clang++ with GNU extensions):
+ * instantiate every decl_* generator for a representative type and run
+ * a few of the results.
+ */
+#include "notasimdlib.h"
+#include "test.h"
+#include <math.h>
+
+decl_simd_t(float)
+decl_simd_t(double)
+decl_simd_t(int8_t)
+decl_simd_t(int16_t)
+decl_simd_t(int32_t)
+decl_simd_t(int64_t)
+decl_simd_t(uint8_t)
+decl_simd_t(uint16_t)
+decl_simd_t(uint32_t)
+decl_simd_t(uint64_t)
+
+decl_simd_bin_op(add, float, +)
+decl_simd_set_ops(uint32_t)
+decl_simd_codec_ops(uint32_t)
+decl_simd_query_ops(int32_t)
+decl_simd_query_ops(float)
+decl_simd_bitmap_ops(uint64_t)
+decl_simd_distance_ops(float, float)
+decl_simd_distance_ops(int8_t, int32_t)
+decl_simd_hamming_ops(uint64_t)
+decl_simd_topk(float)
+decl_simd_nn_ops(float)
+decl_simd_nn_ops(double)
+decl_simd_stats_ops(double)
+decl_simd_poly_ops(float)
+decl_simd_rng_ops()
+decl_simd_array_ops(float)
+decl_simd_array_ops(int32_t)
+decl_simd_view_ops(float)
+decl_simd_fixed_ops()
+decl_simd_pipe_ops(float)
+decl_simd_divider(int16_t)
+decl_simd_divider(uint32_t)
+decl_simd_divider(int64_t)
+decl_simd_mmap_ops()
+
+static float dot_func(float accum, int i, simd_t(float) a, simd_t(float) b) {
+    return accum + a.v[i] * b.v[i];
+}
+
+static float dot_vec(float accum, size_t i, simd_t(float) a, simd_t(float) b) {
+    return accum + a.v[i] * b.v[i];
+}
+
+int main(void) {
+    float x[100], y[100];
+    for (int i = 0; i < 100; i++)
+        x[i] = (float)(i % 7) - 3.0f;
+
+    simd_softmax(float, x, 100, y);
+    float total = 0;
+    for (int i = 0; i < 100; i++)
+        total += y[i];
+    CHECK(fabsf(total - 1.0f) < 1e-5f);
+
+    simd_t(float) e = simd_apply_exp(float, simd_splat(float, 1.0f));
+    CHECK(fabsf(e.v[0] - 2.7182817f) < 1e-6f);
+
+    simd_t(float) one = simd_splat(float, 1.0f), two = simd_splat(float, 2.0f);
+    CHECK(simd_reduce_func(float, dot_func, one, simd_apply_add(float, one, one)) == 2.0f * VLEN(float));
+    CHECK(simd_reduce_vec2(float, dot_vec, one, simd_apply_add(float, one, one)) == 2.0f * VLEN(float));
+    CHECK(simd_reduce_expr(float, accum + one.v[i] * two.v[i], one, two) == 2.0f * VLEN(float));
+
+    simd_uint_of(double) u = 0;
+    simd_int_of(float) s = -1;
+    CHECK(sizeof(u) == 8 && sizeof(s) == 4 && s < 0);
+    CHECK(simd_libm(float, __builtin_floor, 2.5f) == 2.0f);
+
+    simd_t(float) h = simd_splat(float, -2.5f);
+    CHECK(simd_bitcast(float, uint32_t, h).v[0] == 0xc0200000u);
+    CHECK(simd_apply_round(float, h).v[0] == -3.0f);
+    CHECK(simd_apply_floor(float, h).v[0] == -3.0f);
+    CHECK(simd_apply_ceil(float, h).v[0] == -2.0f);
+    simd_t(int32_t) ex;
+    simd_t(float) mant = simd_apply_frexp(float, h, &ex);
+    CHECK(simd_apply_ldexp(float, mant, ex).v[0] == -2.5f);
+
+    int32_t c[64];
+    for (int i = 0; i < 64; i++)
+        c[i] = i;
+    simd_pred_t(int32_t) p[1] = { { c, SIMD_CMP_LT, 10 } };
+    simd_agg_t(int32_t) r = simd_filter_aggregate(int32_t, p, 1, c, 64, NULL);
+    CHECK(r.count == 10 && r.sum == 45);
+
+    simd_divider_t(int16_t) by_m7 = simd_divider(int16_t, -7);
+    CHECK(simd_apply_div_const(int16_t, simd_splat(int16_t, 100), by_m7).v[0] == -14);
+    simd_divider_t(uint32_t) by10 = simd_divider(uint32_t, 10);
+    CHECK(simd_apply_mod_const(uint32_t, simd_splat(uint32_t, 4294967295u), by10).v[0] == 5);
+    simd_divider_t(int64_t) by3 = simd_divider(int64_t, 3);
+    CHECK(simd_apply_div_const(int64_t, simd_splat(int64_t, -INT64_MAX), by3).v[0] == -INT64_MAX / 3);
+
+    char path[] = "/tmp/test_cxx.XXXXXX";
+    int fd = mkstemp(path);
+    CHECK(fd >= 0);
+    if (fd >= 0) {
+        close(fd);
+        CHECK(simd_mmap_write(path, float, x, 100) == 0);
+        simd_mmap_t m;
+        const simd_t(float) *v = simd_mmap_open(&m, path, float, SIMD_MMAP_SEQUENTIAL);
+        CHECK(v && m.count == 100 && ((const float *)v)[99] == x[99]);
+        if (v) simd_mmap_close(&m);
+        simd_mmap_stream_t st;
+        size_t seen = 0, len;
+        float last = 0;
+        CHECK(simd_mmap_stream_open(&st, path, float, 4096, 0) == 0);
+        while (const float *p = simd_mmap_stream_next(float, &st, &len)) {
+            seen += len;
+            last = p[len - 1];
+        }
+        simd_mmap_stream_close(&st);
+        CHECK(seen == 100 && last == x[99]);
+        unlink(path);
+    }
+
+    return test_done("test_cxx");
+}
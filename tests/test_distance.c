@@ -0,0 +1,115 @@
+/*
+ * Distance kernels (user-055): l2sq, inner_product and cosine with their
+ * batch forms for float, int8_t and, where the compiler has it,
+ * _Float16 accumulating in float, against a double reference over
+ * dimensions that leave a partial final vector. Inputs are multiples of
+ * 1/4 small enough that every product and sum is exact in the
+ * accumulator type. Also hamming over packed codes and topk.
+ */
+#include "notasimdlib.h"
+#include "test.h"
+#include <math.h>
+
+decl_simd_t(float)
+decl_simd_t(int8_t)
+decl_simd_t(uint64_t)
+decl_simd_distance_ops(float, float)
+decl_simd_distance_ops(int8_t, int32_t)
+decl_simd_hamming_ops(uint64_t)
+decl_simd_topk(float)
+
+#ifdef __FLT16_MANT_DIG__
+decl_simd_t(_Float16)
+decl_simd_distance_ops(_Float16, float)
+#endif
+
+#define MAX_DIM 70
+#define ROWS 5
+
+/* Fill a with values k * scale, k in [-32, 32]. */
+#define FILL(T, a, n, scale, seed) \
+    for (size_t _i = 0; _i < (n); _i++) \
+        (a)[_i] = (T)((double)((int)(test_rand(seed) % 65) - 32) * (scale))
+
+/* Check every kernel of decl_simd_distance_ops(T, A) at every dimension. */
+#define CHECK_DISTANCE(T, A, scale, seed) do { \
+    T q[MAX_DIM], base[ROWS * MAX_DIM]; \
+    A out[ROWS]; \
+    double cos_out[ROWS]; \
+    FILL(T, q, MAX_DIM, scale, seed); \
+    FILL(T, base, ROWS * MAX_DIM, scale, seed); \
+    for (size_t dim = 0; dim <= MAX_DIM; dim += dim < 2 * VLEN(T) ? 1 : 7) { \
+        simd_l2sq_batch(T, q, base, ROWS, dim, out); \
+        for (size_t r = 0; r < ROWS; r++) { \
+            const T *b = base + r * dim; \
+            double l2 = 0, ip = 0, aa = 0, bb = 0; \
+            for (size_t i = 0; i < dim; i++) { \
+                double x = (double)q[i], y = (double)b[i]; \
+                l2 += (x - y) * (x - y); \
+                ip += x * y; \
+                aa += x * x; \
+                bb += y * y; \
+            } \
+            double cs = aa > 0 && bb > 0 ? ip / sqrt(aa * bb) : 0.0; \
+            CHECK((double)simd_l2sq(T, q, b, dim) == l2); \
+            CHECK((double)out[r] == l2); \
+            CHECK((double)simd_inner_product(T, q, b, dim) == ip); \
+            CHECK(fabs(simd_cosine(T, q, b, dim) - cs) <= 1e-12); \
+        } \
+        simd_inner_product_batch(T, q, base, ROWS, dim, out); \
+        simd_cosine_batch(T, q, base, ROWS, dim, cos_out); \
+        for (size_t r = 0; r < ROWS; r++) { \
+            CHECK(out[r] == simd_inner_product(T, q, base + r * dim, dim)); \
+            CHECK(cos_out[r] == simd_cosine(T, q, base + r * dim, dim)); \
+        } \
+    } \
+} while (0)
+
+int main(void) {
+    uint64_t seed = 55;
+    CHECK_DISTANCE(float, float, 0.25, &seed);
+    CHECK_DISTANCE(int8_t, int32_t, 1, &seed);
+#ifdef __FLT16_MANT_DIG__
+    CHECK_DISTANCE(_Float16, float, 0.25, &seed);
+#endif
+
+    /* A zero vector has no direction: cosine is 0, not NaN. */
+    float z[MAX_DIM] = {0}, o[MAX_DIM];
+    for (size_t i = 0; i < MAX_DIM; i++) o[i] = 1.0f;
+    CHECK(simd_cosine(float, z, o, MAX_DIM) == 0.0);
+    CHECK(fabs(simd_cosine(float, o, o, MAX_DIM) - 1.0) <= 1e-12);
+
+    uint64_t ca[MAX_DIM], cb[MAX_DIM];
+    for (size_t i = 0; i < MAX_DIM; i++) {
+        ca[i] = test_rand(&seed);
+        cb[i] = test_rand(&seed);
+    }
+    for (size_t n = 0; n <= MAX_DIM; n++) {
+        uint64_t ref = 0;
+        for (size_t i = 0; i < n; i++)
+            ref += (uint64_t)__builtin_popcountll(ca[i] ^ cb[i]);
+        CHECK(simd_hamming(uint64_t, ca, cb, n) == ref);
+    }
+
+    /* topk: distances with ties, against a selection by repeated minimum. */
+    float dist[MAX_DIM], best[8];
+    size_t idx[8];
+    for (size_t i = 0; i < MAX_DIM; i++) dist[i] = (float)(test_rand(&seed) % 40);
+    for (size_t k = 0; k <= 8; k++) {
+        size_t got = simd_topk(float, dist, MAX_DIM, k, idx, best);
+        CHECK(got == k);
+        float prev = -1;
+        for (size_t j = 0; j < got; j++) {
+            CHECK(dist[idx[j]] == best[j]);
+            CHECK(best[j] >= prev);
+            prev = best[j];
+        }
+        if (got) {
+            size_t below = 0;
+            for (size_t i = 0; i < MAX_DIM; i++) below += dist[i] < best[got - 1];
+            CHECK(below < got);
+        }
+    }
+    CHECK(simd_topk(float, dist, 3, 8, idx, best) == 3);
+    return test_done("test_distance");
+}
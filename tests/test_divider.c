@@ -0,0 +1,131 @@
+/*
+ * simd_apply_div_const / simd_apply_mod_const (user-062) against C's /
+ * and %: every dividend and divisor for 8- and 16-bit lanes, signed and
+ * unsigned, and random plus edge-case operands for 32- and 64-bit lanes.
+ */
+#include "notasimdlib.h"
+#include "test.h"
+#include <string.h>
+
+#define ALL_TYPES(X) \
+    X(int8_t) X(uint8_t) X(int16_t) X(uint16_t) X(int32_t) X(uint32_t) X(int64_t) X(uint64_t)
+#define DECL(T) decl_simd_t(T) decl_simd_divider(T)
+ALL_TYPES(DECL)
+
+/*
+ * Every dividend and divisor of an 8/16-bit T. The quotient q is checked
+ * through the remainder r = n - q*d, taken modulo 2^32 as an int32_t:
+ * q is right when 0 <= r*sign(n) < |d|. That check
+ * vectorizes where a division would not. The remainder kernel runs for
+ * every 16th divisor. Dividing by -1 must match simd_apply_neg, so the
+ * minimum wraps to itself.
+ */
+#define EXHAUSTIVE(T) \
+static void exhaustive_##T(void) { \
+    const int64_t lo = simd_is_signed(T) ? -((int64_t)1 << (8 * sizeof(T) - 1)) : 0; \
+    const int64_t hi = lo + ((int64_t)1 << (8 * sizeof(T))) - 1; \
+    for (int64_t d = lo; d <= hi; d++) { \
+        if (d == 0) continue; \
+        simd_divider_t(T) dv = simd_divider(T, (T)d); \
+        const int32_t ad = (int32_t)(d < 0 ? -d : d); \
+        const uint32_t ud = (uint32_t)d; \
+        int bad = 0; \
+        simd_t(T) a; \
+        for (size_t k = 0; k < VLEN(T); k++) a.v[k] = (T)(lo + (int64_t)k); \
+        for (int64_t n0 = lo; n0 <= hi; n0 += VLEN(T)) { \
+            simd_t(T) q = simd_apply_div_const(T, a, dv); \
+            if (d == -1) { \
+                simd_t(T) neg = simd_apply_neg(T, a); \
+                bad |= memcmp(&q, &neg, sizeof(q)) != 0; \
+                for (size_t k = 0; k < VLEN(T); k++) a.v[k] = (T)(a.v[k] + VLEN(T)); \
+                continue; \
+            } \
+            for (size_t k = 0; k < VLEN(T); k++) { \
+                int32_t n = a.v[k]; \
+                int32_t r = (int32_t)((uint32_t)n - (uint32_t)q.v[k] * ud); \
+                int32_t rs = n < 0 ? -r : r; \
+                bad |= (rs < 0) | (rs >= ad); \
+            } \
+            if ((d & 15) == 1) { \
+                simd_t(T) m = simd_apply_mod_const(T, a, dv); \
+                for (size_t k = 0; k < VLEN(T); k++) \
+                    bad |= m.v[k] != (T)((uint32_t)a.v[k] - (uint32_t)q.v[k] * ud); \
+            } \
+            for (size_t k = 0; k < VLEN(T); k++) a.v[k] = (T)(a.v[k] + VLEN(T)); \
+        } \
+        CHECK(!bad); \
+    } \
+}
+EXHAUSTIVE(int8_t)
+EXHAUSTIVE(uint8_t)
+EXHAUSTIVE(int16_t)
+EXHAUSTIVE(uint16_t)
+
+/*
+ * Random 32/64-bit dividends against edge divisors (+-1, powers of two
+ * and their neighbours, the extremes) and random ones, checked with C's
+ * / and %. The minimum divided by -1, undefined in C, must wrap.
+ */
+#define RANDOM(T, U) \
+static void random_##T(uint64_t *seed) { \
+    const int bits = 8 * (int)sizeof(T); \
+    const T min = (T)(simd_is_signed(T) ? (U)1 << (bits - 1) : 0); \
+    T divs[4 * 64 + 6 + 200]; \
+    size_t nd = 0; \
+    for (int b = 0; b < bits; b++) { \
+        T p = (T)((U)1 << b); \
+        divs[nd++] = p; \
+        divs[nd++] = (T)(p + 1); \
+        divs[nd++] = (T)(p - 1); \
+        divs[nd++] = (T)((U)0 - (U)p); \
+    } \
+    divs[nd++] = (T)-1; \
+    divs[nd++] = (T)((U)-1 >> 1); \
+    divs[nd++] = min; \
+    divs[nd++] = (T)(min + 1); \
+    divs[nd++] = 3; \
+    divs[nd++] = 7; \
+    for (int j = 0; j < 200; j++) \
+        divs[nd++] = (T)(test_rand(seed) >> (j % bits)); \
+    for (size_t j = 0; j < nd; j++) { \
+        T d = divs[j]; \
+        if (d == 0) continue; \
+        simd_divider_t(T) dv = simd_divider(T, d); \
+        int bad = 0; \
+        for (int rep = 0; rep < 64; rep++) { \
+            simd_t(T) a; \
+            for (size_t k = 0; k < VLEN(T); k++) \
+                a.v[k] = (T)(test_rand(seed) >> (test_rand(seed) % bits)); \
+            a.v[0] = rep == 0 ? min : rep == 1 ? (T)((U)-1 >> !!simd_is_signed(T)) : a.v[0]; \
+            simd_t(T) q = simd_apply_div_const(T, a, dv); \
+            simd_t(T) m = simd_apply_mod_const(T, a, dv); \
+            for (size_t k = 0; k < VLEN(T); k++) { \
+                if (simd_is_signed(T) && d == (T)-1 && a.v[k] == min) { \
+                    bad |= q.v[k] != min || m.v[k] != 0; \
+                    continue; \
+                } \
+                bad |= q.v[k] != (T)(a.v[k] / d) || m.v[k] != (T)(a.v[k] % d); \
+            } \
+        } \
+        CHECK(!bad); \
+    } \
+}
+RANDOM(int32_t, uint32_t)
+RANDOM(uint32_t, uint32_t)
+RANDOM(int64_t, uint64_t)
+RANDOM(uint64_t, uint64_t)
+
+int main(void) {
+    exhaustive_int8_t();
+    exhaustive_uint8_t();
+    exhaustive_int16_t();
+    exhaustive_uint16_t();
+    uint64_t seed = 62;
+    for (int round = 0; round < 20; round++) {
+        random_int32_t(&seed);
+        random_uint32_t(&seed);
+        random_int64_t(&seed);
+        random_uint64_t(&seed);
+    }
+    return test_done("test_divider");
+}
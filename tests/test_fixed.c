@@ -0,0 +1,96 @@
+/*
+ * simd_q15_from_float / simd_q31_from_float (user-063) bit for bit against
+ * a scalar lroundf reference with saturation: every half-integer of the
+ * scaled value and its float neighbours, every odd integer in [2^23, 2^24)
+ * for Q31, random floats of every exponent, and the special values.
+ */
+#include "notasimdlib.h"
+#include "test.h"
+#include <math.h>
+#include <float.h>
+#include <stdlib.h>
+#include <string.h>
+
+decl_simd_t(int16_t)
+decl_simd_t(int32_t)
+decl_simd_fixed_ops()
+
+#define CHUNK 4096
+
+static int32_t ref_q(float x, int frac) {
+    const float lim = ldexpf(1.0f, frac);
+    const int64_t max = ((int64_t)1 << frac) - 1;
+    if (isnan(x)) return 0;
+    float y = x * lim;
+    if (y >= lim) return (int32_t)max;
+    if (y <= -lim) return (int32_t)(-max - 1);
+    long r = lroundf(y);
+    return (int32_t)(r > max ? max : r < -max - 1 ? -max - 1 : r);
+}
+
+static float buf[CHUNK];
+static size_t fill;
+static int16_t q15[CHUNK];
+static int32_t q31[CHUNK];
+
+/* Convert the buffered inputs with both kernels and compare. */
+static void flush(void) {
+    simd_q15_from_float(buf, fill, q15);
+    simd_q31_from_float(buf, fill, q31);
+    for (size_t i = 0; i < fill; i++) {
+        int ok15 = q15[i] == ref_q(buf[i], 15), ok31 = q31[i] == ref_q(buf[i], 31);
+        if ((!ok15 || !ok31) && test_failures < 5) {
+            fprintf(stderr, "  x = %a: q15 %d (want %d), q31 %d (want %d)\n", (double)buf[i],
+                    q15[i], ref_q(buf[i], 15), q31[i], ref_q(buf[i], 31));
+        }
+        CHECK(ok15);
+        CHECK(ok31);
+    }
+    fill = 0;
+}
+
+static void add(float x) {
+    buf[fill++] = x;
+    buf[fill++] = -x;
+    if (fill >= CHUNK - 1) flush();
+}
+
+/* A scaled value y and its two float neighbours, for both formats. */
+static void add_scaled(float y) {
+    const int fracs[2] = { 15, 31 };
+    for (int f = 0; f < 2; f++) {
+        float x = ldexpf(y, -fracs[f]);
+        add(x);
+        add(nextafterf(x, INFINITY));
+        add(nextafterf(x, -INFINITY));
+    }
+}
+
+int main(void) {
+    /* Half-integers: all of them up to 2^16, every 7th up to 2^23. */
+    for (uint32_t k = 0; k < (1u << 16); k++)
+        add_scaled((float)k + 0.5f);
+    for (uint32_t k = 1u << 16; k < (1u << 22); k += 7)
+        add_scaled((float)k + 0.5f);
+    /* Odd integers in [2^23, 2^24), where adding 0.5 used to round up. */
+    for (uint32_t k = (1u << 23) + 1; k < (1u << 24); k += 2)
+        add(ldexpf((float)k, -31));
+    /* Random floats of every exponent, subnormals included. */
+    uint64_t seed = 63;
+    for (int e = 0; e < 255; e++) {
+        for (int j = 0; j < 2000; j++) {
+            uint32_t u = ((uint32_t)e << 23) | (uint32_t)(test_rand(&seed) & 0x7fffff);
+            float x;
+            memcpy(&x, &u, sizeof(x));
+            add(x);
+        }
+    }
+    /* The saturation limits and the special values. */
+    const float special[] = { 0.0f, 0.49999997f / 32768, 0.5f / 32768, 1.0f, 32767.5f / 32768,
+                              0x1.fffffep-1f, 2147483520.0f / 2147483648.0f, FLT_MAX,
+                              FLT_TRUE_MIN, INFINITY, NAN };
+    for (size_t j = 0; j < sizeof(special) / sizeof(special[0]); j++)
+        add(special[j]);
+    flush();
+    return test_done("test_fixed");
+}
@@ -0,0 +1,77 @@
+/*
+ * 64-bit integer lanes (user-064): simd_apply_mul64, ltmask64, cmplt64,
+ * cmpgt64, min64 and max64 for int64_t and uint64_t against scalar
+ * expressions. The inputs mix random values with the edges where a
+ * signed compare of unsigned lanes goes wrong: 0, 1, 2^63 - 1, 2^63,
+ * 2^63 + 1 and UINT64_MAX, which reinterpreted as int64_t are INT64_MAX,
+ * INT64_MIN and -1.
+ */
+#include "notasimdlib.h"
+#include "test.h"
+
+decl_simd_t(int64_t)
+decl_simd_t(uint64_t)
+
+#define ROUNDS 200
+
+static const uint64_t edges[] = {
+    0, 1, 2, 0x7fffffffffffffffULL, 0x8000000000000000ULL, 0x8000000000000001ULL,
+    0xfffffffffffffffeULL, 0xffffffffffffffffULL, 0xffffffffULL, 0x100000000ULL,
+};
+#define NEDGES (sizeof(edges) / sizeof(edges[0]))
+
+/* Mask with one bit per 64-bit lane. */
+#define ALL ((simd_mask_t)((((simd_mask_t)1 << (VLEN(uint64_t) - 1)) << 1) - 1))
+
+/* Lane i of a and b: an edge value for the first rounds, random after. */
+static uint64_t pick(uint64_t *seed, size_t round, size_t lane, int second) {
+    size_t e = round * VLEN(uint64_t) + lane;
+    if (round < NEDGES * NEDGES / VLEN(uint64_t) + 1)
+        return edges[(second ? e / NEDGES : e) % NEDGES];
+    return test_rand(seed);
+}
+
+#define CHECK_LANES(T) do { \
+    simd_t(T) a, b; \
+    for (size_t i = 0; i < VLEN(T); i++) { \
+        a.v[i] = (T)pick(&seed, r, i, 0); \
+        b.v[i] = (T)pick(&seed, r, i, 1); \
+    } \
+    simd_t(T) p = simd_apply_mul64(T, a, b); \
+    simd_t(T) lt = simd_apply_ltmask64(T, a, b); \
+    simd_mask_t mlt = simd_apply_cmplt64(T, a, b), mgt = simd_apply_cmpgt64(T, a, b); \
+    simd_t(T) mn = simd_apply_min64(T, a, b), mx = simd_apply_max64(T, a, b); \
+    for (size_t i = 0; i < VLEN(T); i++) { \
+        T x = a.v[i], y = b.v[i]; \
+        CHECK(p.v[i] == (T)((uint64_t)x * (uint64_t)y)); \
+        CHECK(lt.v[i] == (x < y ? (T)-1 : (T)0)); \
+        CHECK(((mlt >> i) & 1) == (simd_mask_t)(x < y)); \
+        CHECK(((mgt >> i) & 1) == (simd_mask_t)(x > y)); \
+        CHECK(mn.v[i] == (x < y ? x : y)); \
+        CHECK(mx.v[i] == (x < y ? y : x)); \
+    } \
+} while (0)
+
+int main(void) {
+    uint64_t seed = 64;
+    for (size_t r = 0; r < ROUNDS; r++) {
+        CHECK_LANES(int64_t);
+        CHECK_LANES(uint64_t);
+    }
+
+    /* Across the sign bit: signed and unsigned order disagree. */
+    simd_t(uint64_t) ua = simd_splat(uint64_t, 0x7fffffffffffffffULL);
+    simd_t(uint64_t) ub = simd_splat(uint64_t, 0x8000000000000000ULL);
+    CHECK(simd_apply_cmplt64(uint64_t, ua, ub) == ALL);
+    CHECK(simd_apply_cmplt64(uint64_t, ub, ua) == 0);
+    CHECK(simd_apply_min64(uint64_t, ua, ub).v[0] == 0x7fffffffffffffffULL);
+    CHECK(simd_apply_max64(uint64_t, simd_splat(uint64_t, 0), simd_splat(uint64_t, UINT64_MAX)).v[0] ==
+          UINT64_MAX);
+    simd_t(int64_t) sa = simd_splat(int64_t, INT64_MAX), sb = simd_splat(int64_t, INT64_MIN);
+    CHECK(simd_apply_cmplt64(int64_t, sb, sa) == ALL);
+    CHECK(simd_apply_min64(int64_t, sa, sb).v[0] == INT64_MIN);
+    CHECK(simd_apply_max64(int64_t, sa, sb).v[0] == INT64_MAX);
+    CHECK(simd_apply_min64(int64_t, simd_splat(int64_t, -1), simd_splat(int64_t, 0)).v[0] == -1);
+    CHECK(simd_apply_mul64(int64_t, sb, simd_splat(int64_t, -1)).v[0] == INT64_MIN);
+    return test_done("test_int64");
+}
@@ -0,0 +1,153 @@
+/*
+ * simd_apply_exp against libm over the full float and double range,
+ * including the overflow limit and the subnormal results, and softmax
+ * and relu against scalar references (user-056). gelu, silu and relu
+ * also run with out shifted below and above x inside one buffer, and
+ * through their _noalias forms, against the disjoint result (user-068).
+ */
+#include "notasimdlib.h"
+#include "test.h"
+#include <math.h>
+#include <float.h>
+#include <stdlib.h>
+
+decl_simd_t(float)
+decl_simd_t(double)
+decl_simd_nn_ops(float)
+decl_simd_nn_ops(double)
+
+/* Distance in units of the last place of the reference ref. */
+static double ulp_err(double got, double ref, double min_sub, int mant) {
+    if (got == ref) return 0;
+    if (isinf(got) || isinf(ref) || isnan(got)) return INFINITY;
+    double ulp = ref == 0 ? min_sub : ldexp(1.0, ilogb(ref) - mant);
+    if (ulp < min_sub) ulp = min_sub;
+    return fabs(got - ref) / ulp;
+}
+
+static void test_exp_float(void) {
+    double worst = 0;
+    for (float x = -110.0f; x < 90.0f; x += 0.0013f) {
+        simd_t(float) v = simd_splat(float, x);
+        float got = simd_apply_exp(float, v).v[VLEN(float) - 1];
+        float ref = (float)exp((double)x);
+        double e = ulp_err(got, ref, FLT_TRUE_MIN, 23);
+        worst = e > worst ? e : worst;
+        CHECK(e <= 4);
+    }
+    printf("  exp float: max error %.2f ulp\n", worst);
+    const float edges[] = { 88.7228f, 88.72283f, 88.7229f, 89.0f, 1e30f, INFINITY,
+                            -87.5f, -100.0f, -103.9f, -104.0f, -1e30f, -INFINITY, 0.0f, -0.0f };
+    for (size_t j = 0; j < sizeof(edges) / sizeof(edges[0]); j++) {
+        float got = simd_apply_exp(float, simd_splat(float, edges[j])).v[0];
+        float ref = expf(edges[j]);
+        CHECK(ulp_err(got, ref, FLT_TRUE_MIN, 23) <= 4);
+    }
+    CHECK(isnan(simd_apply_exp(float, simd_splat(float, NAN)).v[0]));
+    CHECK(isfinite(simd_apply_exp(float, simd_splat(float, 88.72f)).v[0]));
+}
+
+static void test_exp_double(void) {
+    double worst = 0;
+    for (double x = -750.0; x < 712.0; x += 0.00731) {
+        double got = simd_apply_exp(double, simd_splat(double, x)).v[0];
+        double ref = exp(x);
+        double e = ulp_err(got, ref, DBL_TRUE_MIN, 52);
+        worst = e > worst ? e : worst;
+        CHECK(e <= 4);
+    }
+    printf("  exp double: max error %.2f ulp\n", worst);
+    CHECK(isfinite(simd_apply_exp(double, simd_splat(double, 709.78)).v[0]));
+    CHECK(isinf(simd_apply_exp(double, simd_splat(double, 709.79)).v[0]));
+    CHECK(simd_apply_exp(double, simd_splat(double, -746.0)).v[0] == 0);
+    CHECK(isnan(simd_apply_exp(double, simd_splat(double, NAN)).v[0]));
+}
+
+#define decl_softmax_test(T) \
+    static void test_softmax_##T(uint64_t *seed) { \
+        const size_t lens[] = { 1, 3, VLEN(T) + 1, 768, 1023, 4096, 8193, 200003 }; \
+        for (size_t li = 0; li < sizeof(lens) / sizeof(lens[0]); li++) { \
+            size_t n = lens[li]; \
+            T *x = malloc(n * sizeof(T)), *y = malloc(n * sizeof(T)); \
+            double *ref = malloc(n * sizeof(double)); \
+            /* Rising trend: later blocks raise the running maximum. */ \
+            for (size_t i = 0; i < n; i++) \
+                x[i] = (T)((double)(test_rand(seed) % 20000) / 1000.0 - 10.0 + 30.0 * i / n); \
+            double m = x[0], s = 0; \
+            for (size_t i = 1; i < n; i++) m = x[i] > m ? x[i] : m; \
+            for (size_t i = 0; i < n; i++) s += ref[i] = exp(x[i] - m); \
+            simd_softmax(T, x, n, y); \
+            double worst = 0, total = 0; \
+            for (size_t i = 0; i < n; i++) { \
+                double r = ref[i] / s, e = fabs(y[i] - r) / (r + 1e-30); \
+                worst = e > worst ? e : worst; \
+                total += y[i]; \
+            } \
+            CHECK(worst < 64 * (sizeof(T) == 4 ? FLT_EPSILON : DBL_EPSILON)); \
+            CHECK(fabs(total - 1) < 1e-3); \
+            simd_softmax(T, x, n, x); /* in place */ \
+            CHECK(memcmp(x, y, n * sizeof(T)) == 0); \
+            free(x); free(y); free(ref); \
+        } \
+    }
+
+decl_softmax_test(float)
+decl_softmax_test(double)
+
+static void test_relu(void) {
+    float x[37], y[37];
+    for (int i = 0; i < 37; i++)
+        x[i] = (float)(i - 18);
+    x[5] = NAN;
+    x[36] = NAN;
+    x[7] = -0.0f;
+    simd_relu(float, x, 37, y);
+    for (int i = 0; i < 37; i++) {
+        if (isnan(x[i]))
+            CHECK(isnan(y[i]));
+        else
+            CHECK(y[i] == (x[i] > 0 ? x[i] : 0));
+    }
+}
+
+#define MAP_N 37
+
+/* One elementwise kernel, checked form at every shift up to two vectors, and _noalias. */
+#define CHECK_MAP(op, x, ref) do { \
+    const int span = 2 * (int)VLEN(float) + 1; \
+    float buf[3 * MAP_N], na[MAP_N]; \
+    simd_##op(float, x, MAP_N, ref); \
+    simd_nn_noalias(float, op, x, MAP_N, na); \
+    CHECK(memcmp(na, ref, sizeof(na)) == 0); \
+    for (int shift = -span; shift <= span; shift++) { \
+        memcpy(buf + MAP_N, x, sizeof(na)); \
+        simd_##op(float, buf + MAP_N, MAP_N, buf + MAP_N + shift); \
+        CHECK(memcmp(buf + MAP_N + shift, ref, sizeof(na)) == 0); \
+    } \
+} while (0)
+
+static void test_map_overlap(void) {
+    float x[MAP_N], ref[MAP_N];
+    for (int i = 0; i < MAP_N; i++)
+        x[i] = (float)(i - 18) / 4;
+    CHECK_MAP(relu, x, ref);
+    CHECK_MAP(silu, x, ref);
+    for (int i = 0; i < MAP_N; i++)
+        CHECK(fabsf(ref[i] - x[i] / (1 + expf(-x[i]))) <= 1e-5f * (1 + fabsf(x[i])));
+    CHECK_MAP(gelu, x, ref);
+    for (int i = 0; i < MAP_N; i++) {
+        float u = 0.7978845608f * (x[i] + 0.044715f * x[i] * x[i] * x[i]);
+        CHECK(fabsf(ref[i] - 0.5f * x[i] * (1 + tanhf(u))) <= 1e-5f * (1 + fabsf(x[i])));
+    }
+}
+
+int main(void) {
+    uint64_t seed = 56;
+    test_exp_float();
+    test_exp_double();
+    test_softmax_float(&seed);
+    test_softmax_double(&seed);
+    test_relu();
+    test_map_overlap();
+    return test_done("test_math");
+}
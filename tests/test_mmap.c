@@ -0,0 +1,126 @@
+/*
+ * Memory-mapped array files (user-071): a round trip through
+ * simd_mmap_write and simd_mmap_open; rejection with EINVAL of files
+ * with a wrong magic, element type or element size and of files
+ * truncated inside the header or the payload, by both simd_mmap_open and
+ * simd_mmap_stream_open; and the stream reader over several windows of a
+ * payload that is not a whole number of pages, with and without
+ * SIMD_MMAP_DROP, where every chunk but the last must be a multiple of
+ * VLEN(T) and the chunks must add up to the file.
+ */
+#include "notasimdlib.h"
+#include "test.h"
+
+decl_simd_t(float)
+decl_simd_t(double)
+decl_simd_mmap_ops()
+
+/* Not a multiple of the page size in bytes, nor of VLEN(float). */
+#define N 5007
+
+static float x[N];
+
+/* simd_mmap_open as T and simd_mmap_stream_open must both fail with EINVAL. */
+#define CHECK_REJECTED(path, type, size) do { \
+    simd_mmap_t m; \
+    simd_mmap_stream_t s; \
+    errno = 0; \
+    CHECK(simd_mmap_open_raw(&m, path, type, size, 0) == NULL && errno == EINVAL); \
+    errno = 0; \
+    CHECK(simd_mmap_stream_open_raw(&s, path, type, size, 4096, 0) == -1 && errno == EINVAL); \
+} while (0)
+
+/* Overwrite len bytes at off of the file at path. */
+static void patch(const char *path, long off, const void *p, size_t len) {
+    FILE *f = fopen(path, "r+b");
+    CHECK(f != NULL);
+    if (!f) return;
+    CHECK(fseek(f, off, SEEK_SET) == 0 && fwrite(p, 1, len, f) == len);
+    fclose(f);
+}
+
+static void test_open(const char *path) {
+    simd_mmap_t m;
+    CHECK(simd_mmap_write(path, float, x, N) == 0);
+    const simd_t(float) *v = simd_mmap_open(&m, path, float, SIMD_MMAP_SEQUENTIAL);
+    CHECK(v != NULL);
+    if (!v) return;
+    CHECK(m.count == N && (uintptr_t)v % SIMD_FILE_ALIGN == 0);
+    CHECK(memcmp(v, x, sizeof(x)) == 0);
+    simd_mmap_close(&m);
+    CHECK(m.base == NULL && m.count == 0);
+}
+
+static void test_rejected(const char *path) {
+    CHECK(simd_mmap_write(path, float, x, N) == 0);
+    CHECK_REJECTED(path, "int32_t", sizeof(int32_t));  /* type, same size */
+    CHECK_REJECTED(path, "double", sizeof(double));    /* type and size */
+    CHECK_REJECTED(path, "float", sizeof(double));     /* size, same type */
+    patch(path, 0, "SIMDARX", 8);                      /* magic */
+    CHECK_REJECTED(path, "float", sizeof(float));
+    CHECK(simd_mmap_write(path, float, x, N) == 0);
+    uint32_t version = SIMD_FILE_VERSION + 1;
+    patch(path, offsetof(simd_file_header_t, version), &version, sizeof(version));
+    CHECK_REJECTED(path, "float", sizeof(float));
+
+    /* Truncated in the payload, right after the header, inside the header, empty. */
+    const off_t cuts[] = { SIMD_FILE_ALIGN + (N - 1) * sizeof(float), SIMD_FILE_ALIGN,
+                           sizeof(simd_file_header_t) - 1, 0 };
+    for (size_t i = 0; i < sizeof(cuts) / sizeof(cuts[0]); i++) {
+        CHECK(simd_mmap_write(path, float, x, N) == 0);
+        CHECK(truncate(path, cuts[i]) == 0);
+        CHECK_REJECTED(path, "float", sizeof(float));
+    }
+
+    /* A payload cut inside the padding still holds every element. */
+    CHECK(simd_mmap_write(path, float, x, N) == 0);
+    CHECK(truncate(path, SIMD_FILE_ALIGN + N * sizeof(float)) == 0);
+    simd_mmap_t m;
+    CHECK(simd_mmap_open(&m, path, float, 0) != NULL);
+    simd_mmap_close(&m);
+}
+
+/* Stream the file in windows of window bytes; the chunks must cover x in order. */
+static void check_stream(const char *path, size_t window, int flags) {
+    simd_mmap_stream_t s;
+    size_t seen = 0, len, chunks = 0;
+    const float *p;
+    CHECK(simd_mmap_stream_open(&s, path, float, window, flags) == 0);
+    while ((p = simd_mmap_stream_next(float, &s, &len)) != NULL) {
+        CHECK(len > 0 && seen + len <= N);
+        if (seen + len > N) break;
+        if (seen + len < N) CHECK(len % VLEN(float) == 0);
+        CHECK((uintptr_t)p % (XLEN / 8) == 0);
+        CHECK(memcmp(p, x + seen, len * sizeof(float)) == 0);
+        seen += len;
+        chunks++;
+    }
+    CHECK(seen == N && len == 0);
+    CHECK(simd_mmap_stream_next(float, &s, &len) == NULL && len == 0);
+    CHECK(chunks == (N * sizeof(float) + s.window - 1) / s.window);
+    simd_mmap_stream_close(&s);
+}
+
+static void test_stream(const char *path) {
+    CHECK(simd_mmap_write(path, float, x, N) == 0);
+    check_stream(path, 4096, 0);
+    check_stream(path, 10000, SIMD_MMAP_SEQUENTIAL | SIMD_MMAP_DROP);
+    check_stream(path, 1, 0);
+    check_stream(path, (size_t)1 << 20, SIMD_MMAP_WILLNEED);
+}
+
+int main(void) {
+    uint64_t seed = 71;
+    for (size_t i = 0; i < N; i++)
+        x[i] = (float)(int32_t)test_rand(&seed) * 0x1p-16f;
+    char path[] = "/tmp/test_mmap.XXXXXX";
+    int fd = mkstemp(path);
+    CHECK(fd >= 0);
+    if (fd < 0) return test_done("test_mmap");
+    close(fd);
+    test_open(path);
+    test_rejected(path);
+    test_stream(path);
+    unlink(path);
+    return test_done("test_mmap");
+}
@@ -0,0 +1,73 @@
+#!/bin/sh
+# Vectorizer check for the no-alias array kernels (user-068): compiles
+# decl_simd_array_ops, decl_simd_bitmap_ops and the elementwise
+# decl_simd_nn_ops and decl_simd_poly_ops kernels with GCC's vectorizer dump
+# and fails if any *_noalias function needed a runtime alias check
+# ("versioning for alias"), with the default block loop and with the
+# SIMD_OPENMP backend.
+#
+# The checked entry points must still need one, which shows the dump was
+# read at all.
+#
+# Run from tests/ (make -C tests does); honours CC, CFLAGS and XLEN.
+# -O3 is appended so the cost model lets the vectorizer version loops.
+# Needs GCC's -fdump-tree-vect-details; skipped with other compilers.
+
+CC=${CC:-cc}
+CFLAGS=${CFLAGS:--O2 -march=native}
+XLEN=${XLEN:-256}
+tmp=${TMPDIR:-/tmp}/test_noalias.$$
+trap 'rm -f "$tmp.c" "$tmp.s" "$tmp.vect"' EXIT
+
+if ! $CC --version 2>/dev/null | grep -qi 'gcc\|free software'; then
+    echo "test_noalias: skipped (needs GCC)"
+    exit 0
+fi
+
+{
+    echo '#include "notasimdlib.h"'
+    for T in float double int32_t uint8_t; do
+        echo "decl_simd_t($T)"
+        echo "decl_simd_array_ops($T)"
+    done
+    echo "decl_simd_t(uint64_t)"
+    echo "decl_simd_bitmap_ops(uint64_t)"
+    echo "decl_simd_nn_ops(float)"
+    echo "decl_simd_poly_ops(double)"
+} > "$tmp.c"
+
+fail=0
+for backend in "" "-DSIMD_OPENMP -fopenmp-simd"; do
+    # shellcheck disable=SC2086
+    $CC -std=gnu11 -S -I.. -DXLEN="$XLEN" $CFLAGS -O3 $backend \
+        -fdump-tree-vect-details="$tmp.vect" "$tmp.c" -o "$tmp.s" || exit 1
+    # Prints "<noalias functions> <checked functions versioned>", then
+    # every _noalias function that was versioned.
+    out=$(awk '
+        /^;; Function / { f = $3; if (f ~ /_noalias_/) n++ }
+        /versioning for alias/ {
+            if (f ~ /_noalias_/) bad[f] = 1
+            else chk[f] = 1
+        }
+        END {
+            for (f in chk) c++
+            print n + 0, c + 0
+            for (f in bad) print f
+        }' "$tmp.vect")
+    set -- $out
+    if [ "$1" -eq 0 ] || [ "$2" -eq 0 ]; then
+        echo "test_noalias: no kernels found in the vectorizer dump ($backend)" >&2
+        fail=1
+    fi
+    shift 2
+    for f in "$@"; do
+        echo "test_noalias: $f is versioned for alias ${backend:+($backend)}" >&2
+        fail=1
+    done
+done
+
+if [ "$fail" -ne 0 ]; then
+    echo "test_noalias: failed" >&2
+    exit 1
+fi
+echo "test_noalias: ok"
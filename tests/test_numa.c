@@ -0,0 +1,66 @@
+/*
+ * NUMA placement of simd_alloc_ex (user-073): a block allocated with
+ * SIMD_ALLOC_INTERLEAVE | SIMD_ALLOC_FIRST_TOUCH is aligned, zero filled
+ * and usable end to end whatever the machine offers, and
+ * simd_numa_mbind returns 1 (one node) or -1 (refused, or no syscall in
+ * this build); 0 only where /sys/devices/system/node/online lists more
+ * than one node.
+ */
+#include "notasimdlib.h"
+#include "test.h"
+
+decl_simd_t(float)
+decl_simd_array_ops(float)
+
+#define N 100003
+
+/* Number of online NUMA nodes from sysfs, or 1 if it cannot be read. */
+static int online_nodes(void) {
+    FILE *f = fopen("/sys/devices/system/node/online", "r");
+    int nodes = 0, lo, hi;
+    char sep;
+    if (!f) return 1;
+    while (fscanf(f, "%d", &lo) == 1) {
+        hi = lo;
+        if (fscanf(f, "%c", &sep) == 1 && sep == '-') {
+            if (fscanf(f, "%d", &hi) != 1) break;
+            if (fscanf(f, "%c", &sep) != 1) sep = 0;
+        }
+        nodes += hi - lo + 1;
+        if (sep != ',') break;
+    }
+    fclose(f);
+    return nodes > 0 ? nodes : 1;
+}
+
+int main(void) {
+    float *x = simd_alloc_ex(float, N, SIMD_ALLOC_INTERLEAVE | SIMD_ALLOC_FIRST_TOUCH);
+    CHECK(x != NULL);
+    if (!x) return test_done("test_numa");
+    CHECK((uintptr_t)x % SIMD_ALLOC_ALIGN == 0);
+    CHECK(simd_alloc_kind(x) == SIMD_ALLOC_KIND_PAGES);
+    size_t zero = 0;
+    for (size_t i = 0; i < N; i++) zero += x[i] == 0;
+    CHECK(zero == N);
+    for (size_t i = 0; i < N; i++) x[i] = (float)(i % 7);
+    float ref = 0;
+    for (size_t i = 0; i < N; i++) ref += (float)(i % 7);
+    CHECK(simd_array_sum(float, x, N) == ref);
+    simd_free(x);
+
+#if defined(__linux__)
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    void *p = mmap(NULL, 4 * page, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    CHECK(p != MAP_FAILED);
+    if (p != MAP_FAILED) {
+        errno = 0;
+        int r = simd_numa_mbind(p, 4 * page, 3 /* MPOL_INTERLEAVE */);
+        CHECK(r == 1 || r == -1 || (r == 0 && online_nodes() > 1));
+        CHECK(r != -1 || errno != 0);
+        memset(p, 1, 4 * page);
+        CHECK(((unsigned char *)p)[4 * page - 1] == 1);
+        munmap(p, 4 * page);
+    }
+#endif
+    return test_done("test_numa");
+}
@@ -0,0 +1,92 @@
+/*
+ * simd_polyval's Horner and Estrin evaluators against a scalar Horner
+ * loop for every degree up to 31, and the array forms over lengths that
+ * leave a partial final vector (user-058). The array forms also run with
+ * out shifted below and above x inside one buffer, and their _noalias
+ * forms on disjoint arrays, against the same results (user-068).
+ */
+#include "notasimdlib.h"
+#include "test.h"
+#include <math.h>
+
+decl_simd_t(double)
+decl_simd_poly_ops(double)
+
+#define MAX_DEGREE 31
+#define N 37
+
+static double scalar_poly(const double *c, int degree, double x) {
+    double r = c[degree];
+    for (int k = degree - 1; k >= 0; k--) r = r * x + c[k];
+    return r;
+}
+
+static int close_enough(double got, double ref, double scale) {
+    return fabs(got - ref) <= 1e-12 * scale;
+}
+
+/*
+ * polyval_array and lut_interp_array with x at buf + N and out at
+ * buf + N + shift for every shift up to two vectors either way, against
+ * ref computed on disjoint arrays.
+ */
+static void check_overlap(const double *c, const double *table, const double *x,
+                          const double *ref_poly, const double *ref_lut) {
+    const int span = 2 * (int)VLEN(double) + 1;
+    double buf[3 * N];
+    for (int shift = -span; shift <= span; shift++) {
+        memcpy(buf + N, x, N * sizeof(double));
+        simd_polyval_array(double, c, 5, buf + N, N, buf + N + shift);
+        CHECK(memcmp(buf + N + shift, ref_poly, N * sizeof(double)) == 0);
+        memcpy(buf + N, x, N * sizeof(double));
+        simd_lut_interp_array(double, table, 8, buf + N, N, buf + N + shift);
+        CHECK(memcmp(buf + N + shift, ref_lut, N * sizeof(double)) == 0);
+    }
+}
+
+int main(void) {
+    uint64_t seed = 58;
+    double c[MAX_DEGREE + 1], x[N], out[N];
+    for (int k = 0; k <= MAX_DEGREE; k++)
+        c[k] = (double)(test_rand(&seed) >> 11) / 9007199254740992.0 - 0.5;
+    for (int i = 0; i < N; i++)
+        x[i] = 2.0 * i / N - 1.0;
+
+    for (int degree = 0; degree <= MAX_DEGREE; degree++) {
+        double scale = 0;
+        for (int k = 0; k <= degree; k++) scale += fabs(c[k]);
+        simd_t(double) v = simd_load(double, x);
+        simd_t(double) h = simd_polyval_horner(double, c, degree, v);
+        simd_t(double) e = simd_polyval_estrin(double, c, degree, v);
+        simd_t(double) p = simd_polyval(double, c, degree, v);
+        for (int i = 0; i < (int)VLEN(double); i++) {
+            double ref = scalar_poly(c, degree, x[i]);
+            CHECK(close_enough(h.v[i], ref, scale));
+            CHECK(close_enough(e.v[i], ref, scale));
+            CHECK(close_enough(p.v[i], ref, scale));
+        }
+        for (int n = 0; n <= N; n += 5) {
+            out[n < N ? n : 0] = 12345.0;
+            simd_polyval_array(double, c, degree, x, (size_t)n, out);
+            for (int i = 0; i < n; i++)
+                CHECK(close_enough(out[i], scalar_poly(c, degree, x[i]), scale));
+            if (n < N) CHECK(out[n] == 12345.0);
+        }
+    }
+
+    double table[8], idx[N], ref_poly[N], ref_lut[N], na[N];
+    for (int k = 0; k < 8; k++)
+        table[k] = (double)(k * k) - 3.5;
+    for (int i = 0; i < N; i++)
+        idx[i] = 8.5 * i / N - 0.25;
+    simd_polyval_array(double, c, 5, idx, N, ref_poly);
+    simd_lut_interp_array(double, table, 8, idx, N, ref_lut);
+    simd_poly_noalias(double, polyval_array, c, 5, idx, N, na);
+    CHECK(memcmp(na, ref_poly, sizeof(na)) == 0);
+    simd_poly_noalias(double, lut_interp_array, table, 8, idx, N, na);
+    CHECK(memcmp(na, ref_lut, sizeof(na)) == 0);
+    for (int i = 0; i < N; i++)
+        CHECK(close_enough(ref_poly[i], scalar_poly(c, 5, idx[i]), 8));
+    check_overlap(c, table, idx, ref_poly, ref_lut);
+    return test_done("test_poly");
+}
@@ -0,0 +1,69 @@
+/*
+ * Filter / aggregate kernels (user-053) against a scalar reference, for
+ * narrow and wide lane types, including sums that overflow the column type.
+ */
+#include "notasimdlib.h"
+#include "test.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define QUERY_MAX 20000
+
+#define decl_query_test(T, lo, span) \
+    decl_simd_t(T) \
+    decl_simd_query_ops(T) \
+    static void test_query_##T(uint64_t *seed) { \
+        static T x[QUERY_MAX], y[QUERY_MAX], z[QUERY_MAX]; \
+        static uint64_t bm[QUERY_MAX / 64 + 1], bm2[QUERY_MAX / 64 + 1]; \
+        for (int it = 0; it < 100; it++) { \
+            size_t n = test_rand(seed) % QUERY_MAX; \
+            for (size_t i = 0; i < n; i++) { \
+                x[i] = (T)((lo) + (T)(test_rand(seed) % (span))); \
+                y[i] = (T)(test_rand(seed) % 100); \
+                z[i] = (T)(test_rand(seed) % (uint64_t)(it % 5 + 1)); \
+            } \
+            T c = (T)(test_rand(seed) % 100), k = (T)(test_rand(seed) % 3); \
+            simd_pred_t(T) p[2] = { { y, SIMD_CMP_GT, c }, { z, SIMD_CMP_EQ, k } }; \
+            simd_acc_of(T) sum = 0; \
+            T mn = 0, mx = 0; \
+            size_t cnt = 0; \
+            for (size_t i = 0; i < n; i++) { \
+                if (y[i] > c && z[i] == k) { \
+                    if (!cnt) mn = mx = x[i]; \
+                    sum += x[i]; \
+                    mn = x[i] < mn ? x[i] : mn; \
+                    mx = x[i] > mx ? x[i] : mx; \
+                    cnt++; \
+                } \
+            } \
+            simd_agg_t(T) r = simd_filter_aggregate(T, p, 2, x, n, bm); \
+            CHECK(r.count == cnt && r.sum == sum && r.min == mn && r.max == mx); \
+            CHECK(simd_filter(T, p, 2, n, bm2) == cnt); \
+            CHECK(memcmp(bm, bm2, (n + 63) / 64 * sizeof(uint64_t)) == 0); \
+            simd_agg_t(T) r2 = simd_aggregate(T, x, bm2, n); \
+            CHECK(r2.count == cnt && r2.sum == sum && r2.min == mn && r2.max == mx); \
+            simd_agg_t(T) r3 = simd_filter_aggregate(T, p, 2, x, n, NULL); \
+            CHECK(r3.count == cnt && r3.sum == sum); \
+        } \
+    }
+
+/* x spans the top of the range, so the sum wraps in T but not in the accumulator. */
+decl_query_test(int8_t, 100, 28)
+decl_query_test(int16_t, 30000, 2768)
+decl_query_test(int32_t, 2000000000, 147483648)
+decl_query_test(uint32_t, 4000000000u, 294967296u)
+decl_query_test(int64_t, -1000000, 2000000)
+decl_query_test(float, 1000000, 1000)   /* integral: exact in double */
+decl_query_test(double, -5000, 10000)
+
+int main(void) {
+    uint64_t seed = 53;
+    test_query_int8_t(&seed);
+    test_query_int16_t(&seed);
+    test_query_int32_t(&seed);
+    test_query_uint32_t(&seed);
+    test_query_int64_t(&seed);
+    test_query_float(&seed);
+    test_query_double(&seed);
+    return test_done("test_query");
+}
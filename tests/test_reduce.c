@@ -0,0 +1,105 @@
+/*
+ * Reductions and the function-backed simd_apply_* (user-067):
+ * simd_reduce_vec / simd_reduce_vec2 and simd_apply_sum/dot evaluate
+ * each vector argument exactly once, so nested calls do not recompute
+ * their inputs per lane. simd_reduce_func and simd_reduce_expr keep
+ * their macro semantics: any number and kind of extra arguments, which
+ * simd_reduce_expr does not evaluate. All results match a plain scalar
+ * loop.
+ */
+#include "notasimdlib.h"
+#include "test.h"
+
+decl_simd_t(float)
+decl_simd_t(int32_t)
+
+static int evals;
+
+/* Returns a, counting how often it is evaluated. */
+static simd_t(float) counted(simd_t(float) a) {
+    evals++;
+    return a;
+}
+
+static float dot_func(float accum, size_t i, simd_t(float) a, simd_t(float) b) {
+    return accum + a.v[i] * b.v[i];
+}
+
+static float sum_func(float accum, size_t i, simd_t(float) a) {
+    return accum + a.v[i];
+}
+
+/* An int lane index, as older callers write it, works with simd_reduce_func. */
+static float sum_func_int(float accum, int i, simd_t(float) a) {
+    return accum + a.v[i];
+}
+
+static int32_t mixed_func(int32_t accum, size_t i, const int32_t *p, simd_t(int32_t) a, int32_t k,
+                          int32_t s) {
+    return accum + p[i] * a.v[i] * k - s;
+}
+
+int main(void) {
+    simd_t(float) a, b;
+    float ref_dot = 0, ref_sum = 0;
+    for (size_t i = 0; i < VLEN(float); i++) {
+        a.v[i] = (float)i + 1;
+        b.v[i] = 2.0f - (float)i;
+        ref_dot += a.v[i] * b.v[i];
+        ref_sum += a.v[i];
+    }
+
+    evals = 0;
+    CHECK(simd_reduce_vec2(float, dot_func, counted(a), counted(b)) == ref_dot);
+    CHECK(evals == 2);
+
+    /* The inner call is an argument; it must run once, not once per lane. */
+    evals = 0;
+    CHECK(simd_reduce_vec(float, sum_func, simd_apply_mul(float, counted(a), counted(b))) == ref_dot);
+    CHECK(evals == 2);
+    evals = 0;
+    CHECK(simd_apply_sum(float, simd_apply_mul(float, counted(a), counted(b))) == ref_dot);
+    CHECK(simd_apply_dot(float, counted(a), counted(b)) == ref_dot);
+    CHECK(evals == 4);
+
+    /* A reduction nested in the argument of another. */
+    evals = 0;
+    float n = simd_reduce_vec(float, sum_func,
+                              simd_splat(float, simd_reduce_vec(float, sum_func, counted(a))));
+    CHECK(n == ref_sum * VLEN(float));
+    CHECK(evals == 1);
+
+    /* simd_reduce_func passes its arguments as written, on every lane. */
+    CHECK(simd_reduce_func(float, dot_func, a, b) == ref_dot);
+    CHECK(simd_reduce_func(float, sum_func_int, a) == ref_sum);
+    evals = 0;
+    CHECK(simd_reduce_func(float, sum_func, counted(a)) == ref_sum);
+    CHECK(evals == (int)VLEN(float));
+
+    /* Arrays, vectors and scalars mixed. */
+    int32_t p[VLEN(int32_t)], k = 3, ref = 0;
+    simd_t(int32_t) ia;
+    for (size_t i = 0; i < VLEN(int32_t); i++) {
+        p[i] = (int32_t)i - 5;
+        ia.v[i] = (int32_t)(2 * i + 1);
+        ref += p[i] * ia.v[i] * k - 1;
+    }
+    CHECK(simd_reduce_func(int32_t, mixed_func, p, ia, k, 1) == ref);
+
+    /*
+     * simd_reduce_expr: the extra arguments only name what expr reads,
+     * so they may be any expression, any number of them, and are not
+     * evaluated.
+     */
+    struct { simd_t(float) v; } s = { a };
+    simd_t(float) arr[2] = { a, b };
+    evals = 0;
+    CHECK(simd_reduce_expr(float, accum + a.v[i] * b.v[i], a, b) == ref_dot);
+    CHECK(simd_reduce_expr(float, accum + s.v.v[i], s.v) == ref_sum);
+    CHECK(simd_reduce_expr(float, accum + arr[0].v[i] * arr[1].v[i], arr[0], arr[1]) == ref_dot);
+    CHECK(simd_reduce_expr(int32_t, accum + p[i] * ia.v[i] * k - 1, p, ia, k, 1, 2, 3, 4, 5) == ref);
+    CHECK(simd_reduce_expr(float, accum + a.v[i], counted(a)) == ref_sum);
+    CHECK(evals == 0);
+
+    return test_done("test_reduce");
+}
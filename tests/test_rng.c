@@ -0,0 +1,193 @@
+/*
+ * The multi-stream xoshiro256++ generator (user-059): every stream
+ * against a scalar xoshiro256++, fills in uneven pieces against one
+ * large fill, and chi-square and moment checks of the raw bits and of
+ * the uniform, normal and integer-range distributions.
+ *
+ * Seeds are fixed, so each run is deterministic; the bounds are about
+ * five standard deviations of the statistic under a perfect generator.
+ */
+#include "notasimdlib.h"
+#include "test.h"
+#include <math.h>
+#include <stdlib.h>
+
+decl_simd_t(uint64_t)
+decl_simd_rng_ops()
+
+#define N (1u << 20)
+#define BINS 64
+
+static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+/* One reference xoshiro256++ step. */
+static uint64_t xoshiro_next(uint64_t s[4]) {
+    uint64_t out = rotl(s[0] + s[3], 23) + s[0];
+    uint64_t t = s[1] << 17;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotl(s[3], 45);
+    return out;
+}
+
+/* Upper bound for a chi-square statistic with df degrees of freedom. */
+static double chi2_bound(int df) { return df + 5 * sqrt(2.0 * df); }
+
+static void test_streams(void) {
+    enum { STEPS = 1000 };
+    uint64_t seed = 59, ref[SIMD_RNG_STREAMS][4];
+    for (int k = 0; k < 4; k++)
+        for (int j = 0; j < SIMD_RNG_STREAMS; j++)
+            ref[j][k] = test_rand(&seed);
+    simd_rng_t r;
+    simd_rng_seed(&r, 59);
+    static uint64_t got[STEPS * SIMD_RNG_STREAMS];
+    simd_rng_fill_u64(&r, got, STEPS * SIMD_RNG_STREAMS);
+    for (int i = 0; i < STEPS; i++)
+        for (int j = 0; j < SIMD_RNG_STREAMS; j++)
+            CHECK(got[i * SIMD_RNG_STREAMS + j] == xoshiro_next(ref[j]));
+
+    /* Register-sized and odd-sized draws continue the same sequence. */
+    simd_rng_seed(&r, 59);
+    uint64_t piece[7];
+    size_t i = 0;
+    while (i + VLEN(uint64_t) <= 300) {
+        simd_t(uint64_t) v = simd_rng_next(&r);
+        for (size_t k = 0; k < VLEN(uint64_t); k++) CHECK(v.v[k] == got[i + k]);
+        i += VLEN(uint64_t);
+        simd_rng_fill_u64(&r, piece, 7);
+        for (size_t k = 0; k < 7; k++) CHECK(piece[k] == got[i + k]);
+        i += 7;
+    }
+}
+
+static void test_bits(void) {
+    static uint64_t u[N];
+    simd_rng_t r;
+    simd_rng_seed(&r, 1);
+    simd_rng_fill_u64(&r, u, N);
+    for (int b = 0; b < 64; b++) {
+        size_t ones = 0;
+        for (size_t i = 0; i < N; i++) ones += (u[i] >> b) & 1;
+        CHECK(fabs((double)ones - N / 2.0) < 5 * sqrt(N / 4.0));
+    }
+}
+
+static void test_uniform(void) {
+    static double d[N];
+    static float f[N];
+    simd_rng_t r;
+    simd_rng_seed(&r, 2);
+    simd_rng_uniform(double, &r, d, N);
+    simd_rng_uniform(float, &r, f, N);
+
+    double counts[BINS] = { 0 }, fcounts[BINS] = { 0 };
+    double mean = 0, var = 0, fmean = 0;
+    for (size_t i = 0; i < N; i++) {
+        CHECK(d[i] >= 0 && d[i] < 1);
+        CHECK(f[i] >= 0 && f[i] < 1);
+        counts[(int)(d[i] * BINS)]++;
+        fcounts[(int)(f[i] * BINS)]++;
+        mean += d[i];
+        fmean += f[i];
+    }
+    mean /= N;
+    fmean /= N;
+    for (size_t i = 0; i < N; i++) var += (d[i] - mean) * (d[i] - mean);
+    var /= N - 1;
+    double sd = sqrt(1.0 / 12 / N);
+    CHECK(fabs(mean - 0.5) < 5 * sd);
+    CHECK(fabs(fmean - 0.5) < 5 * sd);
+    CHECK(fabs(var - 1.0 / 12) < 5 * sqrt(1.0 / 180 / N));
+
+    double chi = 0, fchi = 0, e = (double)N / BINS;
+    for (int b = 0; b < BINS; b++) {
+        chi += (counts[b] - e) * (counts[b] - e) / e;
+        fchi += (fcounts[b] - e) * (fcounts[b] - e) / e;
+    }
+    CHECK(chi < chi2_bound(BINS - 1));
+    CHECK(fchi < chi2_bound(BINS - 1));
+    printf("  uniform: mean %.5f var %.5f chi2 %.1f (float %.1f), df %d\n",
+           mean, var, chi, fchi, BINS - 1);
+}
+
+static void test_normal(void) {
+    static double z[N];
+    simd_rng_t r;
+    simd_rng_seed(&r, 3);
+    simd_rng_normal(double, &r, z, N, 0.0, 1.0);
+
+    double m1 = 0, m2 = 0, m3 = 0, m4 = 0;
+    for (size_t i = 0; i < N; i++) {
+        CHECK(isfinite(z[i]));
+        m1 += z[i];
+        m2 += z[i] * z[i];
+        m3 += z[i] * z[i] * z[i];
+        m4 += z[i] * z[i] * z[i] * z[i];
+    }
+    m1 /= N; m2 /= N; m3 /= N; m4 /= N;
+    CHECK(fabs(m1) < 5 * sqrt(1.0 / N));
+    CHECK(fabs(m2 - 1) < 5 * sqrt(2.0 / N));
+    CHECK(fabs(m3) < 5 * sqrt(15.0 / N));
+    CHECK(fabs(m4 - 3) < 5 * sqrt(96.0 / N));
+
+    /* Equal-width bins on [-4, 4] plus the two tails. */
+    double counts[BINS + 2] = { 0 }, chi = 0;
+    for (size_t i = 0; i < N; i++) {
+        int b = z[i] < -4 ? 0 : z[i] >= 4 ? BINS + 1 : 1 + (int)((z[i] + 4) * BINS / 8);
+        counts[b]++;
+    }
+    for (int b = 0; b < BINS + 2; b++) {
+        double lo = b == 0 ? -INFINITY : -4 + 8.0 * (b - 1) / BINS;
+        double hi = b == BINS + 1 ? INFINITY : -4 + 8.0 * b / BINS;
+        double e = N * 0.5 * (erf(hi / sqrt(2.0)) - erf(lo / sqrt(2.0)));
+        chi += (counts[b] - e) * (counts[b] - e) / e;
+    }
+    CHECK(chi < chi2_bound(BINS + 1));
+    printf("  normal: mean %.5f var %.5f skew %.5f kurt %.4f chi2 %.1f, df %d\n",
+           m1, m2, m3, m4, chi, BINS + 1);
+
+    /* mean and stddev shift and scale; odd lengths stop mid-group. */
+    static float f[1001];
+    simd_rng_seed(&r, 4);
+    simd_rng_normal(float, &r, f, 1001, 10.0f, 0.5f);
+    double fm = 0;
+    for (size_t i = 0; i < 1001; i++) fm += f[i];
+    CHECK(fabs(fm / 1001 - 10) < 5 * 0.5 / sqrt(1001.0));
+}
+
+static void test_range(void) {
+    enum { LO = 1000, SPAN = 37 };
+    static uint32_t v[N];
+    simd_rng_t r;
+    simd_rng_seed(&r, 5);
+    simd_rng_range_u32(&r, v, N, LO, LO + SPAN - 1);
+    double counts[SPAN] = { 0 }, chi = 0, e = (double)N / SPAN;
+    for (size_t i = 0; i < N; i++) {
+        CHECK(v[i] >= LO && v[i] < LO + SPAN);
+        if (v[i] >= LO && v[i] < LO + SPAN) counts[v[i] - LO]++;
+    }
+    for (int b = 0; b < SPAN; b++) chi += (counts[b] - e) * (counts[b] - e) / e;
+    CHECK(chi < chi2_bound(SPAN - 1));
+    printf("  range: chi2 %.1f, df %d\n", chi, SPAN - 1);
+
+    /* Degenerate and full 32-bit ranges. */
+    simd_rng_range_u32(&r, v, 100, 7, 7);
+    for (size_t i = 0; i < 100; i++) CHECK(v[i] == 7);
+    simd_rng_range_u32(&r, v, N, 0, UINT32_MAX);
+    size_t high = 0;
+    for (size_t i = 0; i < N; i++) high += v[i] >> 31;
+    CHECK(fabs((double)high - N / 2.0) < 5 * sqrt(N / 4.0));
+}
+
+int main(void) {
+    test_streams();
+    test_bits();
+    test_uniform();
+    test_normal();
+    test_range();
+    return test_done("test_rng");
+}
@@ -0,0 +1,177 @@
+/*
+ * Statistics kernels (user-057): mean_var, covariance, minmax and the
+ * streaming moments accumulator against a two-pass long double
+ * reference, for lengths that leave a partial final vector. Covers
+ * merging two partial accumulators against one pass over the whole
+ * data, samples of 1e9 plus small noise (where sum-of-squares formulas
+ * lose every digit), and the n = 0 and n = 1 edge cases.
+ */
+#include "notasimdlib.h"
+#include "test.h"
+#include <math.h>
+
+decl_simd_t(float)
+decl_simd_t(double)
+decl_simd_stats_ops(float)
+decl_simd_stats_ops(double)
+
+#define N 203
+
+/* Two-pass central moments of x[0..n): mean and sums of d^2, d^3, d^4. */
+static void ref_moments(const double *x, size_t n, long double *mean, long double m[3]) {
+    long double s = 0;
+    for (size_t i = 0; i < n; i++) s += x[i];
+    *mean = n ? s / n : 0;
+    m[0] = m[1] = m[2] = 0;
+    for (size_t i = 0; i < n; i++) {
+        long double d = x[i] - *mean;
+        m[0] += d * d;
+        m[1] += d * d * d;
+        m[2] += d * d * d * d;
+    }
+}
+
+static long double ref_cov(const double *x, const double *y, size_t n) {
+    long double sx = 0, sy = 0, c = 0;
+    for (size_t i = 0; i < n; i++) {
+        sx += x[i];
+        sy += y[i];
+    }
+    for (size_t i = 0; i < n; i++) c += (x[i] - sx / n) * (y[i] - sy / n);
+    return n ? c / n : 0;
+}
+
+/* |got - ref| within rel of scale. */
+static int near(long double got, long double ref, long double scale, double rel) {
+    return fabsl(got - ref) <= rel * scale;
+}
+
+int main(void) {
+    uint64_t seed = 57;
+    double x[N], y[N];
+    for (size_t i = 0; i < N; i++) {
+        x[i] = (double)(test_rand(&seed) >> 11) * 0x1p-53 * 10.0 - 3.0;
+        y[i] = 0.5 * x[i] + (double)(test_rand(&seed) >> 11) * 0x1p-53;
+    }
+
+    for (size_t n = 0; n <= N; n += n < 40 ? 1 : 23) {
+        long double mu, m[3];
+        ref_moments(x, n, &mu, m);
+        double mean, var, mn, mx;
+        simd_mean_var(double, x, n, &mean, &var);
+        CHECK(near(mean, mu, 1, 1e-14));
+        CHECK(near(var, n ? m[0] / n : 0, 1, 1e-13));
+        CHECK(near(simd_covariance(double, x, y, n), ref_cov(x, y, n), 1, 1e-13));
+        simd_minmax(double, x, n, &mn, &mx);
+        double rmn = INFINITY, rmx = -INFINITY;
+        for (size_t i = 0; i < n; i++) {
+            rmn = x[i] < rmn ? x[i] : rmn;
+            rmx = x[i] > rmx ? x[i] : rmx;
+        }
+        CHECK(mn == rmn && mx == rmx);
+
+        /* One pass over x[0..n) against two partial pushes merged. */
+        simd_moments_t(double) all, lo, hi;
+        simd_moments_init(double, &all);
+        simd_moments_push(double, &all, x, n);
+        CHECK(all.n == n);
+        CHECK(near(all.mean, mu, 1, 1e-14));
+        CHECK(near(all.m2, m[0], m[0] + 1, 1e-12));
+        CHECK(near(all.m3, m[1], m[0] * 4 + 1, 1e-12));
+        CHECK(near(all.m4, m[2], m[2] + 1, 1e-12));
+        CHECK(all.min == rmn && all.max == rmx);
+        for (size_t cut = 0; cut <= n; cut += 1 + n / 5) {
+            simd_moments_init(double, &lo);
+            simd_moments_init(double, &hi);
+            simd_moments_push(double, &lo, x, cut);
+            simd_moments_push(double, &hi, x + cut, n - cut);
+            simd_moments_merge(double, &lo, &hi);
+            CHECK(lo.n == n);
+            CHECK(near(lo.mean, all.mean, 1, 1e-14));
+            CHECK(near(lo.m2, all.m2, all.m2 + 1, 1e-12));
+            CHECK(near(lo.m3, all.m3, all.m2 * 4 + 1, 1e-12));
+            CHECK(near(lo.m4, all.m4, all.m4 + 1, 1e-12));
+            CHECK(lo.min == all.min && lo.max == all.max);
+        }
+        if (n > 2) {
+            double skew = (double)(sqrtl(n) * m[1] / powl(m[0], 1.5L));
+            double kurt = (double)(n * m[2] / (m[0] * m[0]) - 3);
+            CHECK(fabs(simd_moments_skewness(all) - skew) <= 1e-10);
+            CHECK(fabs(simd_moments_kurtosis(all) - kurt) <= 1e-10);
+        }
+    }
+
+    /* 1e9 plus noise of about 1: the variance keeps its leading digits. */
+    double big[N];
+    for (size_t i = 0; i < N; i++)
+        big[i] = 1e9 + (double)(test_rand(&seed) >> 11) * 0x1p-53 * 4.0;
+    {
+        long double mu, m[3];
+        ref_moments(big, N, &mu, m);
+        double mean, var;
+        simd_mean_var(double, big, N, &mean, &var);
+        CHECK(near(mean, mu, 1e9, 1e-15));
+        CHECK(near(var, m[0] / N, m[0] / N, 1e-6));
+        simd_moments_t(double) acc;
+        simd_moments_init(double, &acc);
+        simd_moments_push(double, &acc, big, 100);
+        simd_moments_push(double, &acc, big + 100, N - 100);
+        CHECK(near(simd_moments_var(acc), m[0] / N, m[0] / N, 1e-6));
+        CHECK(near(simd_covariance(double, big, big, N), m[0] / N, m[0] / N, 1e-6));
+    }
+
+    /* float: the same data rounded, against the double kernels. */
+    float xf[N], yf[N];
+    for (size_t i = 0; i < N; i++) {
+        xf[i] = (float)x[i];
+        yf[i] = (float)y[i];
+    }
+    {
+        float mean, var, mn, mx;
+        double dmean, dvar;
+        simd_mean_var(float, xf, N, &mean, &var);
+        for (size_t i = 0; i < N; i++) x[i] = xf[i], y[i] = yf[i];
+        simd_mean_var(double, x, N, &dmean, &dvar);
+        CHECK(fabs(mean - dmean) <= 1e-5);
+        CHECK(fabs(var - dvar) <= 1e-5 * dvar);
+        CHECK(fabs(simd_covariance(float, xf, yf, N) - (float)ref_cov(x, y, N)) <= 1e-5);
+        simd_minmax(float, xf, N, &mn, &mx);
+        float rmn = xf[0], rmx = xf[0];
+        for (size_t i = 1; i < N; i++) {
+            rmn = xf[i] < rmn ? xf[i] : rmn;
+            rmx = xf[i] > rmx ? xf[i] : rmx;
+        }
+        CHECK(mn == rmn && mx == rmx);
+    }
+
+    /* n = 0 and n = 1. */
+    {
+        double one = 42.5, mean = -1, var = -1, mn, mx;
+        simd_mean_var(double, &one, 0, &mean, &var);
+        CHECK(mean == 0 && var == 0);
+        CHECK(simd_covariance(double, &one, &one, 0) == 0);
+        simd_minmax(double, &one, 0, &mn, &mx);
+        CHECK(mn == INFINITY && mx == -INFINITY);
+        simd_mean_var(double, &one, 1, &mean, &var);
+        CHECK(mean == 42.5 && var == 0);
+        CHECK(simd_covariance(double, &one, &one, 1) == 0);
+        simd_minmax(double, &one, 1, &mn, &mx);
+        CHECK(mn == 42.5 && mx == 42.5);
+
+        simd_moments_t(double) m, e;
+        simd_moments_init(double, &m);
+        simd_moments_init(double, &e);
+        simd_moments_push(double, &m, &one, 0);
+        CHECK(m.n == 0 && simd_moments_var(m) == 0);
+        simd_moments_merge(double, &m, &e);
+        CHECK(m.n == 0);
+        simd_moments_push(double, &m, &one, 1);
+        CHECK(m.n == 1 && m.mean == 42.5 && m.m2 == 0 && m.min == 42.5 && m.max == 42.5);
+        CHECK(simd_moments_var(m) == 0 && simd_moments_skewness(m) == 0);
+        simd_moments_merge(double, &m, &e);
+        CHECK(m.n == 1 && m.mean == 42.5);
+        simd_moments_merge(double, &e, &m);
+        CHECK(e.n == 1 && e.mean == 42.5 && e.min == 42.5);
+    }
+    return test_done("test_stats");
+}
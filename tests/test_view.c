@@ -0,0 +1,212 @@
+/*
+ * Strided and 2-D views (user-075) against a scalar walk of the same
+ * views: gather/scatter over 1-D strided views, which must leave the
+ * gaps between elements untouched; row and column sub-views of a
+ * row-major matrix; transposed views of non-square blocks whose sides
+ * are not multiples of VLEN(T), through view_copy, the elementwise
+ * kernels and view_sum; negative strides and pitches; zero strides
+ * broadcasting one element; and EINVAL on a shape mismatch. Values are
+ * small integers, so every float result is exact.
+ */
+#include "notasimdlib.h"
+#include "test.h"
+
+decl_simd_t(float)
+decl_simd_array_ops(float)
+decl_simd_view_ops(float)
+
+/* Rows and columns of the test matrix: neither a multiple of any VLEN(float). */
+#define R 13
+#define C 29
+#define N 1000
+
+static float m[R * C], ref[R * C], x[N], y[N], z[N], yref[N];
+
+/* Element (r, i) of view v. */
+static float *at(simd_view_t(float) v, size_t r, size_t i) {
+    return v.base + (ptrdiff_t)r * v.pitch + (ptrdiff_t)i * v.stride;
+}
+
+static void fill(float *p, size_t n, uint64_t *seed) {
+    for (size_t i = 0; i < n; i++) p[i] = (float)(int)(test_rand(seed) % 17) - 8.0f;
+}
+
+/* Strided 1-D views: dst, a and b with different strides, lengths not a multiple of VLEN. */
+static void test_strided(uint64_t *seed) {
+    for (size_t n = 1; n <= 3 * 64 + 5; n += 7) {
+        fill(x, N, seed);
+        fill(z, N, seed);
+        fill(y, N, seed);
+        memcpy(yref, y, sizeof(y));
+        simd_view_t(float) d = simd_view(float, y + 1, n, 2);
+        simd_view_t(float) rd = simd_view(float, yref + 1, n, 2);
+        simd_view_t(float) a = simd_view(float, x, n, 3);
+        simd_view_t(float) b = simd_view(float, z + 2, n, 1);
+        for (size_t i = 0; i < n; i++) *at(rd, 0, i) = *at(a, 0, i) - *at(b, 0, i);
+        CHECK(simd_view_sub(float, d, a, b) == 0);
+        CHECK(memcmp(y, yref, sizeof(y)) == 0);
+
+        float s = 0;
+        for (size_t i = 0; i < n; i++) s += *at(a, 0, i);
+        CHECK(simd_view_sum(float, a) == s);
+
+        /* In place, dst identical to an input. */
+        for (size_t i = 0; i < n; i++) *at(rd, 0, i) *= 3.0f;
+        CHECK(simd_view_mul_scalar(float, d, d, 3.0f) == 0);
+        CHECK(memcmp(y, yref, sizeof(y)) == 0);
+    }
+}
+
+/* Row blocks and single columns of the R x C matrix. */
+static void test_2d(uint64_t *seed) {
+    fill(m, R * C, seed);
+    memcpy(ref, m, sizeof(m));
+    simd_view_t(float) blk = simd_view_2d(float, m + 2 * C + 3, 9, 20, C);
+    simd_view_t(float) rblk = simd_view_2d(float, ref + 2 * C + 3, 9, 20, C);
+    for (size_t r = 0; r < 9; r++)
+        for (size_t i = 0; i < 20; i++) *at(rblk, r, i) = *at(rblk, r, i) * 2.0f + 1.0f;
+    CHECK(simd_view_mul_scalar(float, blk, blk, 2.0f) == 0);
+    CHECK(simd_view_add_scalar(float, blk, blk, 1.0f) == 0);
+    CHECK(memcmp(m, ref, sizeof(m)) == 0);
+
+    /* Two overlapping blocks shifted by a row: dst = max(block, block one row down). */
+    simd_view_t(float) top = simd_view_2d(float, m, R - 1, C, C);
+    simd_view_t(float) below = simd_view_2d(float, m + C, R - 1, C, C);
+    for (size_t r = 0; r < R - 1; r++)
+        for (size_t i = 0; i < C; i++) {
+            float a = ref[r * C + i], b = ref[(r + 1) * C + i];
+            ref[r * C + i] = a > b ? a : b;
+        }
+    CHECK(simd_view_max(float, top, top, below) == 0);
+    CHECK(memcmp(m, ref, sizeof(m)) == 0);
+
+    for (size_t col = 0; col < C; col += 5) {
+        simd_view_t(float) c = simd_view_col(float, m, R, C, col);
+        float s = 0;
+        for (size_t r = 0; r < R; r++) {
+            s += ref[r * C + col];
+            ref[r * C + col] -= (float)col;
+        }
+        CHECK(simd_view_sum(float, c) == s);
+        CHECK(simd_view_sub_scalar(float, c, c, (float)col) == 0);
+        CHECK(memcmp(m, ref, sizeof(m)) == 0);
+    }
+}
+
+/* Transposes of non-square blocks whose sides are not multiples of VLEN. */
+static void test_transpose(uint64_t *seed) {
+    static const size_t shapes[][2] = { { 7, 19 }, { 11, 5 }, { 1, 29 }, { 13, 1 }, { 13, 29 } };
+    for (size_t k = 0; k < sizeof(shapes) / sizeof(shapes[0]); k++) {
+        size_t rows = shapes[k][0], cols = shapes[k][1];
+        fill(m, R * C, seed);
+        fill(x, N, seed);
+        simd_view_t(float) blk = simd_view_2d(float, m + (R - rows) * C + (C - cols), rows, cols, C);
+        simd_view_t(float) t = simd_view_transpose(float, blk);
+        CHECK(t.rows == cols && t.len == rows);
+
+        /* Pack the transpose: x holds the cols x rows matrix blk^T. */
+        simd_view_t(float) packed = simd_view_2d(float, x, cols, rows, rows);
+        CHECK(simd_view_copy(float, packed, t) == 0);
+        size_t bad = 0;
+        for (size_t r = 0; r < rows; r++)
+            for (size_t i = 0; i < cols; i++) bad += x[i * rows + r] != *at(blk, r, i);
+        CHECK(bad == 0);
+
+        /* A transposed dst with a packed input, then all three views transposed. */
+        memcpy(ref, m, sizeof(m));
+        simd_view_t(float) rt =
+            simd_view_transpose(float, simd_view_2d(float, ref + (blk.base - m), rows, cols, C));
+        for (size_t r = 0; r < cols; r++)
+            for (size_t i = 0; i < rows; i++) *at(rt, r, i) = *at(rt, r, i) + *at(rt, r, i) * x[r * rows + i];
+        simd_view_t(float) tmp = simd_view_2d(float, z, cols, rows, rows);
+        CHECK(simd_view_mul(float, tmp, t, packed) == 0);
+        CHECK(simd_view_add(float, t, t, tmp) == 0);
+        CHECK(memcmp(m, ref, sizeof(m)) == 0);
+        for (size_t r = 0; r < cols; r++)
+            for (size_t i = 0; i < rows; i++) *at(rt, r, i) *= 2.0f;
+        CHECK(simd_view_add(float, t, t, t) == 0);
+        CHECK(memcmp(m, ref, sizeof(m)) == 0);
+
+        float s = 0;
+        for (size_t r = 0; r < rows; r++)
+            for (size_t i = 0; i < cols; i++) s += *at(blk, r, i);
+        CHECK(simd_view_sum(float, t) == s);
+
+        /* Unpack: the transpose of the packed matrix back into the block. */
+        fill(x, N, seed);
+        CHECK(simd_view_copy(float, blk, simd_view_transpose(float, packed)) == 0);
+        bad = 0;
+        for (size_t r = 0; r < rows; r++)
+            for (size_t i = 0; i < cols; i++) bad += *at(blk, r, i) != x[i * rows + r];
+        CHECK(bad == 0);
+    }
+}
+
+/* Negative strides and pitches, and zero strides that repeat one element. */
+static void test_negative_zero(uint64_t *seed) {
+    const size_t n = 3 * 64 + 3;
+    fill(x, N, seed);
+    fill(y, N, seed);
+    CHECK(simd_view_copy(float, simd_view(float, y + n - 1, n, -1), simd_view(float, x, n, 1)) == 0);
+    size_t bad = 0;
+    for (size_t i = 0; i < n; i++) bad += y[n - 1 - i] != x[i];
+    CHECK(bad == 0);
+
+    /* Every other element, walked backwards, minus the elements in between. */
+    memcpy(yref, y, sizeof(y));
+    simd_view_t(float) even = simd_view(float, x + 2 * (n - 1), n, -2);
+    simd_view_t(float) odd = simd_view(float, x + 2 * (n - 1) + 1, n, -2);
+    for (size_t i = 0; i < n; i++) yref[i] = x[2 * (n - 1 - i)] - x[2 * (n - 1 - i) + 1];
+    CHECK(simd_view_sub(float, simd_view(float, y, n, 1), even, odd) == 0);
+    CHECK(memcmp(y, yref, sizeof(y)) == 0);
+
+    /* Rows flipped: negative pitch. */
+    fill(m, R * C, seed);
+    memcpy(ref, m, sizeof(m));
+    simd_view_t(float) up = simd_view_2d(float, m + (R - 1) * C, R, C, -(ptrdiff_t)C);
+    CHECK(simd_view_copy(float, simd_view_2d(float, z, R, C, C), up) == 0);
+    bad = 0;
+    for (size_t r = 0; r < R; r++)
+        for (size_t i = 0; i < C; i++) bad += z[r * C + i] != ref[(R - 1 - r) * C + i];
+    CHECK(bad == 0);
+
+    /* Zero stride broadcasts one element along a row; zero pitch repeats a row. */
+    float c = 5.0f;
+    simd_view_t(float) bc = simd_op_name(float,view) (&c, C, 0, R, 0);
+    simd_view_t(float) row = simd_op_name(float,view) (x, C, 1, R, 0);
+    simd_view_t(float) all = simd_view_2d(float, m, R, C, C);
+    CHECK(simd_view_sum(float, bc) == 5.0f * R * C);
+    CHECK(simd_view_add(float, all, row, bc) == 0);
+    bad = 0;
+    for (size_t r = 0; r < R; r++)
+        for (size_t i = 0; i < C; i++) bad += m[r * C + i] != x[i] + 5.0f;
+    CHECK(bad == 0);
+    CHECK(c == 5.0f);
+    CHECK(simd_view_min_scalar(float, simd_view(float, y, n, 1), simd_view(float, &c, n, 0), 2.0f) == 0);
+    bad = 0;
+    for (size_t i = 0; i < n; i++) bad += y[i] != 2.0f;
+    CHECK(bad == 0);
+}
+
+static void test_shape_mismatch(void) {
+    simd_view_t(float) a = simd_view_2d(float, m, 3, 4, C);
+    simd_view_t(float) b = simd_view_2d(float, m, 4, 3, C);
+    memcpy(ref, m, sizeof(m));
+    errno = 0;
+    CHECK(simd_view_add(float, a, a, b) == -1 && errno == EINVAL);
+    errno = 0;
+    CHECK(simd_view_copy(float, a, b) == -1 && errno == EINVAL);
+    errno = 0;
+    CHECK(simd_view_div_scalar(float, a, simd_view(float, x, 12, 1), 2.0f) == -1 && errno == EINVAL);
+    CHECK(memcmp(m, ref, sizeof(m)) == 0);
+}
+
+int main(void) {
+    uint64_t seed = 75;
+    test_strided(&seed);
+    test_2d(&seed);
+    test_transpose(&seed);
+    test_negative_zero(&seed);
+    test_shape_mismatch();
+    return test_done("test_view");
+}